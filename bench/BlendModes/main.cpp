@@ -0,0 +1,76 @@
+// Microbenchmark for blending with a runtime BlendMode versus a compile-time StaticBlendMode.
+#include <Graphics/BlendMode.hpp>
+#include <Graphics/StaticBlendMode.hpp>
+#include <Graphics/Timer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Graphics;
+
+constexpr size_t NumPixels     = 1u << 20;
+constexpr int    NumIterations = 20;
+
+// Run the function several times and return the fastest time (in nanoseconds per pixel).
+template<typename Func>
+double measure( Func&& func )
+{
+    Timer  timer;
+    double best = std::numeric_limits<double>::max();
+
+    for ( int i = 0; i < NumIterations; ++i )
+    {
+        timer.tick();
+        func();
+        timer.tick();
+
+        best = std::min( best, timer.elapsedMicroseconds() * 1000.0 / static_cast<double>( NumPixels ) );
+    }
+
+    return best;
+}
+
+int main()
+{
+    std::mt19937                            rng { 1337 };
+    std::uniform_int_distribution<uint32_t> dist;
+
+    std::vector<Color> src( NumPixels );
+    std::vector<Color> dst( NumPixels );
+
+    for ( auto& c: src )
+        c = Color { dist( rng ) };
+
+    const std::pair<const char*, const BlendMode*> blendModes[] = {
+        { "Disable", &BlendMode::Disable },
+        { "AlphaBlend", &BlendMode::AlphaBlend },
+        { "AdditiveBlend", &BlendMode::AdditiveBlend },
+        { "SubtractiveBlend", &BlendMode::SubtractiveBlend },
+    };
+
+    std::printf( "%-18s %14s %14s %10s\n", "Blend mode", "Generic ns/px", "Static ns/px", "Speedup" );
+
+    for ( const auto& [name, blendMode]: blendModes )
+    {
+        // The generic path resolves the blend factors and operations for every pixel.
+        const double generic = measure( [&] {
+            for ( size_t i = 0; i < NumPixels; ++i )
+                dst[i] = blendMode->Blend( src[i], dst[i] );
+        } );
+
+        // The static path resolves the blend mode once.
+        const double specialized = measure( [&] {
+            dispatchBlendMode( *blendMode, [&]( const auto blend ) {
+                for ( size_t i = 0; i < NumPixels; ++i )
+                    dst[i] = blend.Blend( src[i], dst[i] );
+            } );
+        } );
+
+        std::printf( "%-18s %14.3f %14.3f %9.2fx\n", name, generic, specialized, generic / specialized );
+    }
+
+    return 0;
+}
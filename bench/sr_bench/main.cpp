@@ -0,0 +1,648 @@
+// Benchmark suite for the Image draw primitives.
+// Every primitive is measured for each combination of resolution, blend mode, thread count,
+// and primitive size. The results are written as JSON so they can be compared between releases.
+// The 3D triangles are measured with every pixel passing the depth test (triangle_3d), and with every triangle
+// behind the depth buffer (triangle_3d_occluded), which measures the rejection by the hierarchical depth buffer.
+// The indexed mesh (mesh_indexed) is a grid of 8x8 pixel cells (two triangles each) that is drawn with a single call.
+// The rotated textured primitives are also measured with the texture in the tiled texture layout (the *_tiled primitives).
+// Use a texture that doesn't fit in the cache (--texture-size) to compare the layouts.
+//
+// Usage: sr_bench [options]
+//   --out <file>                 Write the JSON results to a file (default: standard output).
+//   --quick                      Run a reduced sweep (for smoke testing).
+//   --min-time <seconds>         Minimum measuring time per case (default: 0.1).
+//   --filter <name>[,<name>...]  Only run primitives whose name contains one of the given strings.
+//   --resolutions <WxH>[,...]    Resolutions to sweep (default: 640x480,1280x720,1920x1080).
+//   --threads <n>[,...]          Thread pool sizes to sweep (default: 1, 2, 4, ... up to the number of cores).
+//   --sizes <n>[,...]            Primitive sizes in pixels to sweep (default: 8,32,128,512).
+//   --texture-size <n>           The width and height of the texture (default: the largest size, at least 512).
+//   --deferred                   Also measure the deferred (tile-binned) mode of the image.
+#include <Graphics/DepthBuffer.hpp>
+#include <Graphics/Font.hpp>
+#include <Graphics/Image.hpp>
+#include <Graphics/Sprite.hpp>
+#include <Graphics/SpriteBatch.hpp>
+#include <Graphics/ThreadPool.hpp>
+#include <Graphics/Timer.hpp>
+
+#include <Math/Transform2D.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Graphics;
+
+constexpr float InvSqrt2 = 0.70710678f;
+
+struct Resolution
+{
+    int width;
+    int height;
+};
+
+struct Options
+{
+    std::string              outFile;
+    double                   minTime = 0.1;
+    std::vector<std::string> filters;
+    std::vector<Resolution>  resolutions { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+    std::vector<int>         threads;
+    std::vector<int>         sizes { 8, 32, 128, 512 };
+    int                      textureSize = 0;
+    bool                     deferred    = false;
+};
+
+// Shared resources used by the primitives.
+struct Resources
+{
+    std::shared_ptr<Image> texture;
+    std::shared_ptr<Image> tiledTexture;  ///< The same texture in the tiled texture layout.
+    std::map<int, Image>   images;        ///< An image for each primitive size.
+    DepthBuffer            depthBuffer;
+    std::vector<Vertex>    meshVertices;  ///< A grid mesh (for the current primitive size).
+    std::vector<uint32_t>  meshIndices;
+    int                    meshSize = 0;
+    Sprite                 sprite;
+    SpriteBatch            batch;
+    std::string            text = "The quick brown fox jumps over the lazy dog.";
+};
+
+struct Primitive
+{
+    const char* name;
+    // Whether the primitive uses a blend mode (and the blend modes should be swept).
+    bool blended;
+    // Whether the primitive has a size (and the sizes should be swept).
+    bool sized;
+    // The (estimated) number of pixels that are written by a single call.
+    std::function<double( const Image& image, const Resources& res, int size )> pixels;
+    // Draw the i-th primitive.
+    std::function<void( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode )> draw;
+    // (optional) Finish drawing the primitives of a batch.
+    std::function<void( Image& image, Resources& res )> finish = nullptr;
+};
+
+struct Result
+{
+    double calls;
+    double seconds;
+    double nsPerCallMedian;
+    double nsPerCallP99;
+};
+
+// A cheap hash to generate pseudo-random (but reproducible) primitive positions.
+static uint32_t hash( uint32_t x ) noexcept
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Position a primitive with the given size on the image, so that it is fully on-screen.
+static glm::vec2 position( const Image& image, uint32_t i, int size ) noexcept
+{
+    const uint32_t w = std::max( static_cast<int>( image.getWidth() ) - size, 1 );
+    const uint32_t h = std::max( static_cast<int>( image.getHeight() ) - size, 1 );
+
+    return { static_cast<float>( hash( i * 2 ) % w ), static_cast<float>( hash( i * 2 + 1 ) % h ) };
+}
+
+// The 4 corners of a square that is rotated around its center.
+static void rotatedSquare( const glm::vec2& p, int size, uint32_t i, glm::vec2 ( &corners )[4] ) noexcept
+{
+    const float     angle  = static_cast<float>( i % 360 ) * std::numbers::pi_v<float> / 180.0f;
+    const float     r      = static_cast<float>( size ) * 0.5f;
+    const glm::vec2 center = p + glm::vec2 { r };
+    // Scale down, so the rotated square fits inside the (unrotated) square.
+    const glm::vec2 u = glm::vec2 { std::cos( angle ), std::sin( angle ) } * r * InvSqrt2;
+    const glm::vec2 v = { -u.y, u.x };
+
+    corners[0] = center - u - v;
+    corners[1] = center + u - v;
+    corners[2] = center + u + v;
+    corners[3] = center - u + v;
+}
+
+// Convert a pixel position to a vertex in clip space. The position is multiplied by w, which doesn't move the vertex,
+// but vertices with different w have perspective-correct attributes.
+static ClipVertex clipVertex( const Image& image, const glm::vec2& p, float depth, float w, const glm::vec2& texCoord ) noexcept
+{
+    const float x = ( p.x + 0.5f ) / static_cast<float>( image.getWidth() ) * 2.0f - 1.0f;
+    const float y = 1.0f - ( p.y + 0.5f ) / static_cast<float>( image.getHeight() ) * 2.0f;
+
+    return ClipVertex { glm::vec4 { x, y, depth * 2.0f - 1.0f, 1.0f } * w, texCoord };
+}
+
+// Make sure the depth buffer has the size of the image.
+static bool resizeDepthBuffer( Image& image, Resources& res )
+{
+    if ( res.depthBuffer.getWidth() == image.getWidth() && res.depthBuffer.getHeight() == image.getHeight() )
+        return false;
+
+    // The recorded triangles use the depth buffer.
+    image.flush();
+    res.depthBuffer.resize( image.getWidth(), image.getHeight() );
+    return true;
+}
+
+// Create a grid of cells of 8x8 pixels that covers a square of the given size (centered at the origin).
+static void createMesh( Resources& res, int size )
+{
+    if ( res.meshSize == size )
+        return;
+
+    const int   cells = std::max( size / 8, 1 );
+    const float s     = static_cast<float>( size );
+    const float uv    = s / static_cast<float>( res.texture->getWidth() );
+
+    res.meshVertices.clear();
+    res.meshIndices.clear();
+    res.meshSize = size;
+
+    for ( int y = 0; y <= cells; ++y )
+    {
+        for ( int x = 0; x <= cells; ++x )
+        {
+            const glm::vec2 t = glm::vec2 { static_cast<float>( x ), static_cast<float>( y ) } / static_cast<float>( cells );
+            res.meshVertices.emplace_back( ( t - 0.5f ) * s, t * uv );
+        }
+    }
+
+    for ( int y = 0; y < cells; ++y )
+    {
+        for ( int x = 0; x < cells; ++x )
+        {
+            const uint32_t i = static_cast<uint32_t>( y * ( cells + 1 ) + x );
+            const uint32_t j = i + static_cast<uint32_t>( cells + 1 );
+            res.meshIndices.insert( res.meshIndices.end(), { i, i + 1, j + 1, i, j + 1, j } );
+        }
+    }
+}
+
+static double squareArea( const Image&, const Resources&, int size )
+{
+    return static_cast<double>( size ) * size;
+}
+
+static double rotatedSquareArea( const Image&, const Resources&, int size )
+{
+    return static_cast<double>( size ) * size * 0.5;
+}
+
+static std::vector<Primitive> createPrimitives()
+{
+    const Color color { 255, 128, 64, 192 };
+
+    return {
+        { "clear", false, false,
+          []( const Image& image, const Resources&, int ) { return static_cast<double>( image.getWidth() ) * image.getHeight(); },
+          []( Image& image, Resources&, uint32_t i, int, const BlendMode& ) {
+              image.clear( Color { hash( i ) } );
+          } },
+        { "copy_rect", true, true, squareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              const glm::vec2 p = position( image, i, size );
+              image.copy( *res.texture, Math::RectI { 0, 0, size, size }, Math::RectI { static_cast<int>( p.x ), static_cast<int>( p.y ), size, size }, blendMode );
+          } },
+        { "copy_rect_scaled", true, true, squareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              const glm::vec2 p = position( image, i, size );
+              // Scale a region of half the size up to the destination rectangle.
+              image.copy( *res.texture, Math::RectI { 0, 0, std::max( size / 2, 1 ), std::max( size / 2, 1 ) }, Math::RectI { static_cast<int>( p.x ), static_cast<int>( p.y ), size, size }, blendMode );
+          } },
+        { "copy_xy", false, true, squareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& ) {
+              const glm::vec2 p = position( image, i, size );
+              image.copy( res.images.at( size ), static_cast<int>( p.x ), static_cast<int>( p.y ) );
+          } },
+        { "line", true, true,
+          []( const Image&, const Resources&, int size ) { return static_cast<double>( size ); },
+          [=]( Image& image, Resources&, uint32_t i, int size, const BlendMode& blendMode ) {
+              // The diagonal of the rotated square is a line of the given size in any direction.
+              glm::vec2 c[4];
+              rotatedSquare( position( image, i, size ), size, i, c );
+              image.drawLine( c[0], c[2], color, blendMode );
+          } },
+        { "triangle", true, true,
+          []( const Image&, const Resources&, int size ) { return static_cast<double>( size ) * size * 0.5; },
+          [=]( Image& image, Resources&, uint32_t i, int size, const BlendMode& blendMode ) {
+              const glm::vec2 p = position( image, i, size );
+              const float     s = static_cast<float>( size );
+              image.drawTriangle( p, p + glm::vec2 { s, 0 }, p + glm::vec2 { 0, s }, color, blendMode );
+          } },
+        { "quad_solid", true, true, rotatedSquareArea,
+          [=]( Image& image, Resources&, uint32_t i, int size, const BlendMode& blendMode ) {
+              glm::vec2 c[4];
+              rotatedSquare( position( image, i, size ), size, i, c );
+              image.drawQuad( c[0], c[1], c[2], c[3], color, blendMode );
+          } },
+        { "quad_textured", true, true, rotatedSquareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              glm::vec2 c[4];
+              rotatedSquare( position( image, i, size ), size, i, c );
+              const float uv = static_cast<float>( size ) / static_cast<float>( res.texture->getWidth() );
+              image.drawQuad( { c[0], { 0, 0 } }, { c[1], { uv, 0 } }, { c[2], { uv, uv } }, { c[3], { 0, uv } }, *res.texture, AddressMode::Wrap, blendMode );
+          } },
+        { "sprite_matrix", true, true, rotatedSquareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              const float     s = static_cast<float>( size );
+              const glm::vec2 p = position( image, i, size ) + glm::vec2 { s * 0.5f };
+              const float     a = static_cast<float>( i % 360 ) * std::numbers::pi_v<float> / 180.0f;
+
+              Math::Transform2D transform { p, glm::vec2 { InvSqrt2 }, a };
+              transform.setAnchor( glm::vec2 { s * 0.5f } );
+
+              res.sprite = Sprite { res.texture, Math::RectI { 0, 0, size, size }, blendMode };
+              image.drawSprite( res.sprite, transform );
+          } },
+        { "sprite_batch", true, true, rotatedSquareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              const float     s = static_cast<float>( size );
+              const glm::vec2 p = position( image, i, size ) + glm::vec2 { s * 0.5f };
+              const float     a = static_cast<float>( i % 360 ) * std::numbers::pi_v<float> / 180.0f;
+
+              Math::Transform2D transform { p, glm::vec2 { InvSqrt2 }, a };
+              transform.setAnchor( glm::vec2 { s * 0.5f } );
+
+              res.sprite = Sprite { res.texture, Math::RectI { 0, 0, size, size }, blendMode };
+              res.batch.draw( res.sprite, transform );
+          },
+          []( Image& image, Resources& res ) {
+              res.batch.render( image );
+              res.batch.clear();
+          } },
+        { "sprite_xy", true, true, squareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              const glm::vec2 p = position( image, i, size );
+              res.sprite        = Sprite { res.texture, Math::RectI { 0, 0, size, size }, blendMode };
+              image.drawSprite( res.sprite, static_cast<int>( p.x ), static_cast<int>( p.y ) );
+          } },
+        { "triangle_3d", true, true,
+          []( const Image&, const Resources&, int size ) { return static_cast<double>( size ) * size * 0.5; },
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              // Each triangle is in front of the previous triangles, so every pixel passes the depth test.
+              constexpr uint32_t Period = 65536u;
+              if ( !resizeDepthBuffer( image, res ) && i % Period == 0 )
+              {
+                  image.flush();
+                  res.depthBuffer.clear();
+              }
+
+              const glm::vec2 p     = position( image, i, size );
+              const float     s     = static_cast<float>( size );
+              const float     uv    = s / static_cast<float>( res.texture->getWidth() );
+              const float     depth = 1.0f - static_cast<float>( i % Period + 1 ) / static_cast<float>( Period );
+              image.drawTriangle( clipVertex( image, p, depth, 1.0f, { 0, 0 } ), clipVertex( image, p + glm::vec2 { s, 0 }, depth, 2.0f, { uv, 0 } ), clipVertex( image, p + glm::vec2 { 0, s }, depth, 3.0f, { 0, uv } ), res.depthBuffer, *res.texture, AddressMode::Wrap, CullMode::None, blendMode );
+          } },
+        { "triangle_3d_occluded", false, true,
+          []( const Image&, const Resources&, int size ) { return static_cast<double>( size ) * size * 0.5; },
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& ) {
+              // The depth buffer is cleared to the near plane, so every triangle is occluded.
+              if ( resizeDepthBuffer( image, res ) )
+                  res.depthBuffer.clear( 0.0f );
+
+              const glm::vec2 p  = position( image, i, size );
+              const float     s  = static_cast<float>( size );
+              const float     uv = s / static_cast<float>( res.texture->getWidth() );
+              image.drawTriangle( clipVertex( image, p, 0.5f, 1.0f, { 0, 0 } ), clipVertex( image, p + glm::vec2 { s, 0 }, 0.5f, 2.0f, { uv, 0 } ), clipVertex( image, p + glm::vec2 { 0, s }, 0.5f, 3.0f, { 0, uv } ), res.depthBuffer, *res.texture );
+          } },
+        { "mesh_indexed", true, true, rotatedSquareArea,
+          [=]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+              createMesh( res, size );
+
+              const float     s = static_cast<float>( size );
+              const glm::vec2 p = position( image, i, size ) + glm::vec2 { s * 0.5f };
+              const float     a = static_cast<float>( i % 360 ) * std::numbers::pi_v<float> / 180.0f;
+
+              const Math::Transform2D transform { p, glm::vec2 { InvSqrt2 }, a };
+              image.drawIndexed( res.meshVertices, res.meshIndices, res.texture.get(), blendMode, transform.getTransform() );
+          } },
+        { "circle", true, true,
+          []( const Image&, const Resources&, int size ) { return std::numbers::pi * size * size * 0.25; },
+          [=]( Image& image, Resources&, uint32_t i, int size, const BlendMode& blendMode ) {
+              const float r = static_cast<float>( size ) * 0.5f;
+              image.drawCircle( Math::Circle { position( image, i, size ) + glm::vec2 { r }, r }, color, blendMode );
+          } },
+        { "text", false, false,
+          []( const Image&, const Resources& res, int ) {
+              const glm::vec2 size = Font::Default.getSize( res.text );
+              return static_cast<double>( size.x ) * size.y;
+          },
+          [=]( Image& image, Resources& res, uint32_t i, int, const BlendMode& ) {
+              const glm::vec2 p = position( image, i, 400 );
+              image.drawText( Font::Default, res.text, static_cast<int>( p.x ), static_cast<int>( p.y ), color );
+          } },
+    };
+}
+
+// Draw the rotated textured primitives again with the texture in the tiled layout, to compare the texture layouts.
+static void addTiledPrimitives( std::vector<Primitive>& primitives )
+{
+    const std::pair<const char*, const char*> names[] = {
+        { "quad_textured", "quad_textured_tiled" },
+        { "sprite_matrix", "sprite_matrix_tiled" },
+        { "sprite_batch", "sprite_batch_tiled" },
+        { "mesh_indexed", "mesh_indexed_tiled" },
+    };
+
+    for ( const auto& [name, tiledName]: names )
+    {
+        const auto iter = std::ranges::find_if( primitives, [&]( const Primitive& p ) { return std::strcmp( p.name, name ) == 0; } );
+        if ( iter == primitives.end() )
+            continue;
+
+        Primitive tiled = *iter;
+        tiled.name      = tiledName;
+        tiled.draw      = [draw = iter->draw]( Image& image, Resources& res, uint32_t i, int size, const BlendMode& blendMode ) {
+            std::swap( res.texture, res.tiledTexture );
+            draw( image, res, i, size, blendMode );
+            std::swap( res.texture, res.tiledTexture );
+        };
+
+        primitives.push_back( std::move( tiled ) );
+    }
+}
+
+// Measure a primitive. The primitive is drawn in batches until the minimum time has elapsed.
+// The per-call latency is derived from the time of each batch.
+static Result measure( Image& image, Resources& res, const Primitive& primitive, int size, const BlendMode& blendMode, bool deferred, double minTime )
+{
+    uint32_t i = 0;
+    Timer    timer;
+
+    auto runBatch = [&]( uint32_t batchSize ) {
+        timer.tick();
+
+        if ( deferred )
+            image.beginDeferred();
+
+        for ( uint32_t n = 0; n < batchSize; ++n )
+            primitive.draw( image, res, i++, size, blendMode );
+
+        if ( primitive.finish )
+            primitive.finish( image, res );
+
+        if ( deferred )
+            image.endDeferred();
+
+        timer.tick();
+        return timer.elapsedSeconds();
+    };
+
+    // Warm up, and determine a batch size that takes at least ~0.5 ms.
+    uint32_t batchSize = 1;
+    while ( runBatch( batchSize ) < 0.0005 && batchSize < ( 1u << 20 ) )
+        batchSize *= 2;
+
+    std::vector<double> nsPerCall;
+    double              seconds = 0.0;
+    double              calls   = 0.0;
+
+    while ( seconds < minTime || nsPerCall.size() < 5 )
+    {
+        const double t = runBatch( batchSize );
+        seconds += t;
+        calls += batchSize;
+        nsPerCall.push_back( t * 1e9 / batchSize );
+    }
+
+    std::ranges::sort( nsPerCall );
+
+    return {
+        .calls           = calls,
+        .seconds         = seconds,
+        .nsPerCallMedian = nsPerCall[nsPerCall.size() / 2],
+        .nsPerCallP99    = nsPerCall[std::min( nsPerCall.size() - 1, nsPerCall.size() * 99 / 100 )],
+    };
+}
+
+static std::vector<std::string> split( const char* str )
+{
+    std::vector<std::string> result;
+    std::string              s { str };
+    size_t                   begin = 0;
+
+    while ( begin <= s.size() )
+    {
+        const size_t end = std::min( s.find( ',', begin ), s.size() );
+        if ( end > begin )
+            result.emplace_back( s.substr( begin, end - begin ) );
+        begin = end + 1;
+    }
+
+    return result;
+}
+
+static bool parseOptions( int argc, char* argv[], Options& options )
+{
+    const int numCores = static_cast<int>( std::max( std::thread::hardware_concurrency(), 1u ) );
+    for ( int n = 1; n < numCores; n *= 2 )
+        options.threads.push_back( n );
+    options.threads.push_back( numCores );
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const bool hasValue = i + 1 < argc;
+
+        if ( strcmp( argv[i], "--quick" ) == 0 )
+        {
+            options.minTime     = 0.02;
+            options.resolutions = { { 640, 480 } };
+            options.threads     = { 1, numCores };
+            options.sizes       = { 32 };
+        }
+        else if ( strcmp( argv[i], "--deferred" ) == 0 )
+        {
+            options.deferred = true;
+        }
+        else if ( strcmp( argv[i], "--out" ) == 0 && hasValue )
+        {
+            options.outFile = argv[++i];
+        }
+        else if ( strcmp( argv[i], "--min-time" ) == 0 && hasValue )
+        {
+            options.minTime = std::atof( argv[++i] );
+        }
+        else if ( strcmp( argv[i], "--filter" ) == 0 && hasValue )
+        {
+            options.filters = split( argv[++i] );
+        }
+        else if ( strcmp( argv[i], "--resolutions" ) == 0 && hasValue )
+        {
+            options.resolutions.clear();
+            for ( const auto& res: split( argv[++i] ) )
+            {
+                Resolution r {};
+                if ( std::sscanf( res.c_str(), "%dx%d", &r.width, &r.height ) == 2 && r.width > 0 && r.height > 0 )
+                    options.resolutions.push_back( r );
+            }
+        }
+        else if ( strcmp( argv[i], "--threads" ) == 0 && hasValue )
+        {
+            options.threads.clear();
+            for ( const auto& n: split( argv[++i] ) )
+                options.threads.push_back( std::max( std::atoi( n.c_str() ), 1 ) );
+        }
+        else if ( strcmp( argv[i], "--sizes" ) == 0 && hasValue )
+        {
+            options.sizes.clear();
+            for ( const auto& n: split( argv[++i] ) )
+                options.sizes.push_back( std::max( std::atoi( n.c_str() ), 1 ) );
+        }
+        else if ( strcmp( argv[i], "--texture-size" ) == 0 && hasValue )
+        {
+            options.textureSize = std::max( std::atoi( argv[++i] ), 1 );
+        }
+        else
+        {
+            std::fprintf( stderr, "Unknown or incomplete option: %s\n", argv[i] );
+            return false;
+        }
+    }
+
+    // Don't measure the same thread count twice (for example, on a single core machine).
+    std::ranges::sort( options.threads );
+    options.threads.erase( std::ranges::unique( options.threads ).begin(), options.threads.end() );
+
+    return !options.resolutions.empty() && !options.threads.empty() && !options.sizes.empty();
+}
+
+// Create a texture with a checkerboard pattern and an alpha gradient, so that blending has an effect.
+static std::shared_ptr<Image> createTexture( uint32_t size )
+{
+    auto texture = std::make_shared<Image>( size, size );
+
+    for ( uint32_t y = 0; y < size; ++y )
+    {
+        for ( uint32_t x = 0; x < size; ++x )
+        {
+            const bool    checker = ( ( x / 16 ) ^ ( y / 16 ) ) & 1;
+            const uint8_t alpha   = static_cast<uint8_t>( x * 255 / std::max( size - 1, 1u ) );
+            ( *texture )( x, y )  = checker ? Color { 255, 255, 255, alpha } : Color { 32, 96, 192, alpha };
+        }
+    }
+
+    return texture;
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    if ( !parseOptions( argc, argv, options ) )
+        return 1;
+
+    std::FILE* out = stdout;
+    if ( !options.outFile.empty() )
+    {
+        out = std::fopen( options.outFile.c_str(), "w" );
+        if ( !out )
+        {
+            std::fprintf( stderr, "Failed to open %s for writing.\n", options.outFile.c_str() );
+            return 1;
+        }
+    }
+
+    const int maxSize = *std::ranges::max_element( options.sizes );
+
+    Resources res;
+    res.texture = createTexture( static_cast<uint32_t>( options.textureSize > 0 ? options.textureSize : std::max( maxSize, 512 ) ) );
+    for ( const int size: options.sizes )
+        res.images.emplace( size, *createTexture( static_cast<uint32_t>( size ) ) );
+
+    res.tiledTexture = std::make_shared<Image>( *res.texture );
+    res.tiledTexture->setTextureLayout( TextureLayout::Tiled );
+
+    const std::pair<const char*, const BlendMode*> blendModes[] = {
+        { "Disable", &BlendMode::Disable },
+        { "AlphaBlend", &BlendMode::AlphaBlend },
+        { "AdditiveBlend", &BlendMode::AdditiveBlend },
+        { "SubtractiveBlend", &BlendMode::SubtractiveBlend },
+    };
+
+    std::vector<Primitive> primitives = createPrimitives();
+    addTiledPrimitives( primitives );
+
+    const std::time_t now = std::time( nullptr );
+    char              date[32];
+    std::strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%SZ", std::gmtime( &now ) );
+
+    std::fprintf( out, "{\n" );
+    std::fprintf( out, "  \"date\": \"%s\",\n", date );
+#if defined( NDEBUG )
+    std::fprintf( out, "  \"build\": \"release\",\n" );
+#else
+    std::fprintf( out, "  \"build\": \"debug\",\n" );
+#endif
+    std::fprintf( out, "  \"hardware_concurrency\": %u,\n", std::thread::hardware_concurrency() );
+    std::fprintf( out, "  \"min_time\": %g,\n", options.minTime );
+    std::fprintf( out, "  \"results\": [" );
+
+    bool first = true;
+
+    for ( const auto& primitive: primitives )
+    {
+        if ( !options.filters.empty() && std::ranges::none_of( options.filters, [&]( const std::string& f ) { return std::strstr( primitive.name, f.c_str() ) != nullptr; } ) )
+            continue;
+
+        for ( const auto& [width, height]: options.resolutions )
+        {
+            Image image { static_cast<uint32_t>( width ), static_cast<uint32_t>( height ) };
+
+            for ( const int threads: options.threads )
+            {
+                ThreadPool::get().setNumThreads( static_cast<uint32_t>( threads ) );
+
+                for ( size_t m = 0; m < ( primitive.blended ? std::size( blendModes ) : 1 ); ++m )
+                {
+                    const auto& [blendName, blendMode] = primitive.blended ? blendModes[m] : std::pair { "n/a", &BlendMode::Disable };
+
+                    for ( size_t s = 0; s < ( primitive.sized ? options.sizes.size() : 1 ); ++s )
+                    {
+                        const int size = primitive.sized ? options.sizes[s] : 0;
+
+                        // Skip primitives that don't fit on the screen.
+                        if ( size > std::min( width, height ) )
+                            continue;
+
+                        for ( int deferred = 0; deferred <= ( options.deferred ? 1 : 0 ); ++deferred )
+                        {
+                            const Result result = measure( image, res, primitive, size, *blendMode, deferred != 0, options.minTime );
+                            const double pixels = primitive.pixels( image, res, size );
+
+                            std::fprintf( out, "%s\n    {\"primitive\": \"%s\", \"width\": %d, \"height\": %d, \"blend_mode\": \"%s\", \"threads\": %d, \"size\": %d, \"deferred\": %s, ",
+                                          first ? "" : ",", primitive.name, width, height, blendName, threads, size, deferred ? "true" : "false" );
+                            std::fprintf( out, "\"calls\": %.0f, \"seconds\": %.6f, \"primitives_per_second\": %.1f, \"pixels_per_second\": %.1f, \"ns_per_call_median\": %.1f, \"ns_per_call_p99\": %.1f}",
+                                          result.calls, result.seconds, result.calls / result.seconds, pixels * result.calls / result.seconds, result.nsPerCallMedian, result.nsPerCallP99 );
+                            std::fflush( out );
+
+                            first = false;
+
+                            std::fprintf( stderr, "%-18s %4dx%-4d %-16s threads=%-2d size=%-4d %s %12.0f prims/s %8.1f Mpx/s\n", primitive.name, width, height, blendName, threads, size,
+                                          deferred ? "deferred " : "immediate", result.calls / result.seconds, pixels * result.calls / result.seconds * 1e-6 );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::fprintf( out, "\n  ]\n}\n" );
+
+    if ( out != stdout )
+        std::fclose( out );
+
+    return 0;
+}
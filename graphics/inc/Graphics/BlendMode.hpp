@@ -109,6 +109,11 @@ struct SR_API BlendMode
     /// <returns></returns>
     constexpr Color Blend( const Color& srcColor, const Color& dstColor ) const noexcept;
 
+    /// <summary>
+    /// Compare two blend modes.
+    /// </summary>
+    constexpr bool operator==( const BlendMode& rhs ) const noexcept = default;
+
     static const BlendMode Disable;
     static const BlendMode AlphaBlend;
     static const BlendMode AdditiveBlend;
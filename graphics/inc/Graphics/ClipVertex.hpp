@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Color.hpp"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Graphics
+{
+/// <summary>
+/// A vertex of a 3D primitive, after it has been transformed to clip space
+/// (for example by a model-view-projection matrix).
+/// Clip space follows the OpenGL conventions: a vertex is visible if -w &lt;= x, y, z &lt;= w,
+/// +y points up, and the depth is z / w mapped from [-1..1] to [0..1].
+/// </summary>
+struct ClipVertex
+{
+    constexpr ClipVertex( const glm::vec4& position = glm::vec4 { 0, 0, 0, 1 }, const glm::vec2& texCoord = glm::vec2 { 0 }, const Color& color = Color::White )
+    : position { position }
+    , texCoord { texCoord }
+    , color { color }
+    {}
+
+    glm::vec4 position { 0, 0, 0, 1 };
+    glm::vec2 texCoord { 0 };
+    Color     color { Color::White };
+};
+}  // namespace Graphics
@@ -3,6 +3,9 @@
 #if defined(_WIN32)
     #define SR_IMPORT __declspec( dllimport )
     #define SR_EXPORT __declspec( dllexport )
+#else
+    #define SR_IMPORT
+    #define SR_EXPORT __attribute__( ( visibility( "default" ) ) )
 #endif
 
 #if defined( SoftwareRasterizer_EXPORTS )
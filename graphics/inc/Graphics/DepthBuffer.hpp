@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A buffer of depth values (in the range [0..1], smaller is closer) for drawing 3D primitives with hidden surface removal.
+/// Besides the depth of each pixel, the buffer keeps the minimum and maximum depth of each tile of 8x8 pixels
+/// (a hierarchical depth buffer). A primitive that is behind the maximum depth of every tile it overlaps is
+/// rejected without visiting its pixels, and the pixels of a tile that are in front of its minimum depth
+/// pass the depth test without reading the depth buffer.
+/// </summary>
+/// <remarks>
+/// The depth buffer must have the same size as the image that is drawn to (see <see cref="Image::drawTriangle"/>).
+/// </remarks>
+class SR_API DepthBuffer final
+{
+public:
+    /// <summary>
+    /// The width and height (in pixels) of a tile of the hierarchical depth buffer.
+    /// </summary>
+    static constexpr uint32_t TileSize = 8u;
+
+    /// <summary>
+    /// The range of depth values in a tile.
+    /// </summary>
+    struct Tile
+    {
+        float min;
+        float max;
+    };
+
+    DepthBuffer() = default;
+
+    /// <summary>
+    /// Create a depth buffer. The depth buffer is cleared to the far plane (1).
+    /// </summary>
+    /// <param name="width">The width (in pixels).</param>
+    /// <param name="height">The height (in pixels).</param>
+    DepthBuffer( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Resize the depth buffer. The depth buffer is cleared to the far plane (1).
+    /// </summary>
+    /// <param name="width">The new width (in pixels).</param>
+    /// <param name="height">The new height (in pixels).</param>
+    void resize( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Set every pixel of the depth buffer to a depth value.
+    /// Note: In deferred mode, don't clear the depth buffer until the image that uses it has been flushed.
+    /// </summary>
+    /// <param name="depth">(optional) The depth to clear to. Default: 1 (the far plane).</param>
+    void clear( float depth = 1.0f ) noexcept;
+
+    uint32_t getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    uint32_t getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Get the number of tiles in a row of the hierarchical depth buffer.
+    /// </summary>
+    uint32_t getTilesX() const noexcept
+    {
+        return m_TilesX;
+    }
+
+    /// <summary>
+    /// Get the number of rows of tiles of the hierarchical depth buffer.
+    /// </summary>
+    uint32_t getTilesY() const noexcept
+    {
+        return m_TilesY;
+    }
+
+    /// <summary>
+    /// Get the depth range of a tile.
+    /// </summary>
+    /// <param name="tx">The column of the tile.</param>
+    /// <param name="ty">The row of the tile.</param>
+    const Tile& getTile( uint32_t tx, uint32_t ty ) const noexcept
+    {
+        assert( tx < m_TilesX && ty < m_TilesY );
+
+        return m_Tiles[static_cast<std::size_t>( ty ) * m_TilesX + tx];
+    }
+
+    /// <summary>
+    /// Recompute the depth range of a tile from its pixels.
+    /// This must be called after writing to the pixels of the tile directly (it is done automatically by the draw functions).
+    /// </summary>
+    /// <param name="tx">The column of the tile.</param>
+    /// <param name="ty">The row of the tile.</param>
+    void updateTile( uint32_t tx, uint32_t ty ) noexcept;
+
+    float& operator()( uint32_t x, uint32_t y ) noexcept
+    {
+        assert( x < m_Width && y < m_Height );
+
+        return m_Depth[static_cast<std::size_t>( y ) * m_Width + x];
+    }
+
+    float operator()( uint32_t x, uint32_t y ) const noexcept
+    {
+        assert( x < m_Width && y < m_Height );
+
+        return m_Depth[static_cast<std::size_t>( y ) * m_Width + x];
+    }
+
+    /// <summary>
+    /// Get a pointer to the depth values (in row-major order).
+    /// </summary>
+    float* data() noexcept
+    {
+        return m_Depth.data();
+    }
+
+    const float* data() const noexcept
+    {
+        return m_Depth.data();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return !m_Depth.empty();
+    }
+
+private:
+    uint32_t m_Width  = 0u;
+    uint32_t m_Height = 0u;
+    uint32_t m_TilesX = 0u;
+    uint32_t m_TilesY = 0u;
+
+    std::vector<float> m_Depth;
+    std::vector<Tile>  m_Tiles;
+};
+}  // namespace Graphics
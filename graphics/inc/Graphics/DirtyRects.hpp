@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <Math/Rect.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A short list of rectangles that cover the regions of an image that have changed.
+/// Rectangles that overlap (or are close enough that merging them doesn't add much area) are merged,
+/// and the number of rectangles is limited, so the list stays cheap to process.
+/// The rectangles in the list don't overlap.
+/// </summary>
+class SR_API DirtyRects final
+{
+public:
+    /// <summary>
+    /// The maximum number of rectangles in the list.
+    /// If a rectangle is added to a full list, it is merged with the rectangle that grows the least.
+    /// </summary>
+    static constexpr size_t MaxRects = 16;
+
+    /// <summary>
+    /// Add a rectangle to the list. Empty rectangles are ignored.
+    /// </summary>
+    /// <param name="rect">The rectangle to add.</param>
+    void add( const Math::RectI& rect );
+
+    /// <summary>
+    /// Remove all rectangles from the list.
+    /// </summary>
+    void clear() noexcept
+    {
+        m_Rects.clear();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_Rects.empty();
+    }
+
+    size_t size() const noexcept
+    {
+        return m_Rects.size();
+    }
+
+    /// <summary>
+    /// Get the total area (in pixels) of the rectangles in the list.
+    /// </summary>
+    int64_t getArea() const noexcept;
+
+    /// <summary>
+    /// Get the bounding rectangle of all rectangles in the list.
+    /// </summary>
+    Math::RectI getBounds() const noexcept;
+
+    const Math::RectI& operator[]( size_t i ) const noexcept
+    {
+        return m_Rects[i];
+    }
+
+    auto begin() const noexcept
+    {
+        return m_Rects.begin();
+    }
+
+    auto end() const noexcept
+    {
+        return m_Rects.end();
+    }
+
+private:
+    std::vector<Math::RectI> m_Rects;
+};
+}  // namespace Graphics
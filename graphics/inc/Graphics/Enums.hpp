@@ -13,6 +13,29 @@ enum class AddressMode
     Clamp,   ///< Clamp texture coordinates in the range 0..1.
 };
 
+/// <summary>
+/// Filter modes used for texture sampling.
+/// The bilinear and trilinear filters sample the mipmaps of the texture when the texture is minified
+/// (see <see cref="Image::getMipLevel"/>). The mip level is chosen once per primitive.
+/// </summary>
+enum class FilterMode
+{
+    Point,      ///< Use the nearest texel.
+    Bilinear,   ///< Interpolate between the 4 nearest texels of the nearest mip level.
+    Trilinear,  ///< Interpolate between the bilinear samples of the 2 nearest mip levels.
+};
+
+/// <summary>
+/// The order in which the pixels of an image are stored (see <see cref="Image::setTextureLayout"/>).
+/// Rotated draws walk a texture diagonally: in the linear layout almost every texel is in a different cache line,
+/// in the tiled layout the texels of a 4x4 block share a single (64-byte) cache line.
+/// </summary>
+enum class TextureLayout
+{
+    Linear,  ///< Row-major. Images that are drawn to must use this layout.
+    Tiled,   ///< Blocks of 4x4 texels (rows of 4 texels in each block), with the blocks in row-major order. Read-only.
+};
+
 /// <summary>
 /// FillMode determines how primitives are rendered.
 /// * FillMode::WireFrame: Primitives are rendered as lines.
@@ -25,4 +48,30 @@ enum class FillMode
     Solid       ///< Polygons interiors are filled.
 };
 
+/// <summary>
+/// CullMode determines which triangles are skipped based on their winding order.
+/// Front-facing triangles are counter-clockwise as they appear in the image, for both 3D and 2D triangles:
+/// * 3D triangles are counter-clockwise in normalized device coordinates (where +y points up), the same convention as OpenGL.
+/// * 2D triangles (see <see cref="Image::drawIndexed"/>) are counter-clockwise in image space as it is displayed
+///   (where +y points down). The corners of a sprite (top-left, top-right, bottom-right, bottom-left) are clockwise,
+///   so they are back-facing.
+/// </summary>
+enum class CullMode
+{
+    None,   ///< Draw all triangles.
+    Back,   ///< Skip the triangles that face away from the viewer.
+    Front,  ///< Skip the triangles that face the viewer.
+};
+
+/// <summary>
+/// SpriteSortMode determines the order in which the sprites of a sprite batch are drawn.
+/// Sorting by image keeps the submission order of sprites that use the same image, but
+/// overlapping sprites with different images may be drawn in a different order.
+/// </summary>
+enum class SpriteSortMode
+{
+    Submission,  ///< Draw the sprites in the order they were submitted.
+    Image,       ///< Draw sprites that share an image together.
+};
+
 }
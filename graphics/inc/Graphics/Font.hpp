@@ -4,14 +4,26 @@
 #include "Config.hpp"
 
 #include <glm/vec2.hpp>
-#include <stb_truetype.h>
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <string_view>
 
 namespace Graphics
 {
 class Image;
+class ResourceManager;
+class FontFace;
+class GlyphRunCache;
+struct GlyphRun;
 
+/// <summary>
+/// A font that renders text at a specific size.
+/// TrueType glyphs are rasterized on demand into a glyph atlas, so any character of the font can be rendered.
+/// The font file and the glyph atlas are shared by the fonts of all sizes that are loaded from the same file
+/// through the ResourceManager.
+/// </summary>
 class SR_API Font
 {
 public:
@@ -24,11 +36,13 @@ public:
 
     /// <summary>
     /// Load a font from a font file.
+    /// Glyphs are rasterized when they are first used. The characters in the range [firstChar, firstChar + numChars)
+    /// are rasterized up-front.
     /// </summary>
     /// <param name="fontFile">The TrueType font to load.</param>
     /// <param name="size">(optional) The size of the font (in pixels) to generate. Default: 12</param>
-    /// <param name="firstChar">(optional) The first character in the font texture. Default: ' '.</param>
-    /// <param name="numChars">(optional) The number of characters in the font texture. Default: 96.</param>
+    /// <param name="firstChar">(optional) The first character to rasterize up-front. Default: ' '.</param>
+    /// <param name="numChars">(optional) The number of characters to rasterize up-front. Default: 96.</param>
     Font( const std::filesystem::path& fontFile, float size = 12.0f, uint32_t firstChar = 32u, uint32_t numChars = 96u);
 
     /// <summary>
@@ -46,7 +60,7 @@ public:
     // Font's can't be copied or moved (yet).
     Font( const Font& font ) = delete;
     Font( Font&& font )      = delete;
-    ~Font()                  = default;
+    ~Font();
 
     Font& operator=( const Font& font )     = delete;
     Font& operator=( Font&& font ) noexcept = delete;
@@ -58,18 +72,27 @@ public:
 
 private:
     friend class Image;
+    friend class ResourceManager;
 
-    void drawText( Image& image, std::wstring_view text, int x, int y, const Color& color ) const;
-    void drawText( Image& image, std::string_view text, int x, int y, const Color& color ) const;
+    Font( std::shared_ptr<FontFace> face, float size, uint32_t firstChar, uint32_t numChars );
+
+    /// <summary>
+    /// Get the glyph run for a string of text (relative to the text position).
+    /// The glyph runs are cached, so text that is drawn every frame is only rendered once.
+    /// </summary>
+    /// <returns>The glyph run, or nullptr if the text is empty.</returns>
+    std::shared_ptr<const GlyphRun> getGlyphRun( std::string_view text, const Color& color ) const;
+    std::shared_ptr<const GlyphRun> getGlyphRun( std::wstring_view text, const Color& color ) const;
+
+    template<typename CharT>
+    std::shared_ptr<const GlyphRun> createGlyphRun( std::basic_string_view<CharT> text, const Color& color ) const;
 
     // The font size.
     float size;
-    uint32_t firstChar = 0;
-    uint32_t numChars = 0;
+    // The scale from font units to pixels.
+    float scale = 0.0f;
 
-    stbtt_fontinfo                     fontInfo;
-    std::unique_ptr<Image>             fontImage;
-    std::unique_ptr<stbtt_bakedchar[]> bakedChar;
-    std::vector<unsigned char>         fontData;
+    std::shared_ptr<FontFace>      face;  ///< The TrueType font face, or nullptr for the default font.
+    std::unique_ptr<GlyphRunCache> runCache;
 };
 }  // namespace Graphics
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "BlendMode.hpp"
+#include "ClipVertex.hpp"
 #include "Color.hpp"
 #include "Config.hpp"
+#include "DirtyRects.hpp"
 #include "Enums.hpp"
 #include "Vertex.hpp"
 #include "aligned_unique_ptr.hpp"
@@ -10,9 +12,11 @@
 #include <Math/AABB.hpp>
 #include <Math/Transform2D.hpp>
 
+#include <atomic>
 #include <cassert>
 #include <filesystem>
 #include <memory>
+#include <span>
 
 #include <glm/vec2.hpp>
 
@@ -21,6 +25,9 @@ namespace Graphics
 
 class Sprite;
 class Font;
+class DepthBuffer;
+class CommandBuffer;
+struct GlyphRun;
 
 struct SR_API Image final
 {
@@ -32,10 +39,21 @@ struct SR_API Image final
 
     /// <summary>
     /// Load an image from a file.
+    /// Texture files (.srtex) are memory-mapped instead of decoded (see <see cref="TextureFile"/>).
     /// </summary>
     /// <param name="fileName">The file to load.</param>
     explicit Image( const std::filesystem::path& fileName );
 
+    /// <summary>
+    /// Construct an image that references pixels it doesn't own.
+    /// The pixels are kept alive by the owner, which is released when the image is destroyed or resized.
+    /// </summary>
+    /// <param name="width">The image width (in pixels).</param>
+    /// <param name="height">The image height (in pixels).</param>
+    /// <param name="pixels">The pixels (width * height colors).</param>
+    /// <param name="owner">The owner of the pixels (for example, a memory-mapped file).</param>
+    Image( uint32_t width, uint32_t height, Color* pixels, std::shared_ptr<const void> owner );
+
     /// <summary>
     /// Construct an image from an initial width and height.
     /// </summary>
@@ -58,7 +76,7 @@ struct SR_API Image final
     /// <summary>
     /// Destructor.
     /// </summary>
-    ~Image() = default;
+    ~Image();
 
     /// <summary>
     /// Copy assignment operator.
@@ -82,9 +100,19 @@ struct SR_API Image final
         return m_data != nullptr;
     }
 
+    /// <summary>
+    /// Check if the image owns its pixels.
+    /// Images that reference external pixels (for example, a memory-mapped texture file) don't.
+    /// </summary>
+    bool ownsData() const noexcept
+    {
+        return m_data.get_deleter().owner == nullptr;
+    }
+
     /// <summary>
     /// Resize this image.
-    /// Note: Does nothing if the image is already the requested size.
+    /// Note: Does nothing if the image is already the requested size (and owns its pixels).
+    /// An image that references external pixels is moved to owned storage.
     /// </summary>
     /// <param name="width">The new image width (in pixels).</param>
     /// <param name="height">The new image height (in pixels).</param>
@@ -97,10 +125,92 @@ struct SR_API Image final
     ///   * BMP
     ///   * TGA
     ///   * JPEG
+    ///   * SRTEX (see <see cref="TextureFile"/>)
     /// </summary>
     /// <param name="file">The name of the file to save this image to.</param>
     void save( const std::filesystem::path& file ) const;
 
+    /// <summary>
+    /// Start recording draw commands instead of drawing them immediately.
+    /// While the image is in deferred mode, the draw functions append commands to a command list.
+    /// When the image is flushed, the commands are binned into square tiles and each tile is
+    /// rendered by a single thread, executing the commands that overlap the tile in submission order.
+    /// This keeps the tile in the cache and avoids the overhead of a parallel region per draw call,
+    /// which is a win when drawing many small primitives.
+    /// Note: Images, sprites, and fonts used by the recorded commands must stay alive until the image is flushed.
+    /// Note: Direct pixel access (plot, operator(), data) is not recorded.
+    /// </summary>
+    /// <param name="tileSize">(optional) The width and height of a tile (in pixels). Default: 64.</param>
+    void beginDeferred( uint32_t tileSize = 64u );
+
+    /// <summary>
+    /// Execute all of the recorded draw commands.
+    /// The image stays in deferred mode, so this is typically called once per frame.
+    /// </summary>
+    void flush();
+
+    /// <summary>
+    /// Execute all of the recorded draw commands and go back to drawing immediately.
+    /// </summary>
+    void endDeferred();
+
+    /// <summary>
+    /// Check if the image is recording draw commands.
+    /// </summary>
+    bool isDeferred() const noexcept
+    {
+        return m_CommandBuffer != nullptr;
+    }
+
+    /// <summary>
+    /// Enable or disable dirty rectangle tracking.
+    /// While tracking is enabled, each draw call records the region of the image it touches.
+    /// The regions are merged into a short list of dirty rectangles that the window uses to
+    /// only upload (or encode) the parts of the image that changed since the previous frame.
+    /// A typical frame calls <see cref="clearDirty"/> instead of <see cref="clear"/>, then draws, and then presents the image.
+    /// Note: Direct pixel access (plot, operator(), data) is not tracked. Use <see cref="markDirty"/> to record those changes.
+    /// </summary>
+    /// <param name="enabled">`true` to enable tracking. Enabling tracking marks the entire image as dirty.</param>
+    void setDirtyTracking( bool enabled );
+
+    /// <summary>
+    /// Check if dirty rectangle tracking is enabled.
+    /// </summary>
+    bool isDirtyTracking() const noexcept
+    {
+        return m_DirtyTracking;
+    }
+
+    /// <summary>
+    /// Get the regions of the image that changed since the dirty rectangles were last reset
+    /// (by <see cref="clearDirty"/> or <see cref="resetDirtyRects"/>).
+    /// Only valid if dirty rectangle tracking is enabled.
+    /// </summary>
+    const DirtyRects& getDirtyRects() const noexcept
+    {
+        return m_DirtyRects;
+    }
+
+    /// <summary>
+    /// Record a region of the image that was modified (for example, with direct pixel access).
+    /// Does nothing if dirty rectangle tracking is disabled.
+    /// </summary>
+    /// <param name="rect">The modified region. The region is clipped to the image.</param>
+    void markDirty( const Math::RectI& rect ) noexcept;
+
+    /// <summary>
+    /// Forget the regions that changed. Call this after the image was presented if <see cref="clearDirty"/> is not used.
+    /// </summary>
+    void resetDirtyRects() noexcept;
+
+    /// <summary>
+    /// Clear the regions that were drawn to since the last clear (instead of the entire image), and start a new frame.
+    /// After this call, the dirty rectangles are the cleared regions, so the window restores the background when the image is presented.
+    /// If dirty rectangle tracking is disabled, the entire image is cleared.
+    /// </summary>
+    /// <param name="color">The color to clear the regions to. This should be the same color the image was last cleared to.</param>
+    void clearDirty( const Color& color ) noexcept;
+
     /// <summary>
     /// Clear the image to a single color.
     /// </summary>
@@ -198,6 +308,36 @@ struct SR_API Image final
     /// <param name="fillMode">The fill mode to use when rendering.</param>
     void drawTriangle( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const Color& color, const BlendMode& blendMode = {}, FillMode fillMode = FillMode::Solid ) noexcept;
 
+    /// <summary>
+    /// Draw a 3D triangle with (perspective-correct) vertex colors.
+    /// The triangle is clipped to the view volume, and only the pixels that are closer than the depth buffer
+    /// (the depth test passes if the depth is less than the depth buffer) are drawn. The depth buffer is updated with
+    /// the depth of the drawn pixels.
+    /// Note: In deferred mode, the depth buffer must stay alive (and must not be cleared) until the image is flushed.
+    /// Deferred 3D triangles require a tile size that is a multiple of <see cref="DepthBuffer::TileSize"/>, otherwise they are drawn immediately.
+    /// </summary>
+    /// <param name="v0">The first vertex (in clip space).</param>
+    /// <param name="v1">The second vertex (in clip space).</param>
+    /// <param name="v2">The third vertex (in clip space).</param>
+    /// <param name="depthBuffer">The depth buffer to test against. Must be the same size as the image.</param>
+    /// <param name="cullMode">(optional) The triangles to skip based on their winding order. Default: CullMode::None</param>
+    /// <param name="blendMode">(optional) The blend mode to apply. Default: No blending.</param>
+    void drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, CullMode cullMode = CullMode::None, const BlendMode& blendMode = {} ) noexcept;
+
+    /// <summary>
+    /// Draw a textured 3D triangle with perspective-correct texture coordinates.
+    /// The texels are multiplied by the vertex colors. See the other overload for the clipping and depth testing.
+    /// </summary>
+    /// <param name="v0">The first vertex (in clip space).</param>
+    /// <param name="v1">The second vertex (in clip space).</param>
+    /// <param name="v2">The third vertex (in clip space).</param>
+    /// <param name="depthBuffer">The depth buffer to test against. Must be the same size as the image.</param>
+    /// <param name="texture">The texture to sample (with FilterMode::Point).</param>
+    /// <param name="addressMode">(optional) The address mode to use when sampling the texture. Default: AddressMode::Wrap</param>
+    /// <param name="cullMode">(optional) The triangles to skip based on their winding order. Default: CullMode::None</param>
+    /// <param name="blendMode">(optional) The blend mode to apply. Default: No blending.</param>
+    void drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image& texture, AddressMode addressMode = AddressMode::Wrap, CullMode cullMode = CullMode::None, const BlendMode& blendMode = {} ) noexcept;
+
 
     /// <summary>
     /// Draw a rectangle to the screen.
@@ -232,7 +372,28 @@ struct SR_API Image final
     /// <param name="image">The texture to use to render the quad.</param>
     /// <param name="addressMode">(optional) The address mode to use when sampling the image. Default: AddressMode::Wrap</param>
     /// <param name="blendMode">(optional) The blending mode to apply. Default: No blending.</param>
-    void drawQuad( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode = AddressMode::Wrap, const BlendMode& blendMode = {} ) noexcept;
+    /// <param name="filterMode">(optional) The filter mode to use when sampling the image. Default: FilterMode::Point</param>
+    void drawQuad( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode = AddressMode::Wrap, const BlendMode& blendMode = {}, FilterMode filterMode = FilterMode::Point ) noexcept;
+
+    /// <summary>
+    /// Draw an indexed list of 2D triangles, for example a mesh or the tiles of a tile map.
+    /// Every vertex is transformed once, no matter how many triangles share it. Triangles that are completely outside
+    /// of the image (or that are culled) are rejected before they are set up. Pixels on an edge that is shared by
+    /// two triangles are only drawn once (the same fill rules as <see cref="drawTriangle"/>).
+    /// The triangles are binned into the tiles they overlap and the tiles are drawn in parallel: in a single pass over the
+    /// tiles in immediate mode, or with the other commands in deferred mode.
+    /// Triangles with an index that is out of range are skipped (as are the remaining indices if the number of indices
+    /// isn't a multiple of three).
+    /// </summary>
+    /// <param name="vertices">The vertices. The texture coordinates are normalized (like the vertices of a textured quad).</param>
+    /// <param name="indices">The indices of the vertices of the triangles (three indices per triangle).</param>
+    /// <param name="texture">(optional) The texture to sample (with FilterMode::Point). The texels are multiplied by the vertex colors.
+    /// If `nullptr`, the triangles are filled with the (interpolated) vertex colors. Default: nullptr</param>
+    /// <param name="blendMode">(optional) The blend mode to apply. Default: No blending.</param>
+    /// <param name="matrix">(optional) The matrix that transforms the vertex positions to image space. Default: Identity</param>
+    /// <param name="addressMode">(optional) The address mode to use when sampling the texture. Default: AddressMode::Wrap</param>
+    /// <param name="cullMode">(optional) The triangles to skip based on their winding order after the transform (see <see cref="CullMode"/>). Default: CullMode::None</param>
+    void drawIndexed( std::span<const Vertex> vertices, std::span<const uint32_t> indices, const Image* texture = nullptr, const BlendMode& blendMode = {}, const glm::mat3& matrix = glm::mat3 { 1.0f }, AddressMode addressMode = AddressMode::Wrap, CullMode cullMode = CullMode::None );
 
     /// <summary>
     /// Draw an axis-aligned bounding box to the image.
@@ -319,9 +480,9 @@ struct SR_API Image final
     /// <param name="x">The x-coordinate to plot.</param>
     /// <param name="y">The y-coordinate to plot.</param>
     /// <param name="src">The source color of the pixel to plot.</param>
-    /// <param name="blendMode">The blend mode to apply.</param>
-    template<bool BoundsCheck = true, bool Blending = true>
-    void plot( uint32_t x, uint32_t y, const Color& src, const BlendMode& blendMode = {} ) noexcept
+    /// <param name="blendMode">The blend mode to apply. This can also be a <see cref="StaticBlendMode"/>.</param>
+    template<bool BoundsCheck = true, bool Blending = true, typename Blend = BlendMode>
+    void plot( uint32_t x, uint32_t y, const Color& src, const Blend& blendMode = {} ) noexcept
     {
         if constexpr ( BoundsCheck )
         {
@@ -334,6 +495,8 @@ struct SR_API Image final
             assert( y < m_height );
         }
 
+        assert( m_Layout == TextureLayout::Linear );
+
         const size_t i = static_cast<size_t>( y ) * m_width + x;
         if constexpr ( Blending )
         {
@@ -389,18 +552,82 @@ struct SR_API Image final
         return sample( uv.x, uv.y, addressMode );
     }
 
-    const Color& operator()( uint32_t x, uint32_t y ) const
+    /// <summary>
+    /// Sample the image with filtering using normalized texture coordinates (in the range from [0..1]).
+    /// </summary>
+    /// <param name="uv">The normalized texture coordinates.</param>
+    /// <param name="filterMode">The filter mode to use during sampling.</param>
+    /// <param name="lod">(optional) The level of detail (the mip level) to sample. Ignored for point sampling. Default: 0.</param>
+    /// <param name="addressMode">(optional) The addressing mode to use during sampling. Default: AddressMode::Wrap</param>
+    /// <returns>The filtered color at the given UV texture coordinates.</returns>
+    Color sample( const glm::vec2& uv, FilterMode filterMode, float lod = 0.0f, AddressMode addressMode = AddressMode::Wrap ) const noexcept;
+
+    /// <summary>
+    /// Get a mip level of the image. Each mip level is half the size of the previous level (rounded down), down to 1x1 pixels.
+    /// Level 0 is the image itself.
+    /// </summary>
+    /// <remarks>
+    /// The mip levels are built the first time they are used. They are not updated when the image changes;
+    /// call <see cref="generateMipmaps"/> to rebuild them.
+    /// </remarks>
+    /// <param name="level">The mip level. Levels past the last level return the last (1x1) level.</param>
+    /// <returns>The mip level.</returns>
+    const Image& getMipLevel( uint32_t level ) const;
+
+    /// <summary>
+    /// Get the number of mip levels of the image (including level 0).
+    /// </summary>
+    /// <returns>The number of mip levels.</returns>
+    uint32_t getNumMipLevels() const noexcept;
+
+    /// <summary>
+    /// (Re)build the mip levels from the current contents of the image.
+    /// Must not be called while the image is being sampled.
+    /// </summary>
+    void generateMipmaps();
+
+    /// <summary>
+    /// Change the order in which the pixels of the image are stored (the pixels are converted in place).
+    /// </summary>
+    /// <remarks>
+    /// TextureLayout::Tiled speeds up rotated and scaled draws that use the image as a texture. A tiled image is read-only:
+    /// it can be sampled and drawn to other images (and copied and saved), but it can't be drawn to, and
+    /// <see cref="data"/>, <see cref="plot"/> and the non-const operator() require the linear layout.
+    /// Convert the image back to TextureLayout::Linear to modify it. The mip levels are converted as well.
+    /// Must not be called while the image is being sampled.
+    /// </remarks>
+    /// <param name="layout">The new layout of the pixels.</param>
+    void setTextureLayout( TextureLayout layout );
+
+    TextureLayout getTextureLayout() const noexcept
+    {
+        return m_Layout;
+    }
+
+    /// <summary>
+    /// Get a texel of the image (in any texture layout).
+    /// </summary>
+    /// <param name="x">The x coordinate of the texel. Must be inside the image.</param>
+    /// <param name="y">The y coordinate of the texel. Must be inside the image.</param>
+    /// <returns>The color of the texel.</returns>
+    const Color& texel( uint32_t x, uint32_t y ) const noexcept
     {
         assert( x < m_width );
         assert( y < m_height );
 
-        return m_data[static_cast<uint64_t>( y ) * m_width + x];
+        return m_data[index( x, y )];
+    }
+
+    const Color& operator()( uint32_t x, uint32_t y ) const
+    {
+        return texel( x, y );
     }
 
     Color& operator()( uint32_t x, uint32_t y )
     {
         assert( x < m_width );
         assert( y < m_height );
+        assert( m_Layout == TextureLayout::Linear );
 
         return m_data[static_cast<uint64_t>( y ) * m_width + x];
     }
@@ -425,29 +652,108 @@ struct SR_API Image final
     }
 
     /// <summary>
-    /// Get a pointer to the pixel buffer.
+    /// Get a pointer to the pixel buffer (the pixels are in row-major order).
+    /// The image must use TextureLayout::Linear.
     /// </summary>
     /// <returns>A pointer to the pixel buffer.</returns>
     Color* data() noexcept
     {
+        assert( m_Layout == TextureLayout::Linear );
         return m_data.get();
     }
 
     /// <summary>
-    /// Get a read-only pointer to the pixel buffer.
+    /// Get a read-only pointer to the pixel buffer (the pixels are in row-major order).
+    /// The image must use TextureLayout::Linear.
     /// </summary>
     /// <returns>A read-only pointer to the pixel buffer.</returns>
     const Color* data() const noexcept
     {
+        assert( m_Layout == TextureLayout::Linear );
         return m_data.get();
     }
 
 private:
+    // Draw functions that only write pixels inside the clip region.
+    // In immediate mode the clip region is the entire image; in deferred mode it is a single tile.
+    void clearImpl( const Color& color, const Math::AABB& clip ) noexcept;
+    void copyImpl( const Image& srcImage, const Math::RectI& srcRect, const Math::RectI& dstRect, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void copyImpl( const Image& srcImage, int x, int y, const Math::AABB& clip ) noexcept;
+    void drawLineImpl( int x0, int y0, int x1, int y1, const Color& color, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void drawTriangleImpl( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const Color& color, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void drawTriangleImpl( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image* texture, AddressMode addressMode, CullMode cullMode, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void drawTriangleImpl( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Image* texture, AddressMode addressMode, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void drawQuadImpl( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode, const BlendMode& blendMode, FilterMode filterMode, const Math::AABB& clip ) noexcept;
+    void drawAABBImpl( Math::AABB aabb, const Color& color, const BlendMode& blendMode, const Math::AABB& clip ) noexcept;
+    void drawSpriteImpl( const Sprite& sprite, const glm::mat3& matrix, const Math::AABB& clip ) noexcept;
+    void drawSpriteImpl( const Sprite& sprite, int x, int y, const Math::AABB& clip ) noexcept;
+    void drawGlyphRunImpl( const GlyphRun& run, int x, int y, const Math::AABB& clip ) noexcept;
+
+    // Execute the commands of a binned command buffer, with the tiles distributed over the threads.
+    void execute( const CommandBuffer& commandBuffer, int64_t tileCost );
+
+    // Draw a 3D triangle (the texture is optional).
+    void drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image* texture, AddressMode addressMode, CullMode cullMode, const BlendMode& blendMode ) noexcept;
+
+    // Draw a string of text that was rendered by a font.
+    void drawGlyphRun( std::shared_ptr<const GlyphRun> run, int x, int y ) noexcept;
+
+    // Record the (conservative) bounds of a draw call if dirty rectangle tracking is enabled.
+    void markDirty( const Math::AABB& bounds ) noexcept;
+
+    // The index of a pixel in the pixel buffer. In the tiled layout: the 4x4 block of the pixel, then the pixel in the block.
+    static size_t index( TextureLayout layout, uint32_t width, uint32_t x, uint32_t y ) noexcept
+    {
+        if ( layout == TextureLayout::Tiled )
+        {
+            const size_t blocksPerRow = ( width + 3u ) / 4u;
+            return ( ( y / 4u ) * blocksPerRow + x / 4u ) * 16u + ( y % 4u ) * 4u + x % 4u;
+        }
+
+        return static_cast<size_t>( y ) * width + x;
+    }
+
+    size_t index( uint32_t x, uint32_t y ) const noexcept
+    {
+        return index( m_Layout, m_width, x, y );
+    }
+
+    // The number of pixels in the pixel buffer (the tiled layout is padded to whole blocks).
+    static size_t getBufferSize( TextureLayout layout, uint32_t width, uint32_t height ) noexcept;
+
+    // Copy a row of pixels (in any layout) to a buffer.
+    void readRow( uint32_t x, uint32_t y, uint32_t count, Color* dst ) const noexcept;
+
+    // Frees the pixels, or releases the owner of pixels that are not owned by the image.
+    struct PixelDeleter
+    {
+        std::shared_ptr<const void> owner;
+
+        void operator()( Color* pixels ) const noexcept
+        {
+            if ( !owner )
+                detail::aligned_free( pixels );
+        }
+    };
+
     uint32_t m_width  = 0u;
     uint32_t m_height = 0u;
     // Axis-aligned bounding box used for screen clipping.
-    Math::AABB                  m_AABB;
-    aligned_unique_ptr<Color[]> m_data;
+    Math::AABB                             m_AABB;
+    std::unique_ptr<Color[], PixelDeleter> m_data;
+    TextureLayout                          m_Layout = TextureLayout::Linear;
+    // Recorded draw commands (only in deferred mode).
+    std::unique_ptr<CommandBuffer> m_CommandBuffer;
+    // The regions that changed since the last reset (for presenting), and the regions
+    // that were drawn to since the last clear (for clearDirty).
+    bool       m_DirtyTracking = false;
+    DirtyRects m_DirtyRects;
+    DirtyRects m_DrawnRects;
+
+    // The mip levels below level 0 (built on first use, and owned by the image).
+    // The chain is published with an atomic pointer, so sampling the mip levels once they are built doesn't take a lock.
+    struct MipChain;
+    mutable std::atomic<MipChain*> m_MipChain { nullptr };
 };
 
 template<typename T>
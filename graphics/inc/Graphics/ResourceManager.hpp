@@ -6,20 +6,76 @@
 #include "SpriteSheet.hpp"
 
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace Graphics
 {
+/// <summary>
+/// Loads and caches images and fonts.
+/// Resources can be loaded from any thread. Resources that are loaded asynchronously are decoded on background
+/// threads. Concurrent requests for the same resource share a single load.
+/// </summary>
 class SR_API ResourceManager final
 {
 public:
+    /// <summary>
+    /// A resource that is (being) loaded. The future holds nullptr (or the exception that was thrown) if loading the
+    /// resource failed.
+    /// </summary>
+    template<typename T>
+    using Future = std::shared_future<std::shared_ptr<T>>;
+
+    /// <summary>
+    /// A function that is invoked on the thread that calls <see cref="update"/> when a resource is loaded.
+    /// The resource is nullptr if loading the resource failed.
+    /// </summary>
+    template<typename T>
+    using Callback = std::function<void( std::shared_ptr<T> )>;
+
+    /// <summary>
+    /// The cache statistics of the resource manager.
+    /// </summary>
+    struct Statistics
+    {
+        uint64_t hits          = 0;  ///< The number of requests for resources that were already loaded (or being loaded).
+        uint64_t misses        = 0;  ///< The number of requests that loaded a resource.
+        uint64_t evictions     = 0;  ///< The number of images that were evicted to stay within the memory budget.
+        size_t   residentBytes = 0;  ///< The size of the loaded images and font files (in bytes).
+        size_t   memoryBudget  = 0;  ///< The memory budget (in bytes), or 0 if there is no budget.
+        size_t   numImages     = 0;
+        size_t   numFonts      = 0;
+    };
+
+    /// <summary>
+    /// The statistics of a loaded image or font file.
+    /// </summary>
+    struct AssetStatistics
+    {
+        std::filesystem::path filePath;
+        size_t                bytes    = 0;    ///< The size of the asset in memory (in bytes).
+        uint64_t              hits     = 0;    ///< The number of requests that found the asset in the cache.
+        double                loadTime = 0.0;  ///< The time it took to load and decode the asset (in seconds).
+    };
+
     /// <summary>
     /// Load an image from a file.
+    /// An image that fails to load is not cached, so loading it again retries.
     /// </summary>
     /// <param name="filePath">The path to the file to load.</param>
-    /// <returns>The loaded image.</returns>
+    /// <returns>The loaded image, or an empty image if the file could not be loaded.</returns>
     static std::shared_ptr<Image> loadImage( const std::filesystem::path& filePath );
 
+    /// <summary>
+    /// Load an image from a file on a background thread.
+    /// </summary>
+    /// <param name="filePath">The path to the file to load.</param>
+    /// <param name="onLoaded">(optional) A function that is invoked by <see cref="update"/> when the image is loaded.</param>
+    /// <returns>The future of the loaded image (nullptr if the file could not be loaded).</returns>
+    static Future<Image> loadImageAsync( const std::filesystem::path& filePath, Callback<Image> onLoaded = {} );
+
     /// <summary>
     /// Load a sprite sheet from a file.
     /// </summary>
@@ -34,16 +90,83 @@ public:
 
     /// <summary>
     /// Load a font from a file.
+    /// The font file is only loaded once. Fonts of different sizes that are loaded from the same file share the
+    /// font file and the glyph atlas.
     /// </summary>
     /// <param name="fontFile">The path to the font to load.</param>
     /// <param name="size">(optional) The size of the font (in pixels). Default: 12</param>
-    /// <param name="firstChar">(optional) The first character in the font texture. Default: ' '.</param>
-    /// <param name="numChars">(optional) The number of characters in the font texture. Default: 96.</param>
+    /// <param name="firstChar">(optional) The first character to rasterize up-front, if the font isn't loaded yet. Default: ' '.</param>
+    /// <param name="numChars">(optional) The number of characters to rasterize up-front, if the font isn't loaded yet. Default: 96.</param>
     /// <returns>A shared pointer to the loaded font.</returns>
     static std::shared_ptr<Font> loadFont( const std::filesystem::path& fontFile, float size = 12.0f, uint32_t firstChar = 32u, uint32_t numChars = 96u );
 
+    /// <summary>
+    /// Load a font from a file on a background thread.
+    /// </summary>
+    /// <param name="fontFile">The path to the font to load.</param>
+    /// <param name="size">(optional) The size of the font (in pixels). Default: 12</param>
+    /// <param name="firstChar">(optional) The first character to rasterize up-front, if the font isn't loaded yet. Default: ' '.</param>
+    /// <param name="numChars">(optional) The number of characters to rasterize up-front, if the font isn't loaded yet. Default: 96.</param>
+    /// <param name="onLoaded">(optional) A function that is invoked by <see cref="update"/> when the font is loaded.</param>
+    /// <returns>The future of the loaded font (nullptr if the font file could not be loaded).</returns>
+    static Future<Font> loadFontAsync( const std::filesystem::path& fontFile, float size = 12.0f, uint32_t firstChar = 32u, uint32_t numChars = 96u, Callback<Font> onLoaded = {} );
+
+    /// <summary>
+    /// Invoke the callbacks of the resources that finished loading, and evict unused images if the
+    /// memory budget is exceeded. This should be called once per frame on the main thread.
+    /// </summary>
+    static void update();
+
+    /// <summary>
+    /// Wait until all of the resources that are loaded asynchronously are loaded.
+    /// </summary>
+    static void waitIdle();
+
+    /// <summary>
+    /// Get the number of resources that are queued or being loaded on the background threads.
+    /// </summary>
+    static size_t getPendingCount();
+
+    /// <summary>
+    /// Set the maximum size of the loaded resources (in bytes).
+    /// When the budget is exceeded, the least recently used images that are not referenced outside of the resource
+    /// manager are evicted. Images that are still in use are never evicted, so the budget can be exceeded temporarily.
+    /// </summary>
+    /// <param name="bytes">The memory budget (in bytes), or 0 to keep all resources loaded (the default).</param>
+    static void setMemoryBudget( size_t bytes );
+
+    static size_t getMemoryBudget();
+
+    /// <summary>
+    /// Set the texture layout that images are converted to when they are loaded (see <see cref="Image::setTextureLayout"/>).
+    /// Images that are loaded asynchronously are converted on the loader threads, so the conversion doesn't stall the first draw.
+    /// Images that are already loaded keep their layout. Use TextureLayout::Tiled for textures that are only drawn
+    /// (they can't be drawn to).
+    /// </summary>
+    /// <param name="layout">The texture layout of loaded images. Default: TextureLayout::Linear.</param>
+    static void setTextureLayout( TextureLayout layout );
+
+    static TextureLayout getTextureLayout();
+
+    /// <summary>
+    /// Evict unused images until the loaded resources fit in the memory budget.
+    /// This is done automatically when an image is loaded and in <see cref="update"/>.
+    /// </summary>
+    static void trim();
+
+    /// <summary>
+    /// Get the cache statistics.
+    /// </summary>
+    static Statistics getStatistics();
+
+    /// <summary>
+    /// Get the statistics of the loaded images and font files.
+    /// </summary>
+    static std::vector<AssetStatistics> getAssetStatistics();
+
     /// <summary>
     /// Unload all resources.
+    /// Resources that are still referenced (or still being loaded) stay alive until they are released.
     /// </summary>
     static void clear();
 
@@ -63,7 +63,37 @@ public:
         return rect;
     }
 
-    std::shared_ptr<Image> getImage() const noexcept
+    /// <summary>
+    /// Get the offset of the sprite in its untrimmed frame.
+    /// Sprites that are packed into an atlas have their transparent borders trimmed. The offset moves the trimmed
+    /// rectangle back to its original position in the frame, so trimmed and untrimmed sprites are drawn at the same position.
+    /// </summary>
+    /// <returns>The offset (in pixels) of the sprite's rectangle in the untrimmed frame.</returns>
+    const glm::ivec2& getOffset() const noexcept
+    {
+        return offset;
+    }
+
+    void setOffset( const glm::ivec2& _offset ) noexcept
+    {
+        offset = _offset;
+    }
+
+    /// <summary>
+    /// Get the pivot of the sprite.
+    /// </summary>
+    /// <returns>The pivot point (in pixels) of the sprite, relative to the top-left corner of the untrimmed frame.</returns>
+    const glm::vec2& getPivot() const noexcept
+    {
+        return pivot;
+    }
+
+    void setPivot( const glm::vec2& _pivot ) noexcept
+    {
+        pivot = _pivot;
+    }
+
+    const std::shared_ptr<Image>& getImage() const noexcept
     {
         return image;
     }
@@ -88,6 +118,20 @@ public:
         blendMode = _blendMode;
     }
 
+    /// <summary>
+    /// Get the filter mode that is used when the sprite is scaled or rotated.
+    /// </summary>
+    /// <returns>The filter mode of the sprite.</returns>
+    FilterMode getFilterMode() const noexcept
+    {
+        return filterMode;
+    }
+
+    void setFilterMode( FilterMode _filterMode ) noexcept
+    {
+        filterMode = _filterMode;
+    }
+
     /// <summary>
     /// Allow for explicit conversion to bool.
     /// </summary>
@@ -104,10 +148,19 @@ private:
     // The source rectangle of this sprite in the image.
     Math::RectI rect;
 
+    // The offset of the source rectangle in the untrimmed frame.
+    glm::ivec2 offset { 0 };
+
+    // The pivot point, relative to the top-left corner of the untrimmed frame.
+    glm::vec2 pivot { 0.0f };
+
     // The color to apply to the sprite.
     Color color { Color::White };
 
     // The blend mode to apply when rendering.
     BlendMode blendMode;
+
+    // The filter mode to apply when the sprite is scaled or rotated.
+    FilterMode filterMode = FilterMode::Point;
 };
 }  // namespace Graphics
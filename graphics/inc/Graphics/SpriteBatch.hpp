@@ -0,0 +1,140 @@
+#pragma once
+
+#include "BlendMode.hpp"
+#include "Color.hpp"
+#include "Config.hpp"
+#include "Enums.hpp"
+
+#include <Math/AABB.hpp>
+#include <Math/Rect.hpp>
+#include <Math/Transform2D.hpp>
+
+#include <glm/mat3x3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+struct Image;
+class Sprite;
+
+/// <summary>
+/// Collects many sprites and draws them in a single pass.
+/// The sprite instances are stored in flat arrays (a structure of arrays), off-screen sprites are culled,
+/// and the remaining sprites are binned into square tiles of the target image. The tiles are rasterized
+/// in parallel, so a batch of thousands of small sprites only starts a single parallel loop instead of one per sprite.
+/// </summary>
+/// <remarks>
+/// The batch only stores a pointer to the image of each sprite. The images must stay alive until the batch is drawn.
+/// </remarks>
+class SR_API SpriteBatch final
+{
+public:
+    /// <summary>
+    /// Create a sprite batch.
+    /// </summary>
+    /// <param name="sortMode">(optional) The order to draw the sprites in. Default: SpriteSortMode::Image.</param>
+    /// <param name="tileSize">(optional) The width and height of a tile (in pixels). Default: 64.</param>
+    explicit SpriteBatch( SpriteSortMode sortMode = SpriteSortMode::Image, uint32_t tileSize = 64u );
+
+    void setSortMode( SpriteSortMode sortMode ) noexcept
+    {
+        m_SortMode = sortMode;
+    }
+
+    SpriteSortMode getSortMode() const noexcept
+    {
+        return m_SortMode;
+    }
+
+    /// <summary>
+    /// Remove all sprites from the batch. The memory of the batch is retained for the next frame.
+    /// </summary>
+    void clear() noexcept;
+
+    /// <summary>
+    /// Reserve memory for a number of sprites.
+    /// </summary>
+    /// <param name="numSprites">The number of sprites to reserve memory for.</param>
+    void reserve( size_t numSprites );
+
+    /// <summary>
+    /// Get the number of sprites in the batch.
+    /// </summary>
+    size_t size() const noexcept
+    {
+        return m_Images.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_Images.empty();
+    }
+
+    /// <summary>
+    /// Add a sprite to the batch using a 3x3 transformation matrix.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="matrix">The matrix to apply to the sprite.</param>
+    void draw( const Sprite& sprite, const glm::mat3& matrix );
+
+    /// <summary>
+    /// Add a sprite to the batch using a 3x3 transformation matrix and a color.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="matrix">The matrix to apply to the sprite.</param>
+    /// <param name="color">The color to apply to the sprite (instead of the color of the sprite).</param>
+    void draw( const Sprite& sprite, const glm::mat3& matrix, const Color& color );
+
+    /// <summary>
+    /// Add a sprite to the batch using the given transform.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="transform">The transform to apply to the sprite.</param>
+    void draw( const Sprite& sprite, const Math::Transform2D& transform )
+    {
+        draw( sprite, transform.getTransform() );
+    }
+
+    /// <summary>
+    /// Add a sprite to the batch using the given transform and color.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="transform">The transform to apply to the sprite.</param>
+    /// <param name="color">The color to apply to the sprite (instead of the color of the sprite).</param>
+    void draw( const Sprite& sprite, const Math::Transform2D& transform, const Color& color )
+    {
+        draw( sprite, transform.getTransform(), color );
+    }
+
+    /// <summary>
+    /// Draw all of the sprites in the batch to an image.
+    /// If the image is in deferred mode, the recorded commands are flushed first, so the sprites are drawn on top of them.
+    /// The sprites are not removed from the batch.
+    /// </summary>
+    /// <param name="image">The image to draw the sprites to.</param>
+    void render( Image& image );
+
+private:
+    void add( const Image* image, const Math::RectI& rect, const glm::mat3& matrix, const Color& color, const BlendMode& blendMode, FilterMode filterMode );
+    void rasterize( Image& image, uint32_t sprite, const Math::AABB& clip ) const noexcept;
+
+    SpriteSortMode m_SortMode;
+    uint32_t       m_TileSize;
+
+    // The sprite instances.
+    std::vector<const Image*> m_Images;
+    std::vector<Math::RectI>  m_Rects;        ///< The source rectangle in the image.
+    std::vector<glm::mat3>    m_InvMatrices;  ///< Maps screen coordinates to sprite coordinates.
+    std::vector<Math::AABB>   m_Bounds;       ///< The screen-space AABB of the sprite.
+    std::vector<Color>        m_Colors;
+    std::vector<BlendMode>    m_BlendModes;
+    std::vector<FilterMode>   m_FilterModes;
+
+    // Scratch memory that is used while rendering.
+    std::vector<uint32_t> m_Order;        ///< The visible sprites in draw order.
+    std::vector<uint32_t> m_TileOffsets;  ///< The first entry of each tile in m_TileSprites (prefix sum of the tile counts).
+    std::vector<uint32_t> m_TileSprites;  ///< The sprites that overlap each tile (in draw order).
+};
+}  // namespace Graphics
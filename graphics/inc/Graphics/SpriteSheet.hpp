@@ -11,6 +11,9 @@
 #include <filesystem>
 #include <optional>
 #include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace Graphics
 {
@@ -167,7 +170,41 @@ public:
     /// <returns></returns>
     static std::shared_ptr<SpriteSheet> fromGrid( const std::filesystem::path& fileName, uint32_t columns, uint32_t rows = 1, uint32_t padding = 0u, uint32_t margin = 0u, const BlendMode& blendMode = {} );
 
+    /// <summary>
+    /// Load a sprite sheet that was packed by the SpritePacker tool.
+    /// The index file (.srsheet) stores the trimmed rectangles, offsets, pivots, and names of the sprites and animations
+    /// and is read in a single read. The atlas pages are texture files (.srtex) that are memory-mapped.
+    /// </summary>
+    /// <remarks>
+    /// The sprites of a packed sprite sheet can be on different pages (images), so the sprite sheet has a single row,
+    /// and <see cref="getSprite"/> should be used to retrieve the sprites.
+    /// </remarks>
+    /// <param name="indexFile">The path to the index file.</param>
+    /// <param name="blendMode">(optional) The blending to apply to the sprites. Default: blending disabled.</param>
+    /// <returns>The sprite sheet, or `nullptr` if the index file or one of the pages could not be loaded.</returns>
+    static std::shared_ptr<SpriteSheet> fromPacked( const std::filesystem::path& indexFile, const BlendMode& blendMode = {} );
+
+    /// <summary>
+    /// Find a sprite by name. Only packed sprite sheets have named sprites.
+    /// </summary>
+    /// <param name="name">The name of the sprite.</param>
+    /// <returns>The index of the sprite, or -1 if there is no sprite with the name.</returns>
+    int findSprite( std::string_view name ) const noexcept;
+
+    /// <summary>
+    /// Get the frames of an animation. Only packed sprite sheets have animations.
+    /// </summary>
+    /// <param name="name">The name of the animation.</param>
+    /// <returns>The sprite indices of the frames of the animation, or an empty span if there is no animation with the name.</returns>
+    std::span<const int> getAnimation( std::string_view name ) const noexcept;
+
 private:
+    struct Animation
+    {
+        std::string      name;
+        std::vector<int> frames;
+    };
+
     // Create a sprite sheet from a pre-loaded sprite image.
     void initSpriteRects();
     void initSprites();
@@ -192,6 +229,12 @@ private:
 
     // The sprites in the sprite sheet.
     std::vector<Sprite> sprites;
+
+    // The names of the sprites (packed sprite sheets only).
+    std::vector<std::string> spriteNames;
+
+    // The animations (packed sprite sheets only).
+    std::vector<Animation> animations;
 };
 
 }  // namespace Graphics
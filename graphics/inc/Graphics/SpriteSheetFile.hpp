@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <Math/Rect.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// Reads and writes the index files (.srsheet) of packed sprite sheets.
+/// The index describes the sprites and animations that were packed into one or more atlas pages (texture files).
+/// Use <see cref="SpriteSheet::fromPacked"/> to load a packed sprite sheet.
+/// </summary>
+/// <remarks>
+/// File layout (little-endian):
+///   * Header (32 bytes): magic "SRSS", version, number of pages, sprites, animations, and frames, size of the string table.
+///   * Pages (4 bytes each): the name of the texture file of the page, relative to the index file.
+///   * Sprites (48 bytes each): name, page, rect (4 x int32), offset (2 x int32), source size (2 x int32), pivot (2 x float).
+///   * Animations (16 bytes each): name, first frame, number of frames.
+///   * Frames (4 bytes each): the sprite index of each animation frame.
+///   * String table: null-terminated strings. Names are stored as offsets into the string table.
+/// </remarks>
+class SR_API SpriteSheetFile final
+{
+public:
+    /// <summary>
+    /// The file extension of index files.
+    /// </summary>
+    static constexpr const char* Extension = ".srsheet";
+
+    /// <summary>
+    /// The version of the file format that is written.
+    /// </summary>
+    static constexpr uint32_t Version = 1u;
+
+    /// <summary>
+    /// A packed sprite.
+    /// </summary>
+    struct Sprite
+    {
+        std::string name;
+        uint32_t    page = 0u;         ///< The index of the page that contains the sprite.
+        Math::RectI rect;              ///< The trimmed rectangle of the sprite in the page.
+        glm::ivec2  offset { 0 };      ///< The offset of the trimmed rectangle in the untrimmed frame.
+        glm::ivec2  sourceSize { 0 };  ///< The size of the untrimmed frame.
+        glm::vec2   pivot { 0.0f };    ///< The pivot point, relative to the top-left corner of the untrimmed frame.
+    };
+
+    /// <summary>
+    /// A named sequence of sprites.
+    /// </summary>
+    struct Animation
+    {
+        std::string      name;
+        std::vector<int> frames;  ///< The sprite indices of the frames.
+    };
+
+    /// <summary>
+    /// The contents of an index file.
+    /// </summary>
+    struct Index
+    {
+        std::vector<std::filesystem::path> pages;  ///< The texture files of the pages, relative to the index file.
+        std::vector<Sprite>                sprites;
+        std::vector<Animation>             animations;
+    };
+
+    /// <summary>
+    /// Write an index file.
+    /// </summary>
+    /// <param name="file">The path of the file to write.</param>
+    /// <param name="index">The pages, sprites, and animations to write.</param>
+    /// <returns>`true` if the file was written.</returns>
+    static bool write( const std::filesystem::path& file, const Index& index );
+
+    /// <summary>
+    /// Read an index file.
+    /// </summary>
+    /// <param name="file">The index file to read.</param>
+    /// <param name="index">Receives the pages, sprites, and animations.</param>
+    /// <returns>`true` if the file is a valid index file.</returns>
+    static bool read( const std::filesystem::path& file, Index& index );
+
+    SpriteSheetFile()                                    = delete;
+    ~SpriteSheetFile()                                   = delete;
+    SpriteSheetFile( const SpriteSheetFile& )            = delete;
+    SpriteSheetFile( SpriteSheetFile&& )                 = delete;
+    SpriteSheetFile& operator=( const SpriteSheetFile& ) = delete;
+    SpriteSheetFile& operator=( SpriteSheetFile&& )      = delete;
+};
+}  // namespace Graphics
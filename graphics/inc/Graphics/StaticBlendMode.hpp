@@ -0,0 +1,110 @@
+#pragma once
+
+#include "BlendMode.hpp"
+#include "Color.hpp"
+
+#include <utility>
+
+namespace Graphics
+{
+
+/// <summary>
+/// A blend mode whose state is known at compile time.
+/// The blend factors and operations are template parameters, so the compiler can fold away
+/// the switch statements of <see cref="BlendMode::Blend"/> (and the multiplications by 0 and 1).
+/// The result is always identical to blending with the equivalent runtime <see cref="BlendMode"/>.
+/// </summary>
+template<bool           BlendEnable,
+         BlendFactor    SrcFactor      = BlendFactor::One,
+         BlendFactor    DstFactor      = BlendFactor::Zero,
+         BlendOperation BlendOp        = BlendOperation::Add,
+         BlendFactor    SrcAlphaFactor = BlendFactor::One,
+         BlendFactor    DstAlphaFactor = BlendFactor::Zero,
+         BlendOperation AlphaOp        = BlendOperation::Add>
+struct StaticBlendMode
+{
+    /// <summary>
+    /// The equivalent runtime blend mode.
+    /// </summary>
+    static constexpr BlendMode value { BlendEnable, SrcFactor, DstFactor, BlendOp, SrcAlphaFactor, DstAlphaFactor, AlphaOp };
+
+    /// <summary>
+    /// Perform blending on the source and destination colors.
+    /// </summary>
+    /// <param name="srcColor">The source color.</param>
+    /// <param name="dstColor">The destination color.</param>
+    /// <returns>The blended color.</returns>
+    static constexpr Color Blend( const Color& srcColor, const Color& dstColor ) noexcept
+    {
+        if constexpr ( !BlendEnable )
+        {
+            return srcColor;
+        }
+        else
+        {
+            const Color   sRGB = applyFactor<SrcFactor>( srcColor, dstColor, srcColor );
+            const Color   dRGB = applyFactor<DstFactor>( srcColor, dstColor, dstColor );
+            const uint8_t sA   = applyFactor<SrcAlphaFactor>( srcColor.a, dstColor.a, srcColor.a );
+            const uint8_t dA   = applyFactor<DstAlphaFactor>( srcColor.a, dstColor.a, dstColor.a );
+
+            const Color   RGB = ComputeBlendOp( sRGB, dRGB, BlendOp );
+            const uint8_t A   = ComputeBlendOp( sA, dA, AlphaOp );
+
+            return { RGB.r, RGB.g, RGB.b, A };
+        }
+    }
+
+private:
+    // Only the RGB channels of the result are used, so the alpha of the zero color doesn't matter.
+    template<BlendFactor Factor>
+    static constexpr Color applyFactor( const Color& srcColor, const Color& dstColor, const Color& color ) noexcept
+    {
+        if constexpr ( Factor == BlendFactor::Zero )
+            return { 0, 0, 0, 0 };
+        else if constexpr ( Factor == BlendFactor::One )
+            return color;
+        else
+            return ComputeBlendFactor( srcColor, dstColor, Factor ) * color;
+    }
+
+    template<BlendFactor Factor>
+    static constexpr uint8_t applyFactor( uint8_t sA, uint8_t dA, uint8_t a ) noexcept
+    {
+        if constexpr ( Factor == BlendFactor::Zero )
+            return 0;
+        else if constexpr ( Factor == BlendFactor::One )
+            return a;
+        else
+            return static_cast<uint8_t>( ComputeBlendFactor( sA, dA, Factor ) * a / 255 );
+    }
+};
+
+using DisableBlendMode     = StaticBlendMode<false>;
+using AlphaBlendMode       = StaticBlendMode<true, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha>;
+using AdditiveBlendMode    = StaticBlendMode<true, BlendFactor::One, BlendFactor::One>;
+using SubtractiveBlendMode = StaticBlendMode<true, BlendFactor::One, BlendFactor::One, BlendOperation::Subtract>;
+
+/// <summary>
+/// Resolve a runtime blend mode to a compile-time blend mode once (for example, once per draw call)
+/// and invoke a function with it. The function is instantiated for each of the common blend modes
+/// (no blending, alpha, additive, and subtractive blending), so the inner loops of the function
+/// are specialized for the blend mode. Any other blend mode is passed to the function as-is.
+/// </summary>
+/// <param name="blendMode">The blend mode to resolve.</param>
+/// <param name="func">A (generic) function that takes the resolved blend mode. The blend mode has a `Blend( src, dst )` function.</param>
+template<typename Func>
+void dispatchBlendMode( const BlendMode& blendMode, Func&& func )
+{
+    if ( !blendMode.blendEnable )
+        std::forward<Func>( func )( DisableBlendMode {} );
+    else if ( blendMode == AlphaBlendMode::value )
+        std::forward<Func>( func )( AlphaBlendMode {} );
+    else if ( blendMode == AdditiveBlendMode::value )
+        std::forward<Func>( func )( AdditiveBlendMode {} );
+    else if ( blendMode == SubtractiveBlendMode::value )
+        std::forward<Func>( func )( SubtractiveBlendMode {} );
+    else
+        std::forward<Func>( func )( blendMode );
+}
+
+}  // namespace Graphics
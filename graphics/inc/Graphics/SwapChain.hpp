@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Image.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Graphics
+{
+class Window;
+
+/// <summary>
+/// A chain of images that are presented to a window on a dedicated present thread.
+/// The application renders into the back buffer while the present thread uploads and presents the previous frames,
+/// so presentation (and waiting for v-sync) doesn't block rasterization of the next frame.
+/// Each presented frame is assigned a fence value (the frame number, starting at 1). The fence is signaled when
+/// the frame has been presented, which can be used to measure and bound the frame latency.
+/// </summary>
+/// <remarks>
+/// While the swap chain exists, the window must only be presented through the swap chain.
+/// The swap chain must be destroyed before the window is destroyed.
+/// </remarks>
+class SR_API SwapChain final
+{
+public:
+    /// <summary>
+    /// The maximum number of buffers in a swap chain.
+    /// </summary>
+    static constexpr uint32_t MaxBuffers = 3u;
+
+    /// <summary>
+    /// Create a swap chain for a window. This must be called on the thread that created the window.
+    /// </summary>
+    /// <param name="window">The window to present to.</param>
+    /// <param name="width">The width of the buffers (in pixels).</param>
+    /// <param name="height">The height of the buffers (in pixels).</param>
+    /// <param name="numBuffers">(optional) The number of buffers (2 for double buffering, or 3 for triple buffering). Default: 2.</param>
+    SwapChain( Window& window, uint32_t width, uint32_t height, uint32_t numBuffers = 2u );
+
+    /// <summary>
+    /// Wait for the queued frames to be presented and stop the present thread.
+    /// </summary>
+    ~SwapChain();
+
+    SwapChain( const SwapChain& )            = delete;
+    SwapChain( SwapChain&& )                 = delete;
+    SwapChain& operator=( const SwapChain& ) = delete;
+    SwapChain& operator=( SwapChain&& )      = delete;
+
+    /// <summary>
+    /// Get the buffer to render the next frame to.
+    /// If the buffer is still queued for presentation, this waits until it has been presented.
+    /// </summary>
+    /// <returns>The back buffer.</returns>
+    Image& getBackBuffer();
+
+    /// <summary>
+    /// Get the index of the current back buffer.
+    /// </summary>
+    uint32_t getBackBufferIndex() const noexcept
+    {
+        return m_BackBuffer;
+    }
+
+    /// <summary>
+    /// Get the number of buffers in the swap chain.
+    /// </summary>
+    uint32_t getNumBuffers() const noexcept
+    {
+        return static_cast<uint32_t>( m_Buffers.size() );
+    }
+
+    uint32_t getWidth() const noexcept
+    {
+        return m_Buffers[0].getWidth();
+    }
+
+    uint32_t getHeight() const noexcept
+    {
+        return m_Buffers[0].getHeight();
+    }
+
+    /// <summary>
+    /// Queue the back buffer for presentation and advance to the next buffer.
+    /// If the image is in deferred mode, the recorded commands are flushed first.
+    /// If the maximum frame latency is reached, this waits until a queued frame has been presented.
+    /// </summary>
+    /// <returns>The fence value that is signaled when the frame has been presented.</returns>
+    uint64_t present();
+
+    /// <summary>
+    /// Get the fence value of the last frame that has been presented.
+    /// </summary>
+    uint64_t getCompletedFence() const noexcept
+    {
+        return m_CompletedFence.load( std::memory_order_acquire );
+    }
+
+    /// <summary>
+    /// Get the fence value of the last frame that was queued for presentation.
+    /// </summary>
+    uint64_t getSubmittedFence() const noexcept
+    {
+        return m_SubmittedFence;
+    }
+
+    /// <summary>
+    /// Get the number of frames that are queued but have not been presented yet.
+    /// </summary>
+    uint32_t getFrameLatency() const noexcept
+    {
+        return static_cast<uint32_t>( m_SubmittedFence - getCompletedFence() );
+    }
+
+    /// <summary>
+    /// Wait until a frame has been presented.
+    /// </summary>
+    /// <param name="fence">The fence value that was returned by <see cref="present"/>.</param>
+    void wait( uint64_t fence );
+
+    /// <summary>
+    /// Wait until all queued frames have been presented.
+    /// </summary>
+    void waitIdle();
+
+    /// <summary>
+    /// Set the maximum number of frames that can be queued for presentation.
+    /// The latency is clamped to [1, number of buffers - 1].
+    /// </summary>
+    /// <param name="maxFrameLatency">The maximum number of queued frames.</param>
+    void setMaxFrameLatency( uint32_t maxFrameLatency ) noexcept;
+
+    uint32_t getMaxFrameLatency() const noexcept
+    {
+        return m_MaxFrameLatency;
+    }
+
+    /// <summary>
+    /// Get the time (in seconds) the present thread spent presenting the last frame (including waiting for v-sync).
+    /// </summary>
+    double getPresentTime() const noexcept
+    {
+        return m_PresentTime.load( std::memory_order_relaxed );
+    }
+
+    /// <summary>
+    /// Enable or disable v-sync. The setting is applied by the present thread before the next frame is presented.
+    /// </summary>
+    /// <param name="enabled">`true` to enable v-sync, or `false` to disable it.</param>
+    void setVSync( bool enabled ) noexcept;
+
+    bool isVSync() const noexcept
+    {
+        return m_VSync.load( std::memory_order_relaxed );
+    }
+
+    void toggleVSync() noexcept
+    {
+        setVSync( !isVSync() );
+    }
+
+    /// <summary>
+    /// Resize all of the buffers. This waits until all queued frames have been presented.
+    /// </summary>
+    /// <param name="width">The new width of the buffers (in pixels).</param>
+    /// <param name="height">The new height of the buffers (in pixels).</param>
+    void resize( uint32_t width, uint32_t height );
+
+private:
+    void presentThread();
+
+    Window&            m_Window;
+    std::vector<Image> m_Buffers;
+    uint32_t           m_BackBuffer      = 0u;
+    uint32_t           m_MaxFrameLatency = 1u;
+    uint64_t           m_SubmittedFence  = 0u;
+
+    std::vector<uint64_t> m_BufferFences;  ///< The fence value of the last frame that was presented from each buffer.
+    std::queue<uint32_t>  m_Queue;         ///< The buffers that are queued for presentation (in order).
+
+    std::atomic<uint64_t> m_CompletedFence = 0u;
+    std::atomic<double>   m_PresentTime    = 0.0;
+    std::atomic<bool>     m_VSync;
+    bool                  m_VSyncChanged = false;
+    bool                  m_Stop         = false;
+
+    std::mutex              m_Mutex;
+    std::condition_variable m_QueueCV;      ///< Signaled when a frame is queued (or the thread is stopped).
+    std::condition_variable m_CompletedCV;  ///< Signaled when a frame has been presented.
+    std::thread             m_Thread;
+};
+}  // namespace Graphics
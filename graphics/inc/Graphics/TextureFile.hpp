@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Image.hpp"
+
+#include <Math/Rect.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// Reads and writes texture files (.srtex).
+/// A texture file stores the pixels of an image in the memory layout of <see cref="Color"/>, so loading a texture
+/// doesn't decode or convert anything: the file is memory-mapped, and the image references the pixels in the mapping.
+/// The mapping is copy-on-write, so drawing to a loaded texture never modifies the file.
+/// A texture file can also store a table of rectangles (for example, the sprites of a sprite sheet).
+/// </summary>
+/// <remarks>
+/// File layout (little-endian):
+///   * Header (64 bytes): magic "SRTX", version, width, height, pixel offset, rect offset, number of rects.
+///   * Pixels (at the pixel offset, aligned to 64 bytes): width * height colors, row by row.
+///   * Rects (at the rect offset): left, top, width, height (4 x int32) per rect.
+/// </remarks>
+class SR_API TextureFile final
+{
+public:
+    /// <summary>
+    /// The file extension of texture files.
+    /// </summary>
+    static constexpr const char* Extension = ".srtex";
+
+    /// <summary>
+    /// The version of the file format that is written.
+    /// </summary>
+    static constexpr uint32_t Version = 1u;
+
+    /// <summary>
+    /// Write an image to a texture file.
+    /// </summary>
+    /// <param name="file">The path of the file to write.</param>
+    /// <param name="image">The image to write.</param>
+    /// <param name="rects">(optional) The rectangles to store in the file.</param>
+    /// <returns>`true` if the file was written.</returns>
+    static bool write( const std::filesystem::path& file, const Image& image, std::span<const Math::RectI> rects = {} );
+
+    /// <summary>
+    /// Load a texture file. The file is memory-mapped, and the image references the pixels in the file.
+    /// </summary>
+    /// <param name="file">The texture file to load.</param>
+    /// <param name="rects">(optional) Receives the rectangles that are stored in the file.</param>
+    /// <returns>The loaded image, or an empty image if the file is not a valid texture file.</returns>
+    static Image load( const std::filesystem::path& file, std::vector<Math::RectI>* rects = nullptr );
+
+    TextureFile()                                = delete;
+    ~TextureFile()                               = delete;
+    TextureFile( const TextureFile& )            = delete;
+    TextureFile( TextureFile&& )                 = delete;
+    TextureFile& operator=( const TextureFile& ) = delete;
+    TextureFile& operator=( TextureFile&& )      = delete;
+};
+}  // namespace Graphics
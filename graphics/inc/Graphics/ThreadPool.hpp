@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A persistent pool of worker threads that is used to parallelize the image kernels.
+/// The iterations of a parallel loop are distributed over the threads and idle threads
+/// steal work from busy threads, so that the work is balanced even if the cost of the
+/// iterations is not uniform.
+/// </summary>
+class SR_API ThreadPool
+{
+public:
+    /// <summary>
+    /// The default inline threshold (roughly, the number of pixels that are written).
+    /// </summary>
+    static constexpr int64_t DefaultInlineThreshold = 16 * 1024;
+
+    /// <summary>
+    /// Get the global thread pool that is used by the images.
+    /// The number of threads defaults to the number of hardware threads and can be
+    /// overridden with the SR_NUM_THREADS environment variable.
+    /// </summary>
+    /// <returns>The global thread pool.</returns>
+    static ThreadPool& get();
+
+    /// <summary>
+    /// Create a thread pool.
+    /// </summary>
+    /// <param name="numThreads">The number of threads that execute parallel loops (including
+    /// the calling thread). If 0, the number of hardware threads is used.</param>
+    explicit ThreadPool( uint32_t numThreads = 0 );
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& )            = delete;
+    ThreadPool( ThreadPool&& )                 = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+    ThreadPool& operator=( ThreadPool&& )      = delete;
+
+    /// <summary>
+    /// Set the number of threads that execute parallel loops (including the calling thread).
+    /// This must not be called from inside a parallel loop.
+    /// </summary>
+    /// <param name="numThreads">The number of threads. If 0, the number of hardware threads is used.
+    /// Use 1 to execute all loops on the calling thread.</param>
+    void setNumThreads( uint32_t numThreads );
+
+    /// <summary>
+    /// Get the number of threads that execute parallel loops (including the calling thread).
+    /// </summary>
+    uint32_t getNumThreads() const noexcept
+    {
+        return static_cast<uint32_t>( m_Workers.size() ) + 1u;
+    }
+
+    /// <summary>
+    /// Pin each worker thread to a single hardware thread.
+    /// This reduces the migration of threads between cores (and the cache misses that go with it),
+    /// but it should only be used if the application has the machine to itself.
+    /// </summary>
+    /// <param name="pinThreads">`true` to pin the worker threads, `false` to let the OS schedule them.</param>
+    void setAffinity( bool pinThreads );
+
+    /// <summary>
+    /// Check if the worker threads are pinned to hardware threads.
+    /// </summary>
+    bool getAffinity() const noexcept
+    {
+        return m_PinThreads;
+    }
+
+    /// <summary>
+    /// Set the total cost of a loop below which the loop is executed on the calling thread.
+    /// Waking the worker threads is more expensive than the work for small primitives.
+    /// </summary>
+    /// <param name="cost">The inline threshold (in the same unit as the cost of the loop iterations).</param>
+    void setInlineThreshold( int64_t cost ) noexcept
+    {
+        m_InlineThreshold = std::max<int64_t>( cost, 0 );
+    }
+
+    /// <summary>
+    /// Get the total cost of a loop below which the loop is executed on the calling thread.
+    /// </summary>
+    int64_t getInlineThreshold() const noexcept
+    {
+        return m_InlineThreshold;
+    }
+
+    /// <summary>
+    /// Execute `func( first, last )` for sub-ranges of [begin, end) in parallel and wait for completion.
+    /// Loops that are started from inside a parallel loop are executed on the calling thread.
+    /// </summary>
+    /// <param name="begin">The first iteration.</param>
+    /// <param name="end">One past the last iteration.</param>
+    /// <param name="func">The function to invoke for each sub-range. The function must not throw.</param>
+    /// <param name="costPerItem">The (estimated) cost of a single iteration (for example, the number of pixels in a row).</param>
+    template<typename Func>
+    void parallelFor( int begin, int end, Func&& func, int64_t costPerItem = 1 )
+    {
+        if ( begin >= end )
+            return;
+
+        const int64_t cost = static_cast<int64_t>( end - begin ) * std::max<int64_t>( costPerItem, 1 );
+
+        if ( cost <= m_InlineThreshold || m_Workers.empty() )
+        {
+            func( begin, end );
+            return;
+        }
+
+        // Make the chunks large enough to amortize the cost of taking them.
+        const int grainSize = static_cast<int>( std::clamp<int64_t>( m_InlineThreshold / 8 / std::max<int64_t>( costPerItem, 1 ), 1, end - begin ) );
+
+        using F = std::remove_reference_t<Func>;
+        run( begin, end, grainSize, []( void* f, int first, int last ) { ( *static_cast<F*>( f ) )( first, last ); }, const_cast<void*>( static_cast<const void*>( std::addressof( func ) ) ) );
+    }
+
+private:
+    struct Job;
+    struct Range;
+
+    using Invoke = void ( * )( void* func, int first, int last );
+
+    void run( int begin, int end, int grainSize, Invoke invoke, void* func );
+    void execute( Job& job, uint32_t participant );
+    void workerMain( uint32_t index );
+    void start( uint32_t numThreads );
+    void stop();
+
+    std::vector<std::thread> m_Workers;
+    std::unique_ptr<Range[]> m_Ranges;  ///< The range of iterations owned by each participant of a job.
+
+    std::mutex              m_JobMutex;  ///< Only one loop is distributed over the threads at a time.
+    std::mutex              m_Mutex;
+    std::condition_variable m_WorkCV;
+    std::condition_variable m_DoneCV;
+    Job*                    m_Job        = nullptr;
+    uint64_t                m_Generation = 0;
+    bool                    m_Stop       = false;
+
+    bool    m_PinThreads      = false;
+    int64_t m_InlineThreshold = DefaultInlineThreshold;
+};
+}  // namespace Graphics
@@ -49,6 +49,15 @@ public:
     /// <returns>`true` if an event was popped from the event queue, or `false` if there are no events in the queue.</returns>
     bool popEvent( Event& event );
 
+    /// <summary>
+    /// Push an event to the window's event queue.
+    /// This can be called from any thread (for example, to inject synthetic events from an input or replay thread).
+    /// The events are returned by <see cref="popEvent"/> in the order they were pushed.
+    /// </summary>
+    /// <param name="event">The event to push.</param>
+    /// <returns>`true` if the event was pushed, or `false` if the event queue is full.</returns>
+    bool pushEvent( const Event& event );
+
     /// <summary>
     /// Show the window.
     /// </summary>
@@ -100,6 +109,13 @@ public:
     /// <param name="image">The image to present.</param>
     void present( const Image& image );
 
+    /// <summary>
+    /// Release the presentation context of the window (the OpenGL context) from the calling thread,
+    /// so that the window can be presented from another thread. The context is acquired again
+    /// by the next thread that uses the window. <see cref="SwapChain"/> does this automatically.
+    /// </summary>
+    void releaseContext();
+
     /// <summary>
     /// Destroy the window.
     /// Note: This deletes the pointer to the window implementation and it
@@ -19,7 +19,9 @@ public:
     virtual bool         isVSync() const noexcept         = 0;
     virtual void         clear( const Color& color )      = 0;
     virtual void         present( const Image& image )    = 0;
+    virtual void         releaseContext()                 = 0;
     virtual bool         popEvent( Event& event )         = 0;
+    virtual bool         pushEvent( const Event& event )  = 0;
     virtual int          getWidth() const noexcept        = 0;
     virtual int          getHeight() const noexcept       = 0;
     virtual glm::ivec2   getSize() const noexcept         = 0;
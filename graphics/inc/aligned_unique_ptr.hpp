@@ -1,14 +1,37 @@
 #pragma once
 
+#include <cstdlib>
 #include <memory>
 
+namespace detail
+{
+inline void* aligned_malloc( std::size_t size, std::size_t align )
+{
+#if defined( _WIN32 )
+    return _aligned_malloc( size, align );
+#else
+    // std::aligned_alloc requires the size to be a multiple of the alignment.
+    return std::aligned_alloc( align, ( size + align - 1 ) / align * align );
+#endif
+}
+
+inline void aligned_free( void* ptr )
+{
+#if defined( _WIN32 )
+    _aligned_free( ptr );
+#else
+    std::free( ptr );
+#endif
+}
+}  // namespace detail
+
 struct aligned_deleter
 {
     void operator()( void* ptr ) const
     {
         // Note: this doesn't destruct array elements.
         // TODO: specialize aligned_deleter for array types?
-        _aligned_free( ptr );
+        detail::aligned_free( ptr );
     }
 };
 
@@ -34,7 +57,7 @@ template<typename T, std::size_t Align, typename... Args>
 std::enable_if_t<!std::is_array_v<T>, aligned_unique_ptr<T>>
     make_aligned_unique( Args&&... args )
 {
-    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T*>( _aligned_malloc( sizeof( T ), Align ) ), aligned_deleter() );
+    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T*>( detail::aligned_malloc( sizeof( T ), Align ) ), aligned_deleter() );
     new ( ptr.get() ) T( std::forward<Args>( args )... );
     return ptr;
 }
@@ -44,7 +67,7 @@ std::enable_if_t<detail::is_unbounded_array_v<T> && std::is_default_constructibl
     make_aligned_unique( std::size_t n )
 {
     using T2                  = std::remove_extent_t<T>;
-    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T2*>( _aligned_malloc( sizeof( T2 ) * n, Align ) ), aligned_deleter() );
+    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T2*>( detail::aligned_malloc( sizeof( T2 ) * n, Align ) ), aligned_deleter() );
 
     // Default construct the elements.
     T2* p = ptr.get();
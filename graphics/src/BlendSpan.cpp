@@ -0,0 +1,383 @@
+#include "BlendSpan.hpp"
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+    #define SR_SIMD_X64
+    #include <immintrin.h>
+    #if defined( _MSC_VER ) && !defined( __clang__ )
+        #include <intrin.h>
+        #define SR_TARGET_AVX2
+    #else
+        #define SR_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+    #endif
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace Graphics;
+
+/// <summary>
+/// The blend modes that have a dedicated kernel.
+/// </summary>
+enum class BlendKernel
+{
+    Copy,         ///< Blending is disabled.
+    Alpha,        ///< BlendMode::AlphaBlend
+    Additive,     ///< BlendMode::AdditiveBlend
+    Subtractive,  ///< BlendMode::SubtractiveBlend
+    Generic,      ///< Any other blend mode (uses BlendMode::Blend).
+};
+
+static BlendKernel selectKernel( const BlendMode& blendMode ) noexcept
+{
+    if ( !blendMode.blendEnable )
+        return BlendKernel::Copy;
+    if ( blendMode == BlendMode::AlphaBlend )
+        return BlendKernel::Alpha;
+    if ( blendMode == BlendMode::AdditiveBlend )
+        return BlendKernel::Additive;
+    if ( blendMode == BlendMode::SubtractiveBlend )
+        return BlendKernel::Subtractive;
+
+    return BlendKernel::Generic;
+}
+
+// Exact floor( x / 255 ) for 0 <= x <= 255 * 255.
+static constexpr uint32_t div255( uint32_t x ) noexcept
+{
+    return ( x + 1 + ( x >> 8 ) ) >> 8;
+}
+
+template<BlendKernel Kernel>
+static Color blendPixel( const Color& s, const Color& d, const BlendMode& blendMode ) noexcept
+{
+    if constexpr ( Kernel == BlendKernel::Copy )
+    {
+        return s;
+    }
+    else if constexpr ( Kernel == BlendKernel::Alpha )
+    {
+        const uint32_t sa = s.a;
+        const uint32_t da = 255u - sa;
+
+        return {
+            static_cast<uint8_t>( std::min( div255( s.r * sa ) + div255( d.r * da ), 255u ) ),
+            static_cast<uint8_t>( std::min( div255( s.g * sa ) + div255( d.g * da ), 255u ) ),
+            static_cast<uint8_t>( std::min( div255( s.b * sa ) + div255( d.b * da ), 255u ) ),
+            s.a
+        };
+    }
+    else if constexpr ( Kernel == BlendKernel::Additive )
+    {
+        return ( s + d ).withAlpha( s.a );
+    }
+    else if constexpr ( Kernel == BlendKernel::Subtractive )
+    {
+        return ( s - d ).withAlpha( s.a );
+    }
+    else
+    {
+        return blendMode.Blend( s, d );
+    }
+}
+
+using SpanFunc = void ( * )( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept;
+
+struct Scalar
+{
+    template<BlendKernel Kernel, bool Tinted, bool Solid>
+    static void span( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept
+    {
+        for ( int i = 0; i < count; ++i )
+        {
+            Color s = src[Solid ? 0 : i];
+
+            if constexpr ( Tinted )
+                s *= tint;
+
+            dst[i] = blendPixel<Kernel>( s, dst[i], blendMode );
+        }
+    }
+};
+
+#if defined( SR_SIMD_X64 )
+
+// SSE2 is part of the x86-64 baseline, so the 128-bit kernels don't need a runtime check.
+struct SSE2
+{
+    // Exact floor( x / 255 ) for each 16-bit lane.
+    static __m128i div255( __m128i x ) noexcept
+    {
+        return _mm_srli_epi16( _mm_mulhi_epu16( x, _mm_set1_epi16( static_cast<short>( 0x8081 ) ) ), 7 );
+    }
+
+    // Same as Color::operator* for 4 pixels.
+    static __m128i mul( __m128i a, __m128i b ) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo   = div255( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) ) );
+        const __m128i hi   = div255( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) ) );
+
+        return _mm_packus_epi16( lo, hi );
+    }
+
+    // Replace the alpha channel of the blended color with the source alpha.
+    static __m128i withAlpha( __m128i rgb, __m128i s ) noexcept
+    {
+        const __m128i alphaMask = _mm_set1_epi32( static_cast<int>( 0xFF000000 ) );
+        return _mm_or_si128( _mm_andnot_si128( alphaMask, rgb ), _mm_and_si128( alphaMask, s ) );
+    }
+
+    template<BlendKernel Kernel>
+    static __m128i blend( __m128i s, __m128i d ) noexcept
+    {
+        if constexpr ( Kernel == BlendKernel::Copy )
+        {
+            return s;
+        }
+        else if constexpr ( Kernel == BlendKernel::Alpha )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i c255 = _mm_set1_epi16( 255 );
+
+            const __m128i sLo = _mm_unpacklo_epi8( s, zero );
+            const __m128i sHi = _mm_unpackhi_epi8( s, zero );
+            const __m128i dLo = _mm_unpacklo_epi8( d, zero );
+            const __m128i dHi = _mm_unpackhi_epi8( d, zero );
+
+            // Broadcast the source alpha to all channels of each pixel.
+            const __m128i aLo = _mm_shufflehi_epi16( _mm_shufflelo_epi16( sLo, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            const __m128i aHi = _mm_shufflehi_epi16( _mm_shufflelo_epi16( sHi, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+            const __m128i lo = _mm_adds_epu16( div255( _mm_mullo_epi16( sLo, aLo ) ), div255( _mm_mullo_epi16( dLo, _mm_sub_epi16( c255, aLo ) ) ) );
+            const __m128i hi = _mm_adds_epu16( div255( _mm_mullo_epi16( sHi, aHi ) ), div255( _mm_mullo_epi16( dHi, _mm_sub_epi16( c255, aHi ) ) ) );
+
+            return withAlpha( _mm_packus_epi16( lo, hi ), s );
+        }
+        else if constexpr ( Kernel == BlendKernel::Additive )
+        {
+            return withAlpha( _mm_adds_epu8( s, d ), s );
+        }
+        else if constexpr ( Kernel == BlendKernel::Subtractive )
+        {
+            return withAlpha( _mm_subs_epu8( s, d ), s );
+        }
+    }
+
+    template<BlendKernel Kernel, bool Tinted, bool Solid>
+    static void span( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept
+    {
+        const __m128i t = _mm_set1_epi32( static_cast<int>( tint.argb ) );
+        const __m128i c = _mm_set1_epi32( static_cast<int>( Tinted ? ( src[0] * tint ).argb : src[0].argb ) );
+
+        int i = 0;
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            __m128i s = c;
+
+            if constexpr ( !Solid )
+            {
+                s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+
+                if constexpr ( Tinted )
+                    s = mul( s, t );
+            }
+
+            __m128i* d = reinterpret_cast<__m128i*>( dst + i );
+            _mm_storeu_si128( d, blend<Kernel>( s, _mm_loadu_si128( d ) ) );
+        }
+
+        Scalar::span<Kernel, Tinted, Solid>( dst + i, Solid ? src : src + i, count - i, tint, blendMode );
+    }
+};
+
+struct AVX2
+{
+    SR_TARGET_AVX2 static __m256i div255( __m256i x ) noexcept
+    {
+        return _mm256_srli_epi16( _mm256_mulhi_epu16( x, _mm256_set1_epi16( static_cast<short>( 0x8081 ) ) ), 7 );
+    }
+
+    SR_TARGET_AVX2 static __m256i mul( __m256i a, __m256i b ) noexcept
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i lo   = div255( _mm256_mullo_epi16( _mm256_unpacklo_epi8( a, zero ), _mm256_unpacklo_epi8( b, zero ) ) );
+        const __m256i hi   = div255( _mm256_mullo_epi16( _mm256_unpackhi_epi8( a, zero ), _mm256_unpackhi_epi8( b, zero ) ) );
+
+        return _mm256_packus_epi16( lo, hi );
+    }
+
+    SR_TARGET_AVX2 static __m256i withAlpha( __m256i rgb, __m256i s ) noexcept
+    {
+        const __m256i alphaMask = _mm256_set1_epi32( static_cast<int>( 0xFF000000 ) );
+        return _mm256_blendv_epi8( rgb, s, alphaMask );
+    }
+
+    template<BlendKernel Kernel>
+    SR_TARGET_AVX2 static __m256i blend( __m256i s, __m256i d ) noexcept
+    {
+        if constexpr ( Kernel == BlendKernel::Copy )
+        {
+            return s;
+        }
+        else if constexpr ( Kernel == BlendKernel::Alpha )
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i c255 = _mm256_set1_epi16( 255 );
+
+            // Unpacking and packing both work on 128-bit lanes, so the pixel order is preserved.
+            const __m256i sLo = _mm256_unpacklo_epi8( s, zero );
+            const __m256i sHi = _mm256_unpackhi_epi8( s, zero );
+            const __m256i dLo = _mm256_unpacklo_epi8( d, zero );
+            const __m256i dHi = _mm256_unpackhi_epi8( d, zero );
+
+            const __m256i aLo = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( sLo, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            const __m256i aHi = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( sHi, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+            const __m256i lo = _mm256_adds_epu16( div255( _mm256_mullo_epi16( sLo, aLo ) ), div255( _mm256_mullo_epi16( dLo, _mm256_sub_epi16( c255, aLo ) ) ) );
+            const __m256i hi = _mm256_adds_epu16( div255( _mm256_mullo_epi16( sHi, aHi ) ), div255( _mm256_mullo_epi16( dHi, _mm256_sub_epi16( c255, aHi ) ) ) );
+
+            return withAlpha( _mm256_packus_epi16( lo, hi ), s );
+        }
+        else if constexpr ( Kernel == BlendKernel::Additive )
+        {
+            return withAlpha( _mm256_adds_epu8( s, d ), s );
+        }
+        else if constexpr ( Kernel == BlendKernel::Subtractive )
+        {
+            return withAlpha( _mm256_subs_epu8( s, d ), s );
+        }
+    }
+
+    template<BlendKernel Kernel, bool Tinted, bool Solid>
+    SR_TARGET_AVX2 static void span( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept
+    {
+        const __m256i t = _mm256_set1_epi32( static_cast<int>( tint.argb ) );
+        const __m256i c = _mm256_set1_epi32( static_cast<int>( Tinted ? ( src[0] * tint ).argb : src[0].argb ) );
+
+        int i = 0;
+        for ( ; i + 8 <= count; i += 8 )
+        {
+            __m256i s = c;
+
+            if constexpr ( !Solid )
+            {
+                s = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + i ) );
+
+                if constexpr ( Tinted )
+                    s = mul( s, t );
+            }
+
+            __m256i* d = reinterpret_cast<__m256i*>( dst + i );
+            _mm256_storeu_si256( d, blend<Kernel>( s, _mm256_loadu_si256( d ) ) );
+        }
+
+        // Finish the span with the 128-bit kernel.
+        SSE2::span<Kernel, Tinted, Solid>( dst + i, Solid ? src : src + i, count - i, tint, blendMode );
+    }
+};
+
+static bool hasAVX2() noexcept
+{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+    int info[4];
+    __cpuid( info, 0 );
+    if ( info[0] < 7 )
+        return false;
+
+    // Check that the CPU supports AVX and the OS saves the YMM registers.
+    __cpuid( info, 1 );
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool avx     = ( info[2] & ( 1 << 28 ) ) != 0;
+    if ( !osxsave || !avx || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+        return false;
+
+    __cpuidex( info, 7, 0 );
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+
+#endif
+
+template<typename ISA, bool Tinted, bool Solid>
+static SpanFunc getSpanFunc( BlendKernel kernel ) noexcept
+{
+    switch ( kernel )
+    {
+    case BlendKernel::Copy:
+        return &ISA::template span<BlendKernel::Copy, Tinted, Solid>;
+    case BlendKernel::Alpha:
+        return &ISA::template span<BlendKernel::Alpha, Tinted, Solid>;
+    case BlendKernel::Additive:
+        return &ISA::template span<BlendKernel::Additive, Tinted, Solid>;
+    case BlendKernel::Subtractive:
+        return &ISA::template span<BlendKernel::Subtractive, Tinted, Solid>;
+    case BlendKernel::Generic:
+        break;
+    }
+
+    return &Scalar::span<BlendKernel::Generic, Tinted, Solid>;
+}
+
+template<bool Tinted, bool Solid>
+static SpanFunc selectSpan( BlendKernel kernel ) noexcept
+{
+#if defined( SR_SIMD_X64 )
+    static const bool avx2 = hasAVX2();
+
+    if ( avx2 )
+        return getSpanFunc<AVX2, Tinted, Solid>( kernel );
+
+    return getSpanFunc<SSE2, Tinted, Solid>( kernel );
+#else
+    return getSpanFunc<Scalar, Tinted, Solid>( kernel );
+#endif
+}
+
+void Graphics::blendSpan( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept
+{
+    if ( count <= 0 )
+        return;
+
+    const BlendKernel kernel = selectKernel( blendMode );
+
+    // Multiplying by white doesn't change the source color.
+    if ( tint == Color::White )
+        selectSpan<false, false>( kernel )( dst, src, count, tint, blendMode );
+    else
+        selectSpan<true, false>( kernel )( dst, src, count, tint, blendMode );
+}
+
+void Graphics::fillSpan( Color* dst, int count, const Color& color, const BlendMode& blendMode ) noexcept
+{
+    if ( count <= 0 )
+        return;
+
+    selectSpan<false, true>( selectKernel( blendMode ) )( dst, &color, count, Color::White, blendMode );
+}
+
+void Graphics::streamFillSpan( Color* dst, size_t count, const Color& color ) noexcept
+{
+#if defined( SR_SIMD_X64 )
+    // Fill the pixels up to the first 16-byte boundary.
+    while ( count > 0 && reinterpret_cast<uintptr_t>( dst ) % 16 != 0 )
+    {
+        *dst++ = color;
+        --count;
+    }
+
+    const __m128i c = _mm_set1_epi32( static_cast<int>( color.argb ) );
+
+    for ( ; count >= 4; count -= 4, dst += 4 )
+        _mm_stream_si128( reinterpret_cast<__m128i*>( dst ), c );
+
+    std::fill_n( dst, count, color );
+
+    // Streaming stores are weakly ordered. Make them visible before other threads read the pixels.
+    _mm_sfence();
+#else
+    std::fill_n( dst, count, color );
+#endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Graphics/BlendMode.hpp>
+#include <Graphics/Color.hpp>
+
+#include <cstddef>
+
+namespace Graphics
+{
+/// <summary>
+/// Blend a span of source pixels into a span of destination pixels.
+/// The common blend modes (no blending, alpha, additive, and subtractive blending) use SIMD kernels
+/// that are selected at runtime based on the features of the CPU. The results are identical
+/// to calling <see cref="BlendMode::Blend"/> for each pixel.
+/// </summary>
+/// <param name="dst">The destination pixels.</param>
+/// <param name="src">The source pixels.</param>
+/// <param name="count">The number of pixels to blend.</param>
+/// <param name="tint">The color to multiply the source pixels with before blending.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+void blendSpan( Color* dst, const Color* src, int count, const Color& tint, const BlendMode& blendMode ) noexcept;
+
+/// <summary>
+/// Blend a single color into a span of destination pixels.
+/// </summary>
+/// <param name="dst">The destination pixels.</param>
+/// <param name="count">The number of pixels to blend.</param>
+/// <param name="color">The source color.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+void fillSpan( Color* dst, int count, const Color& color, const BlendMode& blendMode ) noexcept;
+
+/// <summary>
+/// Fill a span of pixels with a color using non-temporal (streaming) stores.
+/// Streaming stores bypass the cache, so filling a large region doesn't evict other data from the cache
+/// (and the destination doesn't have to be read into the cache before it is overwritten).
+/// Only use this for regions that are much larger than the cache.
+/// </summary>
+/// <param name="dst">The destination pixels.</param>
+/// <param name="count">The number of pixels to fill.</param>
+/// <param name="color">The color to fill the pixels with.</param>
+void streamFillSpan( Color* dst, size_t count, const Color& color ) noexcept;
+
+}  // namespace Graphics
@@ -0,0 +1,74 @@
+#include "CommandBuffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace Graphics;
+using namespace Math;
+
+CommandBuffer::CommandBuffer( uint32_t tileSize )
+: m_TileSize { std::max( tileSize, 1u ) }
+{}
+
+void CommandBuffer::push( Command&& command, const AABB& bounds )
+{
+    m_Commands.emplace_back( std::move( command ) );
+    m_Bounds.emplace_back( bounds );
+}
+
+void CommandBuffer::bin( uint32_t width, uint32_t height )
+{
+    m_Width  = width;
+    m_Height = height;
+    m_TilesX = ( width + m_TileSize - 1 ) / m_TileSize;
+    m_TilesY = ( height + m_TileSize - 1 ) / m_TileSize;
+
+    // Reuse the bins from the previous frame to avoid reallocating them.
+    m_Bins.resize( static_cast<size_t>( m_TilesX ) * m_TilesY );
+    for ( auto& bin: m_Bins )
+        bin.clear();
+
+    if ( m_TilesX == 0 || m_TilesY == 0 )
+        return;
+
+    const float maxX = static_cast<float>( width - 1 );
+    const float maxY = static_cast<float>( height - 1 );
+
+    for ( uint32_t i = 0; i < static_cast<uint32_t>( m_Commands.size() ); ++i )
+    {
+        const AABB& b = m_Bounds[i];
+
+        // Cull commands that are completely off-screen.
+        if ( b.max.x < 0.0f || b.max.y < 0.0f || b.min.x > maxX || b.min.y > maxY )
+            continue;
+
+        const uint32_t tx0 = static_cast<uint32_t>( std::clamp( b.min.x, 0.0f, maxX ) ) / m_TileSize;
+        const uint32_t ty0 = static_cast<uint32_t>( std::clamp( b.min.y, 0.0f, maxY ) ) / m_TileSize;
+        const uint32_t tx1 = static_cast<uint32_t>( std::clamp( b.max.x, 0.0f, maxX ) ) / m_TileSize;
+        const uint32_t ty1 = static_cast<uint32_t>( std::clamp( b.max.y, 0.0f, maxY ) ) / m_TileSize;
+
+        for ( uint32_t ty = ty0; ty <= ty1; ++ty )
+        {
+            for ( uint32_t tx = tx0; tx <= tx1; ++tx )
+            {
+                m_Bins[static_cast<size_t>( ty ) * m_TilesX + tx].push_back( i );
+            }
+        }
+    }
+}
+
+void CommandBuffer::clear() noexcept
+{
+    m_Commands.clear();
+    m_Bounds.clear();
+}
+
+AABB CommandBuffer::getTileAABB( uint32_t tile ) const noexcept
+{
+    assert( tile < getNumTiles() );
+
+    const uint32_t x = ( tile % m_TilesX ) * m_TileSize;
+    const uint32_t y = ( tile / m_TilesX ) * m_TileSize;
+
+    return AABB::fromMinMax( { x, y, 0 }, { std::min( x + m_TileSize, m_Width ) - 1, std::min( y + m_TileSize, m_Height ) - 1, 0 } );
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <Graphics/BlendMode.hpp>
+#include <Graphics/ClipVertex.hpp>
+#include <Graphics/Color.hpp>
+#include <Graphics/Enums.hpp>
+#include <Graphics/Sprite.hpp>
+#include <Graphics/Vertex.hpp>
+
+#include <Math/AABB.hpp>
+#include <Math/Rect.hpp>
+
+#include <glm/mat3x3.hpp>
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace Graphics
+{
+struct Image;
+struct GlyphRun;
+class DepthBuffer;
+
+struct ClearCommand
+{
+    Color color;
+};
+
+struct CopyCommand
+{
+    const Image* srcImage;
+    Math::RectI  srcRect;
+    Math::RectI  dstRect;
+    BlendMode    blendMode;
+};
+
+struct CopyImageCommand
+{
+    const Image* srcImage;
+    int          x;
+    int          y;
+};
+
+struct LineCommand
+{
+    int       x0, y0, x1, y1;
+    Color     color;
+    BlendMode blendMode;
+};
+
+struct TriangleCommand
+{
+    glm::vec2 p0, p1, p2;
+    Color     color;
+    BlendMode blendMode;
+};
+
+struct Triangle3DCommand
+{
+    ClipVertex   v0, v1, v2;
+    DepthBuffer* depthBuffer;
+    const Image* texture;  ///< Optional.
+    AddressMode  addressMode;
+    CullMode     cullMode;
+    BlendMode    blendMode;
+};
+
+struct VertexTriangleCommand
+{
+    Vertex       v0, v1, v2;
+    const Image* texture;  ///< Optional.
+    AddressMode  addressMode;
+    BlendMode    blendMode;
+};
+
+struct TexturedQuadCommand
+{
+    Vertex       v0, v1, v2, v3;
+    const Image* image;
+    AddressMode  addressMode;
+    BlendMode    blendMode;
+    FilterMode   filterMode;
+};
+
+struct AABBCommand
+{
+    Math::AABB aabb;
+    Color      color;
+    BlendMode  blendMode;
+};
+
+struct SpriteCommand
+{
+    Sprite    sprite;
+    glm::mat3 matrix;
+};
+
+struct SpriteCopyCommand
+{
+    Sprite sprite;
+    int    x;
+    int    y;
+};
+
+struct GlyphRunCommand
+{
+    std::shared_ptr<const GlyphRun> run;
+    int                             x;
+    int                             y;
+};
+
+using Command = std::variant<ClearCommand, CopyCommand, CopyImageCommand, LineCommand, TriangleCommand, Triangle3DCommand, VertexTriangleCommand, TexturedQuadCommand, AABBCommand, SpriteCommand, SpriteCopyCommand, GlyphRunCommand>;
+
+/// <summary>
+/// A list of draw commands that is recorded while an image is in deferred mode.
+/// Before the commands are executed, they are binned into square screen tiles
+/// so that each tile can be processed independently by a single thread.
+/// </summary>
+class CommandBuffer final
+{
+public:
+    explicit CommandBuffer( uint32_t tileSize );
+
+    /// <summary>
+    /// Append a command to the command buffer.
+    /// </summary>
+    /// <param name="command">The command to record.</param>
+    /// <param name="bounds">The region of the image (in pixels) that is touched by the command.</param>
+    void push( Command&& command, const Math::AABB& bounds );
+
+    /// <summary>
+    /// Sort the recorded commands into the tiles they overlap.
+    /// Commands that don't overlap the image are discarded.
+    /// </summary>
+    /// <param name="width">The width of the image (in pixels).</param>
+    /// <param name="height">The height of the image (in pixels).</param>
+    void bin( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Remove all commands. The memory of the command buffer is retained for the next frame.
+    /// </summary>
+    void clear() noexcept;
+
+    bool empty() const noexcept
+    {
+        return m_Commands.empty();
+    }
+
+    uint32_t getTileSize() const noexcept
+    {
+        return m_TileSize;
+    }
+
+    /// <summary>
+    /// Get the number of tiles. Only valid after the commands have been binned.
+    /// </summary>
+    uint32_t getNumTiles() const noexcept
+    {
+        return m_TilesX * m_TilesY;
+    }
+
+    /// <summary>
+    /// Get the (inclusive) pixel bounds of a tile.
+    /// </summary>
+    Math::AABB getTileAABB( uint32_t tile ) const noexcept;
+
+    /// <summary>
+    /// Get the indices of the commands that touch a tile (in submission order).
+    /// </summary>
+    const std::vector<uint32_t>& getBin( uint32_t tile ) const noexcept
+    {
+        return m_Bins[tile];
+    }
+
+    const Command& operator[]( uint32_t i ) const noexcept
+    {
+        return m_Commands[i];
+    }
+
+private:
+    uint32_t m_TileSize;
+    uint32_t m_Width  = 0u;
+    uint32_t m_Height = 0u;
+    uint32_t m_TilesX = 0u;
+    uint32_t m_TilesY = 0u;
+
+    std::vector<Command>               m_Commands;
+    std::vector<Math::AABB>            m_Bounds;
+    std::vector<std::vector<uint32_t>> m_Bins;
+};
+}  // namespace Graphics
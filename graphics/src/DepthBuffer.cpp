@@ -0,0 +1,66 @@
+#include <Graphics/DepthBuffer.hpp>
+
+#include <algorithm>
+
+using namespace Graphics;
+
+DepthBuffer::DepthBuffer( uint32_t width, uint32_t height )
+{
+    resize( width, height );
+}
+
+void DepthBuffer::resize( uint32_t width, uint32_t height )
+{
+    m_Width  = width;
+    m_Height = height;
+    m_TilesX = ( width + TileSize - 1u ) / TileSize;
+    m_TilesY = ( height + TileSize - 1u ) / TileSize;
+
+    m_Depth.resize( static_cast<size_t>( width ) * height );
+    m_Tiles.resize( static_cast<size_t>( m_TilesX ) * m_TilesY );
+
+    clear();
+}
+
+void DepthBuffer::clear( float depth ) noexcept
+{
+    std::fill( m_Depth.begin(), m_Depth.end(), depth );
+    std::fill( m_Tiles.begin(), m_Tiles.end(), Tile { depth, depth } );
+}
+
+void DepthBuffer::updateTile( uint32_t tx, uint32_t ty ) noexcept
+{
+    const uint32_t x0 = tx * TileSize;
+    const uint32_t y0 = ty * TileSize;
+    const uint32_t x1 = std::min( x0 + TileSize, m_Width );
+    const uint32_t y1 = std::min( y0 + TileSize, m_Height );
+    const uint32_t w  = x1 - x0;
+
+    // The minimum and maximum of each column (so the loop over the rows is vectorized), then of the tile.
+    const float* first = m_Depth.data() + static_cast<size_t>( y0 ) * m_Width + x0;
+    float        minDepth[TileSize], maxDepth[TileSize];
+
+    for ( uint32_t i = 0; i < TileSize; ++i )
+        minDepth[i] = maxDepth[i] = first[std::min( i, w - 1 )];
+
+    for ( uint32_t y = y0 + 1; y < y1; ++y )
+    {
+        const float* row = first + static_cast<size_t>( y - y0 ) * m_Width;
+
+        for ( uint32_t i = 0; i < TileSize; ++i )
+        {
+            const float depth = row[std::min( i, w - 1 )];
+            minDepth[i]       = std::min( minDepth[i], depth );
+            maxDepth[i]       = std::max( maxDepth[i], depth );
+        }
+    }
+
+    Tile tile { minDepth[0], maxDepth[0] };
+    for ( uint32_t i = 1; i < TileSize; ++i )
+    {
+        tile.min = std::min( tile.min, minDepth[i] );
+        tile.max = std::max( tile.max, maxDepth[i] );
+    }
+
+    m_Tiles[static_cast<size_t>( ty ) * m_TilesX + tx] = tile;
+}
@@ -0,0 +1,103 @@
+#include <Graphics/DirtyRects.hpp>
+
+#include <algorithm>
+#include <limits>
+
+using namespace Graphics;
+using namespace Math;
+
+static int64_t area( const RectI& r ) noexcept
+{
+    return static_cast<int64_t>( r.width ) * r.height;
+}
+
+static RectI merge( const RectI& a, const RectI& b ) noexcept
+{
+    const int left   = std::min( a.left, b.left );
+    const int top    = std::min( a.top, b.top );
+    const int right  = std::max( a.right(), b.right() );
+    const int bottom = std::max( a.bottom(), b.bottom() );
+
+    return { left, top, right - left, bottom - top };
+}
+
+static bool overlaps( const RectI& a, const RectI& b ) noexcept
+{
+    return a.left < b.right() && b.left < a.right() && a.top < b.bottom() && b.top < a.bottom();
+}
+
+void DirtyRects::add( const RectI& rect )
+{
+    if ( rect.width <= 0 || rect.height <= 0 )
+        return;
+
+    RectI r = rect;
+
+    // Merge with the rectangles that overlap, or that are close enough that the merged rectangle
+    // isn't larger than the two rectangles together. Merging can make the rectangle overlap
+    // rectangles that were already checked, so repeat until nothing is merged.
+    bool merged = true;
+    while ( merged )
+    {
+        merged = false;
+        for ( size_t i = 0; i < m_Rects.size(); ++i )
+        {
+            const RectI u = merge( r, m_Rects[i] );
+            if ( overlaps( r, m_Rects[i] ) || area( u ) <= area( r ) + area( m_Rects[i] ) )
+            {
+                r          = u;
+                m_Rects[i] = m_Rects.back();
+                m_Rects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if ( m_Rects.size() < MaxRects )
+    {
+        m_Rects.push_back( r );
+        return;
+    }
+
+    // The list is full. Merge with the rectangle that grows the least.
+    size_t  best       = 0;
+    int64_t bestGrowth = std::numeric_limits<int64_t>::max();
+    for ( size_t i = 0; i < m_Rects.size(); ++i )
+    {
+        const int64_t growth = area( merge( r, m_Rects[i] ) ) - area( m_Rects[i] );
+        if ( growth < bestGrowth )
+        {
+            best       = i;
+            bestGrowth = growth;
+        }
+    }
+
+    r             = merge( r, m_Rects[best] );
+    m_Rects[best] = m_Rects.back();
+    m_Rects.pop_back();
+
+    // The merged rectangle may overlap other rectangles now.
+    add( r );
+}
+
+int64_t DirtyRects::getArea() const noexcept
+{
+    int64_t total = 0;
+    for ( const RectI& r: m_Rects )
+        total += area( r );
+
+    return total;
+}
+
+RectI DirtyRects::getBounds() const noexcept
+{
+    if ( m_Rects.empty() )
+        return {};
+
+    RectI bounds = m_Rects[0];
+    for ( const RectI& r: m_Rects )
+        bounds = merge( bounds, r );
+
+    return bounds;
+}
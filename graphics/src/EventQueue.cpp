@@ -0,0 +1,72 @@
+#include "EventQueue.hpp"
+
+#include <algorithm>
+#include <bit>
+
+using namespace Graphics;
+
+EventQueue::EventQueue( size_t capacity )
+: m_Cells { std::make_unique<Cell[]>( std::bit_ceil( std::max<size_t>( capacity, 2 ) ) ) }
+, m_Mask { std::bit_ceil( std::max<size_t>( capacity, 2 ) ) - 1 }
+{
+    for ( size_t i = 0; i <= m_Mask; ++i )
+        m_Cells[i].sequence.store( i, std::memory_order_relaxed );
+}
+
+bool EventQueue::push( const Event& event ) noexcept
+{
+    size_t pos = m_WritePosition.load( std::memory_order_relaxed );
+    Cell*  cell;
+
+    while ( true )
+    {
+        cell = &m_Cells[pos & m_Mask];
+
+        const size_t    sequence = cell->sequence.load( std::memory_order_acquire );
+        const ptrdiff_t diff     = static_cast<ptrdiff_t>( sequence ) - static_cast<ptrdiff_t>( pos );
+
+        if ( diff == 0 )
+        {
+            // The slot is free. Claim it (on failure, pos is updated to the current write position).
+            if ( m_WritePosition.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                break;
+        }
+        else if ( diff < 0 )
+        {
+            // The slot still holds an event from the previous lap: the queue is full.
+            m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        else
+        {
+            // Another producer claimed the slot.
+            pos = m_WritePosition.load( std::memory_order_relaxed );
+        }
+    }
+
+    cell->event = event;
+    cell->sequence.store( pos + 1, std::memory_order_release );
+
+    return true;
+}
+
+bool EventQueue::pop( Event& event ) noexcept
+{
+    Cell& cell = m_Cells[m_ReadPosition & m_Mask];
+
+    if ( cell.sequence.load( std::memory_order_acquire ) != m_ReadPosition + 1 )
+        return false;
+
+    event = cell.event;
+
+    // Free the slot for the producer of the next lap.
+    cell.sequence.store( m_ReadPosition + m_Mask + 1, std::memory_order_release );
+    ++m_ReadPosition;
+
+    return true;
+}
+
+bool EventQueue::empty() const noexcept
+{
+    return m_Cells[m_ReadPosition & m_Mask].sequence.load( std::memory_order_acquire ) != m_ReadPosition + 1;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Graphics/Events.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Graphics
+{
+/// <summary>
+/// A bounded, lock-free, multi-producer single-consumer queue of window events.
+/// Events can be pushed from any thread (the platform message pump, an input or replay thread, or user code),
+/// and they are popped by the thread that polls the window.
+/// Each slot of the ring has a sequence number that tells producers and the consumer whether the slot is
+/// free or holds an event, so pushing only needs a single compare-and-swap on the write position.
+/// </summary>
+class EventQueue final
+{
+public:
+    /// <summary>
+    /// The default number of events the queue can hold.
+    /// </summary>
+    static constexpr size_t DefaultCapacity = 1024;
+
+    /// <summary>
+    /// Create an event queue.
+    /// </summary>
+    /// <param name="capacity">(optional) The number of events the queue can hold (rounded up to a power of two).</param>
+    explicit EventQueue( size_t capacity = DefaultCapacity );
+
+    EventQueue( const EventQueue& )            = delete;
+    EventQueue( EventQueue&& )                 = delete;
+    EventQueue& operator=( const EventQueue& ) = delete;
+    EventQueue& operator=( EventQueue&& )      = delete;
+
+    /// <summary>
+    /// Push an event to the queue. This can be called from any thread.
+    /// </summary>
+    /// <param name="event">The event to push.</param>
+    /// <returns>`true` if the event was pushed, or `false` if the queue is full (the event is dropped).</returns>
+    bool push( const Event& event ) noexcept;
+
+    /// <summary>
+    /// Pop the oldest event from the queue. This must only be called from the consumer thread.
+    /// </summary>
+    /// <param name="event">Receives the event.</param>
+    /// <returns>`true` if an event was popped, or `false` if the queue is empty.</returns>
+    bool pop( Event& event ) noexcept;
+
+    /// <summary>
+    /// Check if the queue is empty. This must only be called from the consumer thread.
+    /// </summary>
+    bool empty() const noexcept;
+
+    size_t capacity() const noexcept
+    {
+        return m_Mask + 1;
+    }
+
+    /// <summary>
+    /// Get the number of events that were dropped because the queue was full.
+    /// </summary>
+    uint64_t getDroppedCount() const noexcept
+    {
+        return m_Dropped.load( std::memory_order_relaxed );
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;  ///< == position: free for the producer at position, == position + 1: holds the event at position.
+        Event               event;
+    };
+
+    std::unique_ptr<Cell[]> m_Cells;
+    size_t                  m_Mask;
+
+    // The producer and consumer positions are on separate cache lines.
+    alignas( 64 ) std::atomic<size_t> m_WritePosition = 0;  ///< The next position to push to (shared by the producers).
+    alignas( 64 ) size_t m_ReadPosition = 0;                ///< The next position to pop from (only used by the consumer).
+
+    std::atomic<uint64_t> m_Dropped = 0;
+};
+}  // namespace Graphics
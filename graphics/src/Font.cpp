@@ -1,22 +1,22 @@
 
-#include <Graphics/File.hpp>
 #include <Graphics/Font.hpp>
 #include <Graphics/Image.hpp>
 
+#include "FontFace.hpp"
+#include "GlyphRun.hpp"
+
 #include <stb_easy_font.h>
 
-#include <codecvt>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
 #include <vector>
 
-namespace fs = std::filesystem;
 using namespace Graphics;
 
 const Font Font::Default {};
 
-// Convert wchar_t string to char string.
-static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> stringConverter;
-
 struct FontVertex
 {
     float   x, y, z;
@@ -25,54 +25,85 @@ struct FontVertex
 
 Font::Font( float size )
 : size { size }
+, runCache { std::make_unique<GlyphRunCache>() }
 {}
 
 Font::Font( const std::filesystem::path& fontFile, float size, uint32_t firstChar, uint32_t numChars )
+: Font( std::make_shared<FontFace>( fontFile ), size, firstChar, numChars )
+{}
+
+Font::Font( std::shared_ptr<FontFace> _face, float size, uint32_t firstChar, uint32_t numChars )
 : size { size }
-, firstChar { firstChar }
-, numChars { numChars }
+, runCache { std::make_unique<GlyphRunCache>() }
 {
-    if ( fs::exists( fontFile ) && fs::is_regular_file( fontFile ) )
+    if ( _face && _face->isValid() )
     {
-        bakedChar = std::make_unique<stbtt_bakedchar[]>( numChars );
-        fontData  = File::readFile<unsigned char>( fontFile, std::ios::binary );
-
-        stbtt_InitFont( &fontInfo, fontData.data(), 0 );
-        // int x0, y0, x1, y1;
-        // stbtt_GetFontBoundingBox( &fontInfo, &x0, &y0, &x1, &y1 );
-        // float scale = stbtt_ScaleForPixelHeight( &fontInfo, size );
-
-        // I'm not sure how to calculate the exact size of the pixel buffer needed for the font.
-        // This pixel width is very liberal, but better safe than sorry.
-        const int pw         = static_cast<int>( std::ceil( static_cast<float>( numChars ) * size ) );
-        const int ph         = static_cast<int>( std::ceil( 2.0f * size ) );
-        auto      fontBitmap = std::make_unique<unsigned char[]>( static_cast<size_t>( pw ) * ph );
-
-        int numRows = stbtt_BakeFontBitmap( fontData.data(), 0, size, fontBitmap.get(), pw, ph,
-                                            static_cast<int>( firstChar ), static_cast<int>( numChars ), bakedChar.get() );
-
-        // Copy the alpha values of the font bitmap to the font image.
-        fontImage = std::make_unique<Image>( pw, ph );
-        Color* c  = fontImage->data();
-        for ( int y = 0; y < ph; ++y )
-        {
-            for ( int x = 0; x < pw; ++x )
-            {
-                size_t        i = static_cast<size_t>( y ) * pw + x;
-                unsigned char a = fontBitmap[i];
+        face  = std::move( _face );
+        scale = stbtt_ScaleForPixelHeight( &face->getFontInfo(), size );
 
-                c[i] = Color { 255, 255, 255, a };
-            }
+        // Rasterize the most common characters up-front.
+        std::scoped_lock lock( face->getMutex() );
+        for ( uint32_t c = firstChar; c < firstChar + numChars; ++c )
+        {
+            if ( const int glyphIndex = stbtt_FindGlyphIndex( &face->getFontInfo(), static_cast<int>( c ) ) )
+                face->getAtlas().getGlyph( glyphIndex, scale );
         }
-
-        // Uncomment the next lines to save the font image to disk.
-        // This is mostly used for testing the font baking.
-        // auto fontTga = std::format( "{}/{}_{}.tga", fontFile.parent_path().string(), fontFile.stem().string(), size );
-        // fontImage->save( fontTga );
     }
-    else
+}
+
+Font::~Font() = default;
+
+// Decode the next code point of a UTF-8 or a wide string.
+static char32_t decode( std::string_view& text ) noexcept
+{
+    return decodeUTF8( text );
+}
+
+static char32_t decode( std::wstring_view& text ) noexcept
+{
+    return decodeUTF16( text );
+}
+
+// Lay out the glyphs of a string of text, and call func( glyphIndex, rect ) for each glyph.
+// The text position is on the baseline of the first line. The glyph rectangles are snapped to whole pixels
+// (with the same rounding as stbtt_GetBakedQuad), so glyphs are copied from the atlas without filtering.
+template<typename CharT, typename Func>
+static void layoutGlyphs( const stbtt_fontinfo& fontInfo, float size, float scale, std::basic_string_view<CharT> text, Func&& func )
+{
+    float xPos = 0.0f;
+    float yPos = 0.0f;
+
+    while ( !text.empty() )
     {
-        std::cerr << "Error reading file: " << fontFile << std::endl;
+        const char32_t c = decode( text );
+
+        if ( c == '\n' )
+        {
+            xPos = 0.0f;
+            yPos += size;
+        }
+        else if ( c == 0 )
+        {
+            break;
+        }
+        else if ( c >= ' ' )
+        {
+            // Characters that are not in the font are rendered with the missing glyph (glyph 0).
+            const int glyphIndex = stbtt_FindGlyphIndex( &fontInfo, static_cast<int>( c ) );
+
+            int advance, leftSideBearing;
+            stbtt_GetGlyphHMetrics( &fontInfo, glyphIndex, &advance, &leftSideBearing );
+
+            int x0, y0, x1, y1;
+            stbtt_GetGlyphBitmapBox( &fontInfo, glyphIndex, scale, scale, &x0, &y0, &x1, &y1 );
+
+            const int x = static_cast<int>( std::floor( xPos + 0.5f ) ) + x0;
+            const int y = static_cast<int>( std::floor( yPos + 0.5f ) ) + y0;
+
+            func( glyphIndex, Math::RectI { x, y, x1 - x0, y1 - y0 } );
+
+            xPos += scale * static_cast<float>( advance );
+        }
     }
 }
 
@@ -81,30 +112,18 @@ glm::vec2 Font::getSize( std::string_view text ) const noexcept
     float width  = 0.0f;
     float height = 0.0f;
 
-    if ( fontImage && bakedChar )
+    if ( face )
     {
-        // TODO: There must be a better way of computing the size of the text using font metrics.
-        // But using GetBakedQuad seems like the most obvious (but not optimal) approach.
-        Math::AABB  aabb;
-        const char* t    = text.data();
-        float       xPos = 0.0f;
-        float       yPos = 0.0f;
-        while ( *t )
-        {
-            if ( *t >= firstChar && *t < ( firstChar + numChars ) )
-            {
-                stbtt_aligned_quad q;
-                stbtt_GetBakedQuad( bakedChar.get(), static_cast<int>( fontImage->getWidth() ), static_cast<int>( fontImage->getHeight() ), *t - firstChar, &xPos, &yPos, &q, 1 );
-                aabb.expand( Math::AABB::fromMinMax( { q.x0, q.y0, 0 }, { q.x1, q.y1, 0 } ) );
-            }
-            else if ( *t == '\n' )
-            {
-                xPos = 0.0f;
-                yPos += size;
-            }
+        Math::AABB aabb;
+        layoutGlyphs( face->getFontInfo(), size, scale, text, [&aabb]( int, const Math::RectI& rect ) {
+            const auto x0 = static_cast<float>( rect.left );
+            const auto y0 = static_cast<float>( rect.top );
+            const auto x1 = static_cast<float>( rect.right() );
+            const auto y1 = static_cast<float>( rect.bottom() );
+
+            aabb.expand( Math::AABB::fromMinMax( { x0, y0, 0 }, { x1, y1, 0 } ) );
+        } );
 
-            ++t;
-        }
         width  = aabb.width();
         height = aabb.height();
     }
@@ -117,61 +136,151 @@ glm::vec2 Font::getSize( std::string_view text ) const noexcept
     return { width, height };
 }
 
-void Font::drawText( Image& image, std::string_view text, int x, int y, const Color& color ) const
+// Convert a coverage mask (-1 for pixels that are not covered) to the spans of a glyph run.
+static void buildSpans( GlyphRun& run, const std::vector<int>& coverage, const Color& color )
 {
-    // Convert to wide character strings.
-    std::wstring wText = stringConverter.from_bytes( text.data() );
-    drawText( image, wText, x, y, color );
+    const Math::RectI& bounds = run.bounds;
+
+    for ( int y = 0; y < bounds.height; ++y )
+    {
+        const int* row = coverage.data() + static_cast<size_t>( y ) * bounds.width;
+
+        for ( int x = 0; x < bounds.width; )
+        {
+            if ( row[x] < 0 )
+            {
+                ++x;
+                continue;
+            }
+
+            GlyphRun::Span span { bounds.left + x, bounds.top + y, 0, static_cast<uint32_t>( run.pixels.size() ) };
+            for ( ; x < bounds.width && row[x] >= 0; ++x, ++span.count )
+                run.pixels.push_back( color.withAlpha( static_cast<uint8_t>( row[x] ) ) );
+
+            run.spans.push_back( span );
+        }
+    }
 }
 
-void Font::drawText( Image& image, std::wstring_view text, int x, int y, const Color& color ) const
+template<typename CharT>
+std::shared_ptr<const GlyphRun> Font::createGlyphRun( std::basic_string_view<CharT> text, const Color& color ) const
 {
-    if ( fontImage && bakedChar )
+    auto run = std::make_shared<GlyphRun>();
+
+    if ( face )
     {
-        const wchar_t* t    = text.data();
-        auto           xPos = static_cast<float>( x );
-        auto           yPos = static_cast<float>( y );
-        while ( *t )
+        struct Glyph
         {
-            if ( *t >= firstChar && *t < ( firstChar + numChars ) )
-            {
-                stbtt_aligned_quad q;
-                stbtt_GetBakedQuad( bakedChar.get(), static_cast<int>( fontImage->getWidth() ), static_cast<int>( fontImage->getHeight() ), static_cast<int>( *t - firstChar ), &xPos, &yPos, &q, 1 );
+            int         index;  ///< The index of the glyph in the font.
+            Math::RectI rect;   ///< The position of the glyph (relative to the text position).
+        };
 
-                Vertex v0 { { q.x0, q.y0 }, { q.s0, q.t0 }, color };
-                Vertex v1 { { q.x1, q.y0 }, { q.s1, q.t0 }, color };
-                Vertex v2 { { q.x1, q.y1 }, { q.s1, q.t1 }, color };
-                Vertex v3 { { q.x0, q.y1 }, { q.s0, q.t1 }, color };
+        std::vector<Glyph> glyphs;
+        int                left = 0, top = 0, right = 0, bottom = 0;
 
-                image.drawQuad( v0, v1, v2, v3, *fontImage, AddressMode::Clamp, BlendMode::AlphaBlend );
-                // image.drawQuad( { q.x0, q.y0 }, { q.x1, q.y0 }, { q.x1, q.y1 }, { q.x0, q.y1 }, Color::Red, {}, FillMode::WireFrame ); // For debugging glyph quads.
-            }
-            else if ( *t == '\n' )
+        layoutGlyphs( face->getFontInfo(), size, scale, text, [&]( int glyphIndex, const Math::RectI& rect ) {
+            if ( rect.width <= 0 || rect.height <= 0 )
+                return;
+
+            if ( glyphs.empty() )
             {
-                xPos = static_cast<float>( x );
-                yPos += size;
+                left   = rect.left;
+                top    = rect.top;
+                right  = rect.right();
+                bottom = rect.bottom();
             }
 
-            ++t;
+            left   = std::min( left, rect.left );
+            top    = std::min( top, rect.top );
+            right  = std::max( right, rect.right() );
+            bottom = std::max( bottom, rect.bottom() );
+
+            glyphs.push_back( { glyphIndex, rect } );
+        } );
+
+        run->blendMode = BlendMode::AlphaBlend;
+        run->bounds    = { left, top, right - left, bottom - top };
+
+        // Combine the alpha of the glyphs. Where glyphs overlap, the alpha of the later glyph is composited over the earlier glyph.
+        std::vector<int> coverage( static_cast<size_t>( run->bounds.width ) * run->bounds.height, -1 );
+
+        std::scoped_lock lock( face->getMutex() );
+        GlyphAtlas&      atlas = face->getAtlas();
+
+        for ( const Glyph& glyph: glyphs )
+        {
+            // Rasterizes the glyph if it is not in the atlas yet.
+            const GlyphAtlas::Glyph& g = atlas.getGlyph( glyph.index, scale );
+
+            // The glyph is larger than the atlas.
+            if ( g.width != glyph.rect.width || g.height != glyph.rect.height )
+                continue;
+
+            for ( int y = 0; y < g.height; ++y )
+            {
+                const uint8_t* texels = atlas.data() + static_cast<size_t>( g.y + y ) * atlas.getWidth() + g.x;
+                int*           dst    = coverage.data() + static_cast<size_t>( glyph.rect.top + y - top ) * run->bounds.width + ( glyph.rect.left - left );
+
+                for ( int x = 0; x < g.width; ++x )
+                {
+                    // Same as tinting the (white) glyph with the color.
+                    const int a = texels[x] * color.a / 255;
+                    dst[x]      = dst[x] < 0 ? a : a + dst[x] * ( 255 - a ) / 255;
+                }
+            }
         }
+
+        buildSpans( *run, coverage, color );
     }
     else
     {
-        // Basic fonts only support ASCII characters. Try to convert the text to ASCII...
-        std::string strText = stringConverter.to_bytes( text.data() );
+        // Basic fonts only support ASCII characters.
+        std::string strText;
+        strText.reserve( text.size() );
+        while ( !text.empty() )
+        {
+            const char32_t c = decode( text );
+            if ( c == 0 )
+                break;
+
+            strText.push_back( c < 0x80 ? static_cast<char>( c ) : '?' );
+        }
 
-        std::vector<FontVertex> vertexBuffer( text.length() * 40 );
+        std::vector<FontVertex> vertexBuffer( strText.length() * 40 );
 
         const int numQuads = stb_easy_font_print( 0, 0, strText.data(), nullptr, vertexBuffer.data(), static_cast<int>( vertexBuffer.size() * sizeof( FontVertex ) ) );
 
+        if ( numQuads == 0 )
+            return run;
+
         // Scale the quads.
-        for ( auto& v: vertexBuffer )
+        float minX = std::numeric_limits<float>::max(), minY = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest(), maxY = std::numeric_limits<float>::lowest();
+        for ( int i = 0; i < numQuads * 4; ++i )
         {
-            v.x = v.x * size + static_cast<float>( x );
-            v.y = v.y * size + static_cast<float>( y );
-            v.z = v.z * size;
+            FontVertex& v = vertexBuffer[i];
+            v.x *= size;
+            v.y *= size;
+
+            minX = std::min( minX, v.x );
+            minY = std::min( minY, v.y );
+            maxX = std::max( maxX, v.x );
+            maxY = std::max( maxY, v.y );
         }
 
+        const int left   = static_cast<int>( std::floor( minX ) );
+        const int top    = static_cast<int>( std::floor( minY ) );
+        const int right  = static_cast<int>( std::ceil( maxX ) ) + 1;
+        const int bottom = static_cast<int>( std::ceil( maxY ) ) + 1;
+
+        // Rasterize the quads into a mask. The quads are only translated by whole pixels,
+        // so the mask covers the same pixels as the quads at the text position.
+        Image mask { static_cast<uint32_t>( right - left ), static_cast<uint32_t>( bottom - top ) };
+        mask.clear( Color { 0, 0, 0, 0 } );
+
+        const auto fl = static_cast<float>( left );
+        const auto ft = static_cast<float>( top );
+
         for ( int i = 0; i < numQuads; ++i )
         {
             const FontVertex& v0 = vertexBuffer[i * 4 + 0];
@@ -179,7 +288,48 @@ void Font::drawText( Image& image, std::wstring_view text, int x, int y, const C
             const FontVertex& v2 = vertexBuffer[i * 4 + 2];
             const FontVertex& v3 = vertexBuffer[i * 4 + 3];
 
-            image.drawQuad( { v0.x, v0.y }, { v1.x, v1.y }, { v2.x, v2.y }, { v3.x, v3.y }, color, {}, FillMode::Solid );
+            mask.drawQuad( { v0.x - fl, v0.y - ft }, { v1.x - fl, v1.y - ft }, { v2.x - fl, v2.y - ft }, { v3.x - fl, v3.y - ft }, Color::White, {}, FillMode::Solid );
         }
+
+        // The quads are drawn without blending.
+        run->bounds = { left, top, right - left, bottom - top };
+
+        std::vector<int> coverage( static_cast<size_t>( run->bounds.width ) * run->bounds.height );
+        for ( size_t i = 0; i < coverage.size(); ++i )
+            coverage[i] = mask.data()[i].a != 0 ? color.a : -1;
+
+        buildSpans( *run, coverage, color );
     }
+
+    return run;
+}
+
+std::shared_ptr<const GlyphRun> Font::getGlyphRun( std::string_view text, const Color& color ) const
+{
+    if ( text.empty() )
+        return nullptr;
+
+    if ( auto run = runCache->find( text, false, color ) )
+        return run;
+
+    auto run = createGlyphRun( text, color );
+    runCache->insert( text, false, color, run );
+
+    return run;
+}
+
+std::shared_ptr<const GlyphRun> Font::getGlyphRun( std::wstring_view text, const Color& color ) const
+{
+    if ( text.empty() )
+        return nullptr;
+
+    const std::string_view bytes { reinterpret_cast<const char*>( text.data() ), text.size() * sizeof( wchar_t ) };
+
+    if ( auto run = runCache->find( bytes, true, color ) )
+        return run;
+
+    auto run = createGlyphRun( text, color );
+    runCache->insert( bytes, true, color, run );
+
+    return run;
 }
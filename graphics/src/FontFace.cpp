@@ -0,0 +1,25 @@
+#include "FontFace.hpp"
+
+#include <Graphics/File.hpp>
+
+#include <iostream>
+
+namespace fs = std::filesystem;
+using namespace Graphics;
+
+FontFace::FontFace( const std::filesystem::path& fontFile )
+{
+    if ( fs::exists( fontFile ) && fs::is_regular_file( fontFile ) )
+    {
+        m_FontData = File::readFile<unsigned char>( fontFile, std::ios::binary );
+
+        if ( stbtt_InitFont( &m_FontInfo, m_FontData.data(), stbtt_GetFontOffsetForIndex( m_FontData.data(), 0 ) ) )
+            m_Atlas = std::make_unique<GlyphAtlas>( m_FontInfo );
+        else
+            std::cerr << "Error reading font: " << fontFile << std::endl;
+    }
+    else
+    {
+        std::cerr << "Error reading file: " << fontFile << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GlyphAtlas.hpp"
+
+#include <stb_truetype.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A TrueType font file and the glyph atlas of the font.
+/// A font face is shared by the fonts of all sizes that are loaded from the same file, so the file is only loaded once,
+/// and the glyphs of all sizes are packed into the same atlas.
+/// </summary>
+class FontFace final
+{
+public:
+    /// <summary>
+    /// Load a font face from a TrueType font file.
+    /// </summary>
+    /// <param name="fontFile">The font file to load.</param>
+    explicit FontFace( const std::filesystem::path& fontFile );
+
+    FontFace( const FontFace& )            = delete;
+    FontFace( FontFace&& )                 = delete;
+    FontFace& operator=( const FontFace& ) = delete;
+    FontFace& operator=( FontFace&& )      = delete;
+
+    /// <summary>
+    /// Check if the font file was loaded.
+    /// </summary>
+    bool isValid() const noexcept
+    {
+        return m_Atlas != nullptr;
+    }
+
+    const stbtt_fontinfo& getFontInfo() const noexcept
+    {
+        return m_FontInfo;
+    }
+
+    /// <summary>
+    /// Get the size of the font file data (in bytes).
+    /// </summary>
+    size_t getDataSize() const noexcept
+    {
+        return m_FontData.size();
+    }
+
+    /// <summary>
+    /// Get the glyph atlas. The atlas must only be used while the mutex is locked.
+    /// </summary>
+    GlyphAtlas& getAtlas() noexcept
+    {
+        return *m_Atlas;
+    }
+
+    std::mutex& getMutex() noexcept
+    {
+        return m_Mutex;
+    }
+
+private:
+    std::vector<unsigned char>  m_FontData;
+    stbtt_fontinfo              m_FontInfo {};
+    std::unique_ptr<GlyphAtlas> m_Atlas;
+    std::mutex                  m_Mutex;
+};
+}  // namespace Graphics
@@ -0,0 +1,155 @@
+#include "GlyphAtlas.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using namespace Graphics;
+
+GlyphAtlas::GlyphAtlas( const stbtt_fontinfo& fontInfo, int maxSize )
+: m_FontInfo { fontInfo }
+, m_Width { std::min( InitialSize, maxSize ) }
+, m_Height { std::min( InitialSize, maxSize ) }
+, m_MaxSize { maxSize }
+, m_Data( static_cast<size_t>( m_Width ) * m_Height )
+{}
+
+const GlyphAtlas::Glyph& GlyphAtlas::getGlyph( int glyphIndex, float scale )
+{
+    const uint64_t key = static_cast<uint64_t>( std::bit_cast<uint32_t>( scale ) ) << 32 | static_cast<uint32_t>( glyphIndex );
+
+    ++m_Tick;
+
+    if ( const auto iter = m_Glyphs.find( key ); iter != m_Glyphs.end() )
+    {
+        if ( iter->second.shelf != NoShelf )
+            m_Shelves[iter->second.shelf].lastUsed = m_Tick;
+
+        return iter->second.glyph;
+    }
+
+    int x0, y0, x1, y1;
+    stbtt_GetGlyphBitmapBox( &m_FontInfo, glyphIndex, scale, scale, &x0, &y0, &x1, &y1 );
+
+    Entry entry { { 0, 0, x1 - x0, y1 - y0 }, NoShelf };
+
+    if ( entry.glyph.width > 0 && entry.glyph.height > 0 )
+    {
+        entry.shelf = allocate( entry.glyph.width, entry.glyph.height );
+
+        if ( entry.shelf != NoShelf )
+        {
+            Shelf& shelf = m_Shelves[entry.shelf];
+
+            entry.glyph.x = shelf.x;
+            entry.glyph.y = shelf.y;
+            shelf.x += entry.glyph.width;
+            shelf.lastUsed = m_Tick;
+            shelf.glyphs.push_back( key );
+
+            // Evicted glyphs leave their coverage behind.
+            uint8_t* dst = m_Data.data() + static_cast<size_t>( entry.glyph.y ) * m_Width + entry.glyph.x;
+            for ( int y = 0; y < entry.glyph.height; ++y )
+                std::memset( dst + static_cast<size_t>( y ) * m_Width, 0, entry.glyph.width );
+
+            stbtt_MakeGlyphBitmap( &m_FontInfo, dst, entry.glyph.width, entry.glyph.height, m_Width, scale, scale, glyphIndex );
+        }
+        else
+        {
+            // The glyph is larger than the atlas.
+            entry.glyph.width  = 0;
+            entry.glyph.height = 0;
+        }
+    }
+
+    return m_Glyphs.emplace( key, entry ).first->second.glyph;
+}
+
+size_t GlyphAtlas::allocate( int width, int height )
+{
+    if ( width > m_MaxSize || height > m_MaxSize )
+        return NoShelf;
+
+    // Round the height of new shelves up, so glyphs with similar heights share a shelf.
+    const int shelfHeight = std::min( ( height + 3 ) & ~3, m_MaxSize );
+
+    while ( true )
+    {
+        for ( size_t i = 0; i < m_Shelves.size(); ++i )
+        {
+            const Shelf& shelf = m_Shelves[i];
+            if ( shelf.height >= height && shelf.height <= shelfHeight && shelf.x + width <= m_Width )
+                return i;
+        }
+
+        if ( width <= m_Width && m_ShelvesHeight + shelfHeight <= m_Height )
+        {
+            m_Shelves.push_back( { m_ShelvesHeight, shelfHeight, 0, m_Tick, {} } );
+            m_ShelvesHeight += shelfHeight;
+
+            return m_Shelves.size() - 1;
+        }
+
+        if ( grow() )
+            continue;
+
+        // The atlas is full. Evict the least recently used shelf that the glyph fits in.
+        size_t lru = NoShelf;
+        for ( size_t i = 0; i < m_Shelves.size(); ++i )
+        {
+            if ( m_Shelves[i].height >= height && ( lru == NoShelf || m_Shelves[i].lastUsed < m_Shelves[lru].lastUsed ) )
+                lru = i;
+        }
+
+        if ( lru != NoShelf )
+        {
+            evict( m_Shelves[lru] );
+            return lru;
+        }
+
+        // None of the shelves are tall enough. Evict all of the shelves and start over.
+        for ( Shelf& shelf: m_Shelves )
+            evict( shelf );
+
+        m_Shelves.clear();
+        m_ShelvesHeight = 0;
+    }
+}
+
+bool GlyphAtlas::grow()
+{
+    if ( m_Width >= m_MaxSize && m_Height >= m_MaxSize )
+        return false;
+
+    if ( m_Height < m_Width )
+    {
+        // Add rows below the shelves.
+        m_Height = std::min( m_Height * 2, m_MaxSize );
+        m_Data.resize( static_cast<size_t>( m_Width ) * m_Height );
+    }
+    else
+    {
+        // Widen the rows, which makes room for more glyphs in every shelf.
+        const int            width = std::min( m_Width * 2, m_MaxSize );
+        std::vector<uint8_t> data( static_cast<size_t>( width ) * m_Height );
+
+        for ( int y = 0; y < m_Height; ++y )
+            std::memcpy( data.data() + static_cast<size_t>( y ) * width, m_Data.data() + static_cast<size_t>( y ) * m_Width, m_Width );
+
+        m_Width = width;
+        m_Data  = std::move( data );
+    }
+
+    return true;
+}
+
+void GlyphAtlas::evict( Shelf& shelf )
+{
+    for ( const uint64_t key: shelf.glyphs )
+        m_Glyphs.erase( key );
+
+    m_Evicted += shelf.glyphs.size();
+
+    shelf.glyphs.clear();
+    shelf.x = 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stb_truetype.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A growing atlas of glyph coverage (alpha) bitmaps of a font face.
+/// Glyphs are rasterized on demand, at any pixel size, the first time they are requested.
+/// The atlas is packed in shelves (rows of glyphs with similar heights). The atlas starts small and
+/// grows until it reaches its maximum size. After that, the least recently used shelf is evicted to
+/// make room for new glyphs.
+/// </summary>
+/// <remarks>
+/// The atlas is not thread-safe. The font face guards the atlas with a mutex.
+/// </remarks>
+class GlyphAtlas final
+{
+public:
+    /// <summary>
+    /// The initial width and height of the atlas (in pixels).
+    /// </summary>
+    static constexpr int InitialSize = 256;
+
+    /// <summary>
+    /// The default maximum width and height of the atlas (in pixels).
+    /// </summary>
+    static constexpr int DefaultMaxSize = 2048;
+
+    struct Glyph
+    {
+        int x, y;           ///< The top-left corner of the glyph in the atlas.
+        int width, height;  ///< The size of the glyph bitmap (0 for glyphs without an outline).
+    };
+
+    /// <summary>
+    /// Create a glyph atlas for a font.
+    /// </summary>
+    /// <param name="fontInfo">The font to rasterize the glyphs of. The font must outlive the atlas.</param>
+    /// <param name="maxSize">(optional) The maximum width and height of the atlas (in pixels).</param>
+    explicit GlyphAtlas( const stbtt_fontinfo& fontInfo, int maxSize = DefaultMaxSize );
+
+    /// <summary>
+    /// Get a glyph, and rasterize it if it is not in the atlas.
+    /// The glyph and the atlas data are only valid until the next call to getGlyph, since adding a glyph may
+    /// grow the atlas or evict other glyphs.
+    /// </summary>
+    /// <param name="glyphIndex">The index of the glyph in the font.</param>
+    /// <param name="scale">The scale of the glyph (from stbtt_ScaleForPixelHeight).</param>
+    /// <returns>The glyph. If the glyph doesn't fit in the atlas, the size of the glyph is 0.</returns>
+    const Glyph& getGlyph( int glyphIndex, float scale );
+
+    /// <summary>
+    /// Get the coverage of the glyphs in the atlas (one byte per pixel).
+    /// </summary>
+    const uint8_t* data() const noexcept
+    {
+        return m_Data.data();
+    }
+
+    int getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    int getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Get the number of glyphs in the atlas.
+    /// </summary>
+    size_t getGlyphCount() const noexcept
+    {
+        return m_Glyphs.size();
+    }
+
+    /// <summary>
+    /// Get the number of glyphs that were evicted from the atlas.
+    /// </summary>
+    uint64_t getEvictionCount() const noexcept
+    {
+        return m_Evicted;
+    }
+
+private:
+    struct Shelf
+    {
+        int                   y;
+        int                   height;
+        int                   x;         ///< The left of the free space in the shelf.
+        uint64_t              lastUsed;  ///< The tick when a glyph in the shelf was last used.
+        std::vector<uint64_t> glyphs;    ///< The keys of the glyphs in the shelf.
+    };
+
+    struct Entry
+    {
+        Glyph  glyph;
+        size_t shelf;  ///< The shelf that contains the glyph (NoShelf for empty glyphs).
+    };
+
+    static constexpr size_t NoShelf = static_cast<size_t>( -1 );
+
+    // Find space for a glyph. Returns the index of the shelf, or NoShelf if the glyph doesn't fit.
+    size_t allocate( int width, int height );
+    // Double the size of the atlas. Returns false if the atlas is at its maximum size.
+    bool grow();
+    // Remove the glyphs in a shelf.
+    void evict( Shelf& shelf );
+
+    const stbtt_fontinfo& m_FontInfo;
+
+    int                  m_Width;
+    int                  m_Height;
+    int                  m_MaxSize;
+    std::vector<uint8_t> m_Data;
+
+    std::vector<Shelf> m_Shelves;
+    int                m_ShelvesHeight = 0;  ///< The height of all of the shelves (the top of the unused space).
+
+    std::unordered_map<uint64_t, Entry> m_Glyphs;
+
+    uint64_t m_Tick    = 0;
+    uint64_t m_Evicted = 0;
+};
+}  // namespace Graphics
@@ -0,0 +1,144 @@
+#include "GlyphRun.hpp"
+
+#include <algorithm>
+#include <functional>
+
+using namespace Graphics;
+
+constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+char32_t Graphics::decodeUTF8( std::string_view& text ) noexcept
+{
+    const auto lead = static_cast<uint8_t>( text[0] );
+
+    // The number of continuation bytes, and the smallest code point that requires the sequence (to reject overlong encodings).
+    int      length;
+    char32_t c;
+    char32_t minimum;
+
+    if ( lead < 0x80 )
+    {
+        text.remove_prefix( 1 );
+        return lead;
+    }
+    else if ( ( lead & 0xE0 ) == 0xC0 )
+    {
+        length  = 1;
+        c       = lead & 0x1F;
+        minimum = 0x80;
+    }
+    else if ( ( lead & 0xF0 ) == 0xE0 )
+    {
+        length  = 2;
+        c       = lead & 0x0F;
+        minimum = 0x800;
+    }
+    else if ( ( lead & 0xF8 ) == 0xF0 )
+    {
+        length  = 3;
+        c       = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        // A continuation byte without a lead byte.
+        text.remove_prefix( 1 );
+        return ReplacementCharacter;
+    }
+
+    size_t i = 1;
+    for ( ; i <= static_cast<size_t>( length ); ++i )
+    {
+        if ( i >= text.size() || ( static_cast<uint8_t>( text[i] ) & 0xC0 ) != 0x80 )
+        {
+            // Truncated sequence. Resume decoding at the unexpected byte.
+            text.remove_prefix( i );
+            return ReplacementCharacter;
+        }
+
+        c = ( c << 6 ) | ( static_cast<uint8_t>( text[i] ) & 0x3F );
+    }
+
+    text.remove_prefix( i );
+
+    if ( c < minimum || c > 0x10FFFF || ( c >= 0xD800 && c <= 0xDFFF ) )
+        return ReplacementCharacter;
+
+    return c;
+}
+
+char32_t Graphics::decodeUTF16( std::wstring_view& text ) noexcept
+{
+    const auto c = static_cast<char32_t>( text[0] );
+    text.remove_prefix( 1 );
+
+    if constexpr ( sizeof( wchar_t ) == 2 )
+    {
+        if ( c >= 0xD800 && c <= 0xDBFF )
+        {
+            if ( !text.empty() && text[0] >= 0xDC00 && text[0] <= 0xDFFF )
+            {
+                const auto low = static_cast<char32_t>( text[0] );
+                text.remove_prefix( 1 );
+
+                return 0x10000 + ( ( c - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+            }
+
+            return ReplacementCharacter;
+        }
+        else if ( c >= 0xDC00 && c <= 0xDFFF )
+        {
+            return ReplacementCharacter;
+        }
+    }
+
+    return c;
+}
+
+size_t GlyphRunCache::KeyHash::operator()( const Key& key ) const noexcept
+{
+    size_t hash = std::hash<std::string_view> {}( key.text );
+    hash ^= std::hash<uint32_t> {}( key.color ) + 0x9E3779B9 + ( hash << 6 ) + ( hash >> 2 );
+
+    return key.wide ? ~hash : hash;
+}
+
+GlyphRunCache::GlyphRunCache( size_t capacity )
+: m_Capacity { std::max<size_t>( capacity, 1 ) }
+{}
+
+std::shared_ptr<const GlyphRun> GlyphRunCache::find( std::string_view text, bool wide, const Color& color )
+{
+    std::scoped_lock lock( m_Mutex );
+
+    const auto iter = m_Map.find( { text, wide, color.argb } );
+    if ( iter == m_Map.end() )
+        return nullptr;
+
+    // Move the entry to the front of the list.
+    m_Entries.splice( m_Entries.begin(), m_Entries, iter->second );
+
+    return iter->second->run;
+}
+
+void GlyphRunCache::insert( std::string_view text, bool wide, const Color& color, std::shared_ptr<const GlyphRun> run )
+{
+    std::scoped_lock lock( m_Mutex );
+
+    // Another thread may have inserted the same text.
+    if ( m_Map.contains( { text, wide, color.argb } ) )
+        return;
+
+    if ( m_Map.size() >= m_Capacity )
+    {
+        const Entry& last = m_Entries.back();
+        m_Map.erase( { last.text, last.wide, last.color } );
+        m_Entries.pop_back();
+    }
+
+    m_Entries.push_front( { std::string { text }, wide, color.argb, std::move( run ) } );
+
+    // The key refers to the text of the entry, which doesn't move while the entry is in the list.
+    const Entry& entry = m_Entries.front();
+    m_Map.emplace( Key { entry.text, entry.wide, entry.color }, m_Entries.begin() );
+}
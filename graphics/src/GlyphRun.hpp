@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Graphics/BlendMode.hpp>
+#include <Graphics/Color.hpp>
+
+#include <Math/Rect.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// A string of text that is rendered with a font and a color, stored as horizontal spans of pre-tinted pixels.
+/// Drawing a glyph run blits each span with a single blend, instead of drawing each glyph separately.
+/// </summary>
+struct GlyphRun
+{
+    struct Span
+    {
+        int      x;       ///< The first pixel of the span (relative to the text position).
+        int      y;       ///< The row of the span (relative to the text position).
+        int      count;   ///< The number of pixels in the span.
+        uint32_t offset;  ///< The offset of the first pixel of the span in the pixel buffer.
+    };
+
+    std::vector<Span>  spans;  ///< The spans of the run, sorted by row. Spans in the same row don't overlap.
+    std::vector<Color> pixels;
+    BlendMode          blendMode;
+    Math::RectI        bounds;  ///< The bounds of all of the spans (relative to the text position).
+};
+
+/// <summary>
+/// Decode the next code point of a UTF-8 string.
+/// Invalid sequences are decoded as U+FFFD (the replacement character).
+/// </summary>
+/// <param name="text">The text to decode. The decoded code point is removed from the front of the text.</param>
+/// <returns>The decoded code point.</returns>
+char32_t decodeUTF8( std::string_view& text ) noexcept;
+
+/// <summary>
+/// Decode the next code point of a wide string (UTF-16 if wchar_t is 16 bits, UTF-32 otherwise).
+/// Unpaired surrogates are decoded as U+FFFD (the replacement character).
+/// </summary>
+/// <param name="text">The text to decode. The decoded code point is removed from the front of the text.</param>
+/// <returns>The decoded code point.</returns>
+char32_t decodeUTF16( std::wstring_view& text ) noexcept;
+
+/// <summary>
+/// A least recently used cache of glyph runs, keyed by text and color.
+/// HUDs draw the same strings every frame, so most strings are only rendered once.
+/// The cache is thread-safe.
+/// </summary>
+class GlyphRunCache final
+{
+public:
+    /// <summary>
+    /// The default maximum number of glyph runs in the cache.
+    /// </summary>
+    static constexpr size_t DefaultCapacity = 256;
+
+    explicit GlyphRunCache( size_t capacity = DefaultCapacity );
+
+    /// <summary>
+    /// Find a glyph run in the cache. A glyph run that is found becomes the most recently used run.
+    /// </summary>
+    /// <param name="text">The bytes of the text.</param>
+    /// <param name="wide">`true` if the bytes are a wide string.</param>
+    /// <param name="color">The color of the text.</param>
+    /// <returns>The glyph run, or nullptr if the cache doesn't contain the text.</returns>
+    std::shared_ptr<const GlyphRun> find( std::string_view text, bool wide, const Color& color );
+
+    /// <summary>
+    /// Add a glyph run to the cache. If the cache is full, the least recently used run is evicted.
+    /// </summary>
+    void insert( std::string_view text, bool wide, const Color& color, std::shared_ptr<const GlyphRun> run );
+
+private:
+    struct Key
+    {
+        std::string_view text;  ///< Points to the text of the entry in the LRU list.
+        bool             wide;
+        uint32_t         color;
+
+        bool operator==( const Key& ) const noexcept = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()( const Key& key ) const noexcept;
+    };
+
+    struct Entry
+    {
+        std::string                     text;
+        bool                            wide;
+        uint32_t                        color;
+        std::shared_ptr<const GlyphRun> run;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    size_t                                                m_Capacity;
+    EntryList                                             m_Entries;   ///< The entries, the most recently used entry first.
+    std::unordered_map<Key, EntryList::iterator, KeyHash> m_Map;
+    std::mutex                                            m_Mutex;
+};
+}  // namespace Graphics
@@ -0,0 +1,343 @@
+#include "FrameSink.hpp"
+
+#include <stb_image_write.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#if defined( _WIN32 )
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+using namespace Graphics;
+
+// Invoke func( first, last ) for the ranges of pixels that must be converted:
+// the rows of the changed regions, or the entire image if regions is null.
+template<typename Func>
+static void forEachRange( const Image& image, const DirtyRects* regions, Func&& func )
+{
+    const size_t width = image.getWidth();
+
+    if ( !regions )
+    {
+        func( size_t { 0 }, width * image.getHeight() );
+        return;
+    }
+
+    for ( const Math::RectI& r: *regions )
+    {
+        for ( int y = r.top; y < r.bottom(); ++y )
+        {
+            const size_t first = static_cast<size_t>( y ) * width + r.left;
+            func( first, first + r.width );
+        }
+    }
+}
+
+// Convert the BGRA pixels of the image to tightly packed RGBA (or RGB) pixels.
+// If the buffer holds the previous frame, only the changed regions are converted.
+static void convertPixels( const Image& image, const DirtyRects* regions, std::vector<uint8_t>& buffer, bool alpha )
+{
+    const size_t numPixels = static_cast<size_t>( image.getWidth() ) * image.getHeight();
+    const size_t channels  = alpha ? 4 : 3;
+    const Color* src       = image.data();
+
+    if ( buffer.size() != numPixels * channels )
+    {
+        buffer.resize( numPixels * channels );
+        regions = nullptr;
+    }
+
+    forEachRange( image, regions, [&]( size_t first, size_t last ) {
+        uint8_t* dst = buffer.data() + first * channels;
+
+        for ( size_t i = first; i < last; ++i, dst += channels )
+        {
+            dst[0] = src[i].r;
+            dst[1] = src[i].g;
+            dst[2] = src[i].b;
+            if ( alpha )
+                dst[3] = src[i].a;
+        }
+    } );
+}
+
+static void writeBigEndian( std::vector<uint8_t>& out, uint32_t v )
+{
+    out.push_back( static_cast<uint8_t>( v >> 24 ) );
+    out.push_back( static_cast<uint8_t>( v >> 16 ) );
+    out.push_back( static_cast<uint8_t>( v >> 8 ) );
+    out.push_back( static_cast<uint8_t>( v ) );
+}
+
+// Source: https://qoiformat.org/qoi-specification.pdf
+static void encodeQOI( const Image& image, std::vector<uint8_t>& out )
+{
+    out.clear();
+    out.reserve( 14 + static_cast<size_t>( image.getWidth() ) * image.getHeight() * 2 + 8 );
+
+    out.insert( out.end(), { 'q', 'o', 'i', 'f' } );
+    writeBigEndian( out, image.getWidth() );
+    writeBigEndian( out, image.getHeight() );
+    out.push_back( 4 );  // RGBA
+    out.push_back( 0 );  // sRGB with linear alpha
+
+    Color index[64] {};
+    Color prev { 0, 0, 0, 255 };
+    int   run = 0;
+
+    const Color* pixels    = image.data();
+    const size_t numPixels = static_cast<size_t>( image.getWidth() ) * image.getHeight();
+
+    for ( size_t i = 0; i < numPixels; ++i )
+    {
+        const Color px = pixels[i];
+
+        if ( px.argb == prev.argb )
+        {
+            if ( ++run == 62 || i == numPixels - 1 )
+            {
+                out.push_back( static_cast<uint8_t>( 0xc0 | ( run - 1 ) ) );  // QOI_OP_RUN
+                run = 0;
+            }
+            continue;
+        }
+
+        if ( run > 0 )
+        {
+            out.push_back( static_cast<uint8_t>( 0xc0 | ( run - 1 ) ) );  // QOI_OP_RUN
+            run = 0;
+        }
+
+        const int hash = ( px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11 ) % 64;
+
+        if ( index[hash].argb == px.argb )
+        {
+            out.push_back( static_cast<uint8_t>( hash ) );  // QOI_OP_INDEX
+        }
+        else
+        {
+            index[hash] = px;
+
+            if ( px.a == prev.a )
+            {
+                const int8_t vr   = static_cast<int8_t>( px.r - prev.r );
+                const int8_t vg   = static_cast<int8_t>( px.g - prev.g );
+                const int8_t vb   = static_cast<int8_t>( px.b - prev.b );
+                const int    vg_r = vr - vg;
+                const int    vg_b = vb - vg;
+
+                if ( vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2 )
+                {
+                    out.push_back( static_cast<uint8_t>( 0x40 | ( vr + 2 ) << 4 | ( vg + 2 ) << 2 | ( vb + 2 ) ) );  // QOI_OP_DIFF
+                }
+                else if ( vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8 )
+                {
+                    out.push_back( static_cast<uint8_t>( 0x80 | ( vg + 32 ) ) );  // QOI_OP_LUMA
+                    out.push_back( static_cast<uint8_t>( ( vg_r + 8 ) << 4 | ( vg_b + 8 ) ) );
+                }
+                else
+                {
+                    out.insert( out.end(), { 0xfe, px.r, px.g, px.b } );  // QOI_OP_RGB
+                }
+            }
+            else
+            {
+                out.insert( out.end(), { 0xff, px.r, px.g, px.b, px.a } );  // QOI_OP_RGBA
+            }
+        }
+
+        prev = px;
+    }
+
+    out.insert( out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 } );
+}
+
+const DirtyRects* FrameSink::getChangedRegions( const Image& image ) noexcept
+{
+    const bool sameImage = &image == m_PreviousImage && image.getWidth() == m_PreviousWidth && image.getHeight() == m_PreviousHeight;
+
+    m_PreviousImage  = &image;
+    m_PreviousWidth  = image.getWidth();
+    m_PreviousHeight = image.getHeight();
+
+    return sameImage && image.isDirtyTracking() ? &image.getDirtyRects() : nullptr;
+}
+
+std::unique_ptr<FrameSink> FrameSink::create( std::string_view type, std::string output, int fps )
+{
+    if ( type == "png" || type == "qoi" )
+    {
+        if ( output.empty() )
+            output = "frame_";
+
+        const auto format = type == "png" ? ImageSequenceFrameSink::Format::PNG : ImageSequenceFrameSink::Format::QOI;
+        return std::make_unique<ImageSequenceFrameSink>( format, std::move( output ) );
+    }
+
+    if ( type == "y4m" || type == "rgb" )
+    {
+        if ( output.empty() )
+            output = type == "y4m" ? "frames.y4m" : "frames.rgb";
+
+        const auto format = type == "y4m" ? VideoStreamFrameSink::Format::Y4M : VideoStreamFrameSink::Format::RGB;
+        return std::make_unique<VideoStreamFrameSink>( format, output, fps );
+    }
+
+    if ( !type.empty() && type != "null" )
+        std::cerr << "Unknown frame sink: " << type << ". Frames will be discarded." << std::endl;
+
+    return std::make_unique<NullFrameSink>();
+}
+
+ImageSequenceFrameSink::ImageSequenceFrameSink( Format format, std::string prefix )
+: m_Format { format }
+, m_Prefix { std::move( prefix ) }
+{
+    const std::filesystem::path dir = std::filesystem::path { m_Prefix }.parent_path();
+    if ( !dir.empty() )
+    {
+        std::error_code ec;
+        std::filesystem::create_directories( dir, ec );
+    }
+}
+
+void ImageSequenceFrameSink::write( const Image& image )
+{
+    char number[32];
+    std::snprintf( number, sizeof( number ), "%06llu", static_cast<unsigned long long>( m_FrameIndex++ ) );
+
+    const int         width   = static_cast<int>( image.getWidth() );
+    const int         height  = static_cast<int>( image.getHeight() );
+    const DirtyRects* regions = getChangedRegions( image );
+
+    switch ( m_Format )
+    {
+    case Format::PNG:
+    {
+        const std::string fileName = m_Prefix + number + ".png";
+        convertPixels( image, regions, m_Buffer, true );
+        if ( !stbi_write_png( fileName.c_str(), width, height, 4, m_Buffer.data(), width * 4 ) )
+            std::cerr << "Failed to write " << fileName << std::endl;
+    }
+    break;
+    case Format::QOI:
+    {
+        const std::string fileName = m_Prefix + number + ".qoi";
+
+        // The encoded stream depends on all of the pixels, but an unchanged frame can be written again.
+        if ( !regions || !regions->empty() || m_Buffer.empty() )
+            encodeQOI( image, m_Buffer );
+
+        std::ofstream file { fileName, std::ios::binary };
+        file.write( reinterpret_cast<const char*>( m_Buffer.data() ), static_cast<std::streamsize>( m_Buffer.size() ) );
+        if ( !file )
+            std::cerr << "Failed to write " << fileName << std::endl;
+    }
+    break;
+    }
+}
+
+VideoStreamFrameSink::VideoStreamFrameSink( Format format, const std::string& fileName, int fps )
+: m_Format { format }
+, m_FPS { fps > 0 ? fps : 60 }
+{
+    if ( fileName == "-" )
+    {
+#if defined( _WIN32 )
+        _setmode( _fileno( stdout ), _O_BINARY );
+#endif
+        m_File = stdout;
+    }
+    else
+    {
+        m_File     = std::fopen( fileName.c_str(), "wb" );
+        m_OwnsFile = m_File != nullptr;
+
+        if ( !m_File )
+            std::cerr << "Failed to open " << fileName << " for writing." << std::endl;
+    }
+}
+
+VideoStreamFrameSink::~VideoStreamFrameSink()
+{
+    if ( m_OwnsFile )
+        std::fclose( m_File );
+    else if ( m_File )
+        std::fflush( m_File );
+}
+
+void VideoStreamFrameSink::write( const Image& image )
+{
+    if ( !m_File )
+        return;
+
+    // The size of the video stream is determined by the first frame.
+    if ( m_Width == 0 && m_Height == 0 )
+    {
+        m_Width  = image.getWidth();
+        m_Height = image.getHeight();
+
+        if ( m_Format == Format::Y4M )
+            std::fprintf( m_File, "YUV4MPEG2 W%u H%u F%d:1 Ip A1:1 C444\n", m_Width, m_Height, m_FPS );
+    }
+
+    if ( image.getWidth() != m_Width || image.getHeight() != m_Height )
+    {
+        std::cerr << "Frame size changed from " << m_Width << "x" << m_Height << " to " << image.getWidth() << "x" << image.getHeight() << ". Frame dropped." << std::endl;
+        return;
+    }
+
+    const DirtyRects* regions = getChangedRegions( image );
+
+    switch ( m_Format )
+    {
+    case Format::Y4M:
+    {
+        // Convert to planar 4:4:4 YCbCr (BT.601, limited range).
+        // The buffer holds the previous frame, so only the changed regions are converted.
+        const size_t numPixels = static_cast<size_t>( m_Width ) * m_Height;
+        const Color* src       = image.data();
+
+        if ( m_Buffer.size() != numPixels * 3 )
+        {
+            m_Buffer.resize( numPixels * 3 );
+            regions = nullptr;
+        }
+
+        uint8_t* Y = m_Buffer.data();
+        uint8_t* U = Y + numPixels;
+        uint8_t* V = U + numPixels;
+
+        forEachRange( image, regions, [&]( size_t first, size_t last ) {
+            for ( size_t i = first; i < last; ++i )
+            {
+                const int r = src[i].r;
+                const int g = src[i].g;
+                const int b = src[i].b;
+
+                Y[i] = static_cast<uint8_t>( ( ( 66 * r + 129 * g + 25 * b + 128 ) >> 8 ) + 16 );
+                U[i] = static_cast<uint8_t>( ( ( -38 * r - 74 * g + 112 * b + 128 ) >> 8 ) + 128 );
+                V[i] = static_cast<uint8_t>( ( ( 112 * r - 94 * g - 18 * b + 128 ) >> 8 ) + 128 );
+            }
+        } );
+
+        std::fputs( "FRAME\n", m_File );
+    }
+    break;
+    case Format::RGB:
+        convertPixels( image, regions, m_Buffer, false );
+        break;
+    }
+
+    if ( std::fwrite( m_Buffer.data(), 1, m_Buffer.size(), m_File ) != m_Buffer.size() )
+    {
+        std::cerr << "Failed to write frame to the video stream." << std::endl;
+        if ( m_OwnsFile )
+            std::fclose( m_File );
+        m_File     = nullptr;
+        m_OwnsFile = false;
+    }
+}
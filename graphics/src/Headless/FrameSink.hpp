@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Graphics/Image.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// Receives the frames that are presented to a headless window.
+/// </summary>
+class FrameSink
+{
+public:
+    virtual ~FrameSink() = default;
+
+    /// <summary>
+    /// Consume a presented frame.
+    /// </summary>
+    /// <param name="image">The presented image.</param>
+    virtual void write( const Image& image ) = 0;
+
+    /// <summary>
+    /// Check if the sink reads the pixels of the frames.
+    /// The headless window doesn't stream the frames to sinks that don't.
+    /// </summary>
+    virtual bool readsPixels() const noexcept
+    {
+        return true;
+    }
+
+    /// <summary>
+    /// Create a frame sink by name.
+    /// </summary>
+    /// <param name="type">One of "null", "png", "qoi", "y4m", or "rgb".</param>
+    /// <param name="output">For image sequences, the prefix of the file names (for example, "frames/frame_").
+    /// For video streams, the file to write to, or "-" to write to the standard output.
+    /// If empty, a default is used.</param>
+    /// <param name="fps">The frame rate that is written to the header of Y4M streams.</param>
+    /// <returns>The frame sink, or a null sink if the type is unknown.</returns>
+    static std::unique_ptr<FrameSink> create( std::string_view type, std::string output, int fps );
+
+protected:
+    /// <summary>
+    /// Get the regions of the image that changed since the previous frame that was written to this sink.
+    /// Call this once per frame.
+    /// </summary>
+    /// <param name="image">The presented image.</param>
+    /// <returns>The dirty rectangles of the image, or nullptr if the entire image must be processed
+    /// (because dirty rectangle tracking is disabled, or a different image was presented).</returns>
+    const DirtyRects* getChangedRegions( const Image& image ) noexcept;
+
+private:
+    const Image* m_PreviousImage  = nullptr;
+    uint32_t     m_PreviousWidth  = 0;
+    uint32_t     m_PreviousHeight = 0;
+};
+
+/// <summary>
+/// Discards all frames. Useful to measure the throughput of the renderer.
+/// </summary>
+class NullFrameSink final : public FrameSink
+{
+public:
+    void write( const Image& ) override {}
+
+    bool readsPixels() const noexcept override
+    {
+        return false;
+    }
+};
+
+/// <summary>
+/// Writes each frame to a numbered image file.
+/// </summary>
+class ImageSequenceFrameSink final : public FrameSink
+{
+public:
+    enum class Format
+    {
+        PNG,
+        QOI,
+    };
+
+    ImageSequenceFrameSink( Format format, std::string prefix );
+
+    void write( const Image& image ) override;
+
+private:
+    Format               m_Format;
+    std::string          m_Prefix;
+    uint64_t             m_FrameIndex = 0;
+    std::vector<uint8_t> m_Buffer;
+};
+
+/// <summary>
+/// Writes the frames to a single uncompressed video stream (a file or a pipe).
+/// The Y4M stream can be played back directly (for example, with ffplay).
+/// The RGB stream has no header and must be read as raw rgb24 video with the size of the first frame.
+/// </summary>
+class VideoStreamFrameSink final : public FrameSink
+{
+public:
+    enum class Format
+    {
+        Y4M,
+        RGB,
+    };
+
+    VideoStreamFrameSink( Format format, const std::string& fileName, int fps );
+    ~VideoStreamFrameSink() override;
+
+    VideoStreamFrameSink( const VideoStreamFrameSink& )            = delete;
+    VideoStreamFrameSink& operator=( const VideoStreamFrameSink& ) = delete;
+
+    void write( const Image& image ) override;
+
+private:
+    Format               m_Format;
+    std::FILE*           m_File     = nullptr;
+    bool                 m_OwnsFile = false;
+    int                  m_FPS;
+    uint32_t             m_Width  = 0;
+    uint32_t             m_Height = 0;
+    std::vector<uint8_t> m_Buffer;
+};
+
+}  // namespace Graphics
@@ -0,0 +1,14 @@
+#include <Graphics/GamePad.hpp>
+
+using namespace Graphics;
+
+// There are no game pads connected to a headless window.
+GamePadState GamePad::getState( int, DeadZone )
+{
+    return {};
+}
+
+bool GamePad::setVibration( int, float, float, float, float )
+{
+    return false;
+}
@@ -0,0 +1,65 @@
+#include <Graphics/Events.hpp>
+#include <Graphics/Keyboard.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+using namespace Graphics;
+
+static_assert( sizeof( KeyboardState ) == 256 / 8 );
+
+// Global keyboard state.
+static KeyboardState state {};
+// Mutex to protect shared access to keyboard state.
+static std::mutex    stateMutex;
+
+KeyboardState Keyboard::getState()
+{
+    std::lock_guard lock( stateMutex );
+
+    state.ShiftKey = state.LeftShift || state.RightShift;
+    state.ControlKey = state.LeftControl || state.RightControl;
+    state.AltKey = state.LeftAlt || state.RightAlt;
+
+    return state;
+}
+
+void Keyboard::reset()
+{
+    std::lock_guard lock( stateMutex );
+
+    memset( &state, 0, sizeof( KeyboardState ) );
+}
+
+static void setKey( int key, bool down ) noexcept
+{
+    if ( key < 0 || key > 0xfe )
+        return;
+
+    std::lock_guard lock { stateMutex };
+
+    const auto ptr = reinterpret_cast<uint32_t*>( &state );
+
+    const unsigned int bf = 1u << ( key & 0x1f );
+    if ( down )
+        ptr[( key >> 5 )] |= bf;
+    else
+        ptr[( key >> 5 )] &= ~bf;
+}
+
+// Update the keyboard state from the (replayed) events of a headless window.
+void Keyboard_ProcessEvent( const Event& event )
+{
+    switch ( event.type )
+    {
+    case Event::KeyPressed:
+        setKey( static_cast<int>( event.key.code ), true );
+        break;
+    case Event::KeyReleased:
+        setKey( static_cast<int>( event.key.code ), false );
+        break;
+    default:
+        break;
+    }
+}
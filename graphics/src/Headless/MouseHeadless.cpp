@@ -0,0 +1,178 @@
+#include <Graphics/Events.hpp>
+#include <Graphics/Mouse.hpp>
+#include <Graphics/Window.hpp>
+
+#include <mutex>
+
+using namespace Graphics;
+
+// The state of the mouse is updated by the (replayed) events of a headless window.
+static MouseState g_globalState {};
+static glm::ivec2 g_position {};
+static bool       g_locked  = false;
+static bool       g_visible = true;
+static std::mutex g_stateMutex;
+
+bool Mouse::isConnected()
+{
+    return true;
+}
+
+bool Mouse::isVisible()
+{
+    std::lock_guard lock( g_stateMutex );
+    return g_visible;
+}
+
+void Mouse::setVisible( bool visible )
+{
+    std::lock_guard lock( g_stateMutex );
+    g_visible = visible;
+}
+
+void Mouse::lockToWindow( const Window& )
+{
+    std::lock_guard lock( g_stateMutex );
+
+    if ( !g_locked )
+    {
+        g_locked        = true;
+        g_globalState.x = 0;
+        g_globalState.y = 0;
+    }
+}
+
+void Mouse::unlock()
+{
+    std::lock_guard lock( g_stateMutex );
+
+    if ( g_locked )
+    {
+        g_locked        = false;
+        g_globalState.x = g_position.x;
+        g_globalState.y = g_position.y;
+    }
+}
+
+bool Mouse::isLocked()
+{
+    std::lock_guard lock( g_stateMutex );
+    return g_locked;
+}
+
+MouseState Mouse::getState()
+{
+    std::lock_guard lock( g_stateMutex );
+
+    const MouseState state = g_globalState;
+
+    if ( g_locked )  // If the mouse is locked to a window, reset the x and y position of
+                     // the mouse.
+    {
+        g_globalState.x = 0;
+        g_globalState.y = 0;
+    }
+
+    return state;
+}
+
+glm::ivec2 Mouse::getPosition()
+{
+    std::lock_guard lock( g_stateMutex );
+    return g_position;
+}
+
+glm::ivec2 Mouse::getPosition( const Window& )
+{
+    // The headless window is located at the origin of the screen.
+    return getPosition();
+}
+
+void Mouse::setPosition( const glm::ivec2& pos )
+{
+    std::lock_guard lock( g_stateMutex );
+    g_position            = pos;
+    g_globalState.screenX = pos.x;
+    g_globalState.screenY = pos.y;
+
+    if ( !g_locked )
+    {
+        g_globalState.x = pos.x;
+        g_globalState.y = pos.y;
+    }
+}
+
+void Mouse::setPosition( const glm::ivec2& pos, const Window& )
+{
+    setPosition( pos );
+}
+
+static void moveTo( int x, int y )
+{
+    if ( g_locked )
+    {
+        // When the cursor is locked to a window, the state's x, and y
+        // coordinates become relative movements.
+        g_globalState.x += x - g_position.x;
+        g_globalState.y += y - g_position.y;
+    }
+    else
+    {
+        g_globalState.x = x;
+        g_globalState.y = y;
+    }
+
+    g_globalState.screenX = x;
+    g_globalState.screenY = y;
+    g_position            = { x, y };
+}
+
+static void setButton( MouseButton button, bool down )
+{
+    switch ( button )
+    {
+    case MouseButton::Left:
+        g_globalState.leftButton = down;
+        break;
+    case MouseButton::Right:
+        g_globalState.rightButton = down;
+        break;
+    case MouseButton::Middle:
+        g_globalState.middleButton = down;
+        break;
+    case MouseButton::XButton1:
+        g_globalState.xButton1 = down;
+        break;
+    case MouseButton::XButton2:
+        g_globalState.xButton2 = down;
+        break;
+    default:
+        break;
+    }
+}
+
+// Update the mouse state from the (replayed) events of a headless window.
+void Mouse_ProcessEvent( const Event& event )
+{
+    std::lock_guard lock( g_stateMutex );
+
+    switch ( event.type )
+    {
+    case Event::MouseMoved:
+        moveTo( event.mouseMove.x, event.mouseMove.y );
+        break;
+    case Event::MouseButtonPressed:
+    case Event::MouseButtonReleased:
+        moveTo( event.mouseButton.x, event.mouseButton.y );
+        setButton( event.mouseButton.button, event.type == Event::MouseButtonPressed );
+        break;
+    case Event::MouseWheel:
+        g_globalState.vScrollWheel += event.mouseWheel.wheelDelta;
+        break;
+    case Event::MouseHWheel:
+        g_globalState.hScrollWheel += event.mouseWheel.wheelDelta;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,47 @@
+#include "PixelStreamMemory.hpp"
+
+#include <cstring>
+
+using namespace Graphics;
+using namespace Math;
+
+const Image& PixelStreamMemory::stream( const Image& image )
+{
+    m_Texture.resetDirtyRects();
+    upload( image );
+
+    return m_Texture;
+}
+
+void PixelStreamMemory::allocate( uint32_t width, uint32_t height )
+{
+    m_Texture.resize( width, height );
+    m_Texture.setDirtyTracking( true );
+    m_Texture.resetDirtyRects();
+
+    for ( auto& staging: m_Staging )
+        staging = std::make_unique<Color[]>( static_cast<size_t>( width ) * height );
+}
+
+Color* PixelStreamMemory::acquire( uint32_t slot )
+{
+    return m_Staging[slot].get();
+}
+
+void PixelStreamMemory::transfer( uint32_t slot, std::span<const RectI> regions )
+{
+    const Color*   src   = m_Staging[slot].get();
+    Color*         dst   = m_Texture.data();
+    const uint32_t width = m_Texture.getWidth();
+
+    for ( const RectI& r: regions )
+    {
+        for ( int y = r.top; y < r.bottom(); ++y )
+        {
+            const size_t offset = static_cast<size_t>( y ) * width + r.left;
+            std::memcpy( dst + offset, src + offset, r.width * sizeof( Color ) );
+        }
+
+        m_Texture.markDirty( r );
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../PixelStream.hpp"
+
+#include <memory>
+
+namespace Graphics
+{
+/// <summary>
+/// Streams pixels to a texture in system memory.
+/// This mirrors the upload path of the GPU backends (the staging ring, partial transfers, and reallocation on resize),
+/// so the headless window presents exactly what a window would display.
+/// The transfers are executed immediately, so acquiring a staging buffer never waits.
+/// </summary>
+class PixelStreamMemory final : public PixelStream
+{
+public:
+    /// <summary>
+    /// Stream the pixels of an image to the texture.
+    /// </summary>
+    /// <param name="image">The image to upload.</param>
+    /// <returns>The texture. The dirty rectangles of the texture are the regions that were transferred.</returns>
+    const Image& stream( const Image& image );
+
+    /// <summary>
+    /// Get the texture that the pixels are streamed to.
+    /// </summary>
+    const Image& getTexture() const noexcept
+    {
+        return m_Texture;
+    }
+
+protected:
+    void   allocate( uint32_t width, uint32_t height ) override;
+    Color* acquire( uint32_t slot ) override;
+    void   transfer( uint32_t slot, std::span<const Math::RectI> regions ) override;
+
+private:
+    Image                    m_Texture;
+    std::unique_ptr<Color[]> m_Staging[RingSize];
+};
+}  // namespace Graphics
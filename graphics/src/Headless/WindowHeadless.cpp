@@ -0,0 +1,337 @@
+#include "WindowHeadless.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace Graphics;
+
+#if !defined( _WIN32 )
+// Update the state of the headless keyboard and mouse devices.
+extern void Keyboard_ProcessEvent( const Event& event );
+extern void Mouse_ProcessEvent( const Event& event );
+#endif
+
+static std::string getEnvironmentVariable( const char* name )
+{
+    const char* value = std::getenv( name );  // NOLINT(concurrency-mt-unsafe)
+    return value ? value : "";
+}
+
+static uint64_t parseUInt( const std::string& str, uint64_t defaultValue = 0 )
+{
+    uint64_t value = defaultValue;
+    std::from_chars( str.data(), str.data() + str.size(), value );
+    return value;
+}
+
+static bool parseKey( std::string name, KeyCode& code )
+{
+    std::ranges::transform( name, name.begin(), []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+
+    if ( name.size() == 1 && std::isalnum( static_cast<unsigned char>( name[0] ) ) )
+    {
+        // Virtual key codes of letters and digits are the same as their (uppercase) ASCII codes.
+        code = static_cast<KeyCode>( std::toupper( static_cast<unsigned char>( name[0] ) ) );
+        return true;
+    }
+
+    static const std::pair<const char*, KeyCode> keys[] = {
+        { "escape", KeyCode::Escape },
+        { "enter", KeyCode::Enter },
+        { "space", KeyCode::Space },
+        { "tab", KeyCode::Tab },
+        { "backspace", KeyCode::Back },
+        { "left", KeyCode::Left },
+        { "right", KeyCode::Right },
+        { "up", KeyCode::Up },
+        { "down", KeyCode::Down },
+        { "shift", KeyCode::LeftShift },
+        { "ctrl", KeyCode::LeftControl },
+        { "alt", KeyCode::LeftAlt },
+    };
+
+    for ( const auto& [keyName, keyCode]: keys )
+    {
+        if ( name == keyName )
+        {
+            code = keyCode;
+            return true;
+        }
+    }
+
+    // Otherwise, the key must be a numeric virtual key code.
+    unsigned int value = 0;
+    const auto [ptr, ec] = std::from_chars( name.data(), name.data() + name.size(), value );
+    if ( ec != std::errc {} || ptr != name.data() + name.size() || value > 0xff )
+        return false;
+
+    code = static_cast<KeyCode>( value );
+    return true;
+}
+
+static bool parseMouseButton( const std::string& name, MouseButton& button )
+{
+    if ( name == "left" )
+        button = MouseButton::Left;
+    else if ( name == "right" )
+        button = MouseButton::Right;
+    else if ( name == "middle" )
+        button = MouseButton::Middle;
+    else if ( name == "x1" )
+        button = MouseButton::XButton1;
+    else if ( name == "x2" )
+        button = MouseButton::XButton2;
+    else
+        return false;
+
+    return true;
+}
+
+WindowHeadless::WindowHeadless( std::wstring_view, int width, int height )
+: m_Width { width }
+, m_Height { height }
+{
+    const int fps = static_cast<int>( parseUInt( getEnvironmentVariable( "SR_HEADLESS_FPS" ), 60 ) );
+    m_FrameSink   = FrameSink::create( getEnvironmentVariable( "SR_HEADLESS_SINK" ), getEnvironmentVariable( "SR_HEADLESS_OUTPUT" ), fps );
+    m_MaxFrames   = parseUInt( getEnvironmentVariable( "SR_HEADLESS_FRAMES" ) );
+
+    if ( const std::string events = getEnvironmentVariable( "SR_HEADLESS_EVENTS" ); !events.empty() )
+        loadEvents( events );
+}
+
+WindowHeadless::~WindowHeadless() = default;
+
+bool WindowHeadless::isRequested() noexcept
+{
+    const std::string headless = getEnvironmentVariable( "SR_HEADLESS" );
+    return !headless.empty() && headless != "0";
+}
+
+void WindowHeadless::loadEvents( const std::filesystem::path& fileName )
+{
+    std::ifstream file { fileName };
+    if ( !file )
+    {
+        std::cerr << "Failed to open event script: " << fileName.string() << std::endl;
+        return;
+    }
+
+    std::string line;
+    int         lineNumber = 0;
+
+    while ( std::getline( file, line ) )
+    {
+        ++lineNumber;
+
+        std::istringstream ss { line };
+        std::string        type;
+        uint64_t           frame;
+
+        if ( line.empty() || line[0] == '#' || line[0] == '\r' )
+            continue;
+
+        if ( !( ss >> frame >> type ) )
+        {
+            std::cerr << fileName.string() << "(" << lineNumber << "): Expected <frame> <event>." << std::endl;
+            continue;
+        }
+
+        Event e {};
+        bool  valid = false;
+
+        if ( type == "close" )
+        {
+            e.type = Event::Close;
+            valid  = true;
+        }
+        else if ( type == "key_pressed" || type == "key_released" )
+        {
+            std::string key;
+            e.type = type == "key_pressed" ? Event::KeyPressed : Event::KeyReleased;
+            valid  = ( ss >> key ) && parseKey( key, e.key.code );
+
+            e.key.state     = e.type == Event::KeyPressed ? KeyState::Pressed : KeyState::Released;
+            e.key.character = static_cast<unsigned int>( e.key.code );
+        }
+        else if ( type == "mouse_moved" )
+        {
+            e.type = Event::MouseMoved;
+            valid  = static_cast<bool>( ss >> e.mouseMove.x >> e.mouseMove.y );
+        }
+        else if ( type == "mouse_pressed" || type == "mouse_released" )
+        {
+            std::string button;
+            e.type = type == "mouse_pressed" ? Event::MouseButtonPressed : Event::MouseButtonReleased;
+            valid  = ( ss >> button >> e.mouseButton.x >> e.mouseButton.y ) && parseMouseButton( button, e.mouseButton.button );
+
+            e.mouseButton.state = e.type == Event::MouseButtonPressed ? ButtonState::Pressed : ButtonState::Released;
+        }
+        else if ( type == "mouse_wheel" || type == "mouse_hwheel" )
+        {
+            e.type = type == "mouse_wheel" ? Event::MouseWheel : Event::MouseHWheel;
+            valid  = static_cast<bool>( ss >> e.mouseWheel.wheelDelta );
+        }
+        else if ( type == "resize" )
+        {
+            e.type = Event::Resize;
+            valid  = ( ss >> e.resize.width >> e.resize.height ) && e.resize.width > 0 && e.resize.height > 0;
+
+            e.resize.state = WindowState::Resized;
+        }
+
+        if ( !valid )
+        {
+            std::cerr << fileName.string() << "(" << lineNumber << "): Invalid event: " << line << std::endl;
+            continue;
+        }
+
+        m_Script.push_back( { frame, e } );
+    }
+
+    // Events with the same frame are sent in the order they appear in the script.
+    std::ranges::stable_sort( m_Script, {}, &ScriptedEvent::frame );
+}
+
+void WindowHeadless::show() {}
+
+WindowHandle WindowHeadless::getWindowHandle() const noexcept
+{
+    // There is no native window.
+    return nullptr;
+}
+
+void WindowHeadless::setVSync( bool enabled )
+{
+    // There is no display to synchronize with.
+    vSync = enabled;
+}
+
+void WindowHeadless::toggleVSync()
+{
+    setVSync( !vSync );
+}
+
+bool WindowHeadless::isVSync() const noexcept
+{
+    return vSync;
+}
+
+void WindowHeadless::clear( const Color& ) {}
+
+void WindowHeadless::present( const Image& image )
+{
+    // Stream the image through the same upload path as a window, so the sink receives what would be displayed.
+    if ( m_FrameSink->readsPixels() )
+        m_FrameSink->write( m_PixelStream.stream( image ) );
+
+    ++m_FrameIndex;
+}
+
+void WindowHeadless::releaseContext()
+{
+    // Headless windows are not bound to a thread.
+}
+
+void WindowHeadless::processEvents()
+{
+    // Send all of the events that are scheduled before the next frame.
+    while ( m_ScriptPosition < m_Script.size() && m_Script[m_ScriptPosition].frame <= m_FrameIndex )
+    {
+        Event e = m_Script[m_ScriptPosition++].event;
+
+        switch ( e.type )
+        {
+        case Event::MouseMoved:
+            e.mouseMove.screenX = e.mouseMove.x;
+            e.mouseMove.screenY = e.mouseMove.y;
+            e.mouseMove.relX    = e.mouseMove.x - previousMouseX;
+            e.mouseMove.relY    = e.mouseMove.y - previousMouseY;
+            previousMouseX      = e.mouseMove.x;
+            previousMouseY      = e.mouseMove.y;
+            break;
+        case Event::MouseButtonPressed:
+        case Event::MouseButtonReleased:
+            e.mouseButton.screenX = e.mouseButton.x;
+            e.mouseButton.screenY = e.mouseButton.y;
+            break;
+        case Event::MouseWheel:
+        case Event::MouseHWheel:
+            e.mouseWheel.x = e.mouseWheel.screenX = previousMouseX;
+            e.mouseWheel.y = e.mouseWheel.screenY = previousMouseY;
+            break;
+        case Event::Resize:
+            m_Width  = e.resize.width;
+            m_Height = e.resize.height;
+            break;
+        default:
+            break;
+        }
+
+#if !defined( _WIN32 )
+        Keyboard_ProcessEvent( e );
+        Mouse_ProcessEvent( e );
+#endif
+
+        pushEvent( e );
+    }
+
+    if ( m_MaxFrames > 0 && m_FrameIndex >= m_MaxFrames && !m_Closing )
+    {
+        m_Closing = true;
+
+        Event e {};
+        e.type = Event::Close;
+        pushEvent( e );
+    }
+}
+
+bool WindowHeadless::pushEvent( const Event& event )
+{
+    return m_EventQueue.push( event );
+}
+
+bool WindowHeadless::popEvent( Event& event )
+{
+    if ( m_EventQueue.pop( event ) )
+        return true;
+
+    processEvents();
+
+    return m_EventQueue.pop( event );
+}
+
+int WindowHeadless::getWidth() const noexcept
+{
+    return m_Width;
+}
+
+int WindowHeadless::getHeight() const noexcept
+{
+    return m_Height;
+}
+
+glm::ivec2 WindowHeadless::getSize() const noexcept
+{
+    return { m_Width, m_Height };
+}
+
+void WindowHeadless::setFullscreen( bool _fullscreen )
+{
+    fullscreen = _fullscreen;
+}
+
+bool WindowHeadless::isFullscreen() const noexcept
+{
+    return fullscreen;
+}
+
+void WindowHeadless::toggleFullscreen()
+{
+    setFullscreen( !fullscreen );
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../EventQueue.hpp"
+#include "FrameSink.hpp"
+#include "PixelStreamMemory.hpp"
+
+#include <Graphics/Config.hpp>
+#include <Graphics/Events.hpp>
+#include <Graphics/WindowImpl.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// An offscreen window that is used to run applications unattended (for example, on a build or render server).
+/// Presented frames are passed to a <see cref="FrameSink"/> and the events are replayed from a script.
+/// The window is configured with the following environment variables:
+///  - SR_HEADLESS_SINK: The frame sink ("null", "png", "qoi", "y4m", or "rgb"). Default is "null".
+///  - SR_HEADLESS_OUTPUT: The output file (prefix) of the frame sink. Use "-" to pipe a video stream to the standard output.
+///  - SR_HEADLESS_FPS: The frame rate written to Y4M streams. Default is 60.
+///  - SR_HEADLESS_EVENTS: The event script to replay.
+///  - SR_HEADLESS_FRAMES: If set, a `Close` event is sent after the specified number of frames has been presented.
+/// On Windows, the headless window is used instead of a Win32 window if SR_HEADLESS is set to a non-zero value.
+/// </summary>
+/// <remarks>
+/// Each line in the event script is an event that is sent just before the frame with the specified (0-based) index is presented.
+/// Empty lines and lines starting with '#' are ignored.
+///  - &lt;frame&gt; close
+///  - &lt;frame&gt; key_pressed &lt;key&gt;
+///  - &lt;frame&gt; key_released &lt;key&gt;
+///  - &lt;frame&gt; mouse_moved &lt;x&gt; &lt;y&gt;
+///  - &lt;frame&gt; mouse_pressed &lt;button&gt; &lt;x&gt; &lt;y&gt;
+///  - &lt;frame&gt; mouse_released &lt;button&gt; &lt;x&gt; &lt;y&gt;
+///  - &lt;frame&gt; mouse_wheel &lt;delta&gt;
+///  - &lt;frame&gt; mouse_hwheel &lt;delta&gt;
+///  - &lt;frame&gt; resize &lt;width&gt; &lt;height&gt;
+/// Keys are either a virtual key code (see <see cref="KeyCode"/>), a letter or digit, or one of
+/// escape, enter, space, tab, backspace, left, right, up, down, shift, ctrl, or alt.
+/// Mouse buttons are left, right, middle, x1, or x2.
+/// </remarks>
+class SR_API WindowHeadless : public WindowImpl
+{
+public:
+    WindowHeadless( std::wstring_view title, int width, int height );
+    ~WindowHeadless() override;
+
+    /// <summary>
+    /// Check if the headless window was requested through the environment (SR_HEADLESS).
+    /// </summary>
+    static bool isRequested() noexcept;
+
+    void show() override;
+
+    WindowHandle getWindowHandle() const noexcept override;
+
+    void setVSync( bool enabled ) override;
+
+    void toggleVSync() override;
+
+    bool isVSync() const noexcept override;
+
+    void clear( const Color& color ) override;
+
+    void present( const Image& image ) override;
+
+    void releaseContext() override;
+
+    bool popEvent( Event& event ) override;
+
+    bool pushEvent( const Event& event ) override;
+
+    int getWidth() const noexcept override;
+
+    int getHeight() const noexcept override;
+
+    glm::ivec2 getSize() const noexcept override;
+
+    void setFullscreen( bool fullscreen ) override;
+
+    bool isFullscreen() const noexcept override;
+
+    void toggleFullscreen() override;
+
+protected:
+    void loadEvents( const std::filesystem::path& fileName );
+
+    void processEvents();
+
+private:
+    struct ScriptedEvent
+    {
+        uint64_t frame;
+        Event    event;
+    };
+
+    int  m_Width;
+    int  m_Height;
+    bool vSync      = true;
+    bool fullscreen = false;
+
+    int previousMouseX = 0;
+    int previousMouseY = 0;
+
+    std::atomic<uint64_t>      m_FrameIndex = 0;  ///< The number of frames that have been presented (frames can be presented from another thread).
+    uint64_t                   m_MaxFrames  = 0;  ///< Close the window after this many frames (0 to run indefinitely).
+    bool                       m_Closing    = false;
+    std::unique_ptr<FrameSink> m_FrameSink;
+    PixelStreamMemory          m_PixelStream;  ///< Streams the presented images to the frame sink.
+    std::vector<ScriptedEvent> m_Script;  ///< Events sorted by frame.
+    size_t                     m_ScriptPosition = 0;
+    EventQueue                 m_EventQueue;  ///< Events from the script and other threads.
+};
+}  // namespace Graphics
@@ -1,26 +1,908 @@
+#include <Graphics/DepthBuffer.hpp>
 #include <Graphics/Font.hpp>
 #include <Graphics/Image.hpp>
 #include <Graphics/Sprite.hpp>
+#include <Graphics/TextureFile.hpp>
+#include <Graphics/ThreadPool.hpp>
 #include <Graphics/Vertex.hpp>
 
 #include <Math/AABB.hpp>
 #include <Math/Math.hpp>
 
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "BlendSpan.hpp"
+#include "CommandBuffer.hpp"
+#include "GlyphRun.hpp"
+#include "Rasterizer.hpp"
+#include "TextureSampler.hpp"
+
 #include <stb_image.h>
 #include <stb_image_write.h>
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <numbers>
 #include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 using namespace Graphics;
 using namespace Math;
 
+// Sampling a texture is several times more expensive than writing a solid pixel.
+constexpr int64_t TexturedPixelCost = 4;
+
+// The size of the tiles that the triangles of drawIndexed are binned into in immediate mode (the default of deferred mode).
+constexpr uint32_t IndexedTileSize = 64u;
+
+// Clears of (contiguous) regions larger than this (in bytes) use streaming stores that bypass the cache.
+constexpr size_t StreamingClearSize = 4 * 1024 * 1024;
+
+/// <summary>
+/// Invoke a function for each row in the range [yBegin, yEnd).
+/// The rows are distributed over the threads of the thread pool. Small regions
+/// (and regions of the tiles of a deferred command buffer, which are already processed in parallel)
+/// are processed on the calling thread.
+/// </summary>
+/// <param name="yBegin">The first row.</param>
+/// <param name="yEnd">One past the last row.</param>
+/// <param name="costPerRow">The (estimated) cost of a row, in pixels.</param>
+/// <param name="rowFunc">The function to invoke for each row.</param>
+template<typename RowFunc>
+static void parallelRows( int yBegin, int yEnd, int64_t costPerRow, RowFunc&& rowFunc )
+{
+    ThreadPool::get().parallelFor(
+        yBegin, yEnd, [&]( int first, int last ) {
+            for ( int y = first; y < last; ++y )
+                rowFunc( y );
+        },
+        costPerRow );
+}
+
+/// <summary>
+/// Rasterize a convex polygon that is clipped to a region of the image.
+/// The rows of the polygon are processed in parallel.
+/// </summary>
+/// <param name="polygon">The polygon to rasterize.</param>
+/// <param name="clip">The region of the image that can be written to.</param>
+/// <param name="spanFunc">The function to invoke for each span of covered pixels.</param>
+/// <param name="pixelCost">(optional) The (estimated) cost of a pixel, relative to a solid pixel.</param>
+template<int N, typename SpanFunc>
+static void rasterize( const EdgeRasterizer<N>& polygon, const AABB& clip, SpanFunc&& spanFunc, int64_t pixelCost = 1 )
+{
+    if ( polygon.empty() )
+        return;
+
+    const int yBegin = std::max( polygon.minY(), static_cast<int>( clip.min.y ) );
+    const int yEnd   = std::min( polygon.maxY(), static_cast<int>( clip.max.y ) ) + 1;
+    const int xMin   = static_cast<int>( clip.min.x );
+    const int xMax   = static_cast<int>( clip.max.x );
+
+    if ( yBegin >= yEnd )
+        return;
+
+    // Estimate the cost of a row by the width of the polygon.
+    const int64_t costPerRow = std::max( std::min( polygon.maxX(), xMax ) - std::max( polygon.minX(), xMin ) + 1, 1 ) * pixelCost;
+
+    ThreadPool::get().parallelFor(
+        yBegin, yEnd, [&]( int first, int last ) {
+            polygon.forEachSpan( first, last, xMin, xMax, spanFunc );
+        },
+        costPerRow );
+}
+
+/// <summary>
+/// Draw an axis-aligned rectangle of texels whose texture coordinates are a linear function of x (for the columns)
+/// and y (for the rows), for example a scaled or mirrored sprite. The texture coordinates are stepped incrementally
+/// (nearest-neighbor) and each row is blended with a span kernel, so there is no per-pixel inside test.
+/// </summary>
+/// <param name="dst">The destination pixels.</param>
+/// <param name="stride">The number of pixels in a row of the destination image.</param>
+/// <param name="x0">The first column to write.</param>
+/// <param name="y0">The first row to write.</param>
+/// <param name="x1">One past the last column to write.</param>
+/// <param name="y1">One past the last row to write.</param>
+/// <param name="uvOrigin">The texel coordinate at pixel (0, 0). The texel coordinates don't depend on the written region,
+/// so a tile of a deferred command buffer samples the same texels as the entire image.</param>
+/// <param name="duv">The change in texel coordinates per pixel step in x and y.</param>
+/// <param name="tint">The color to multiply the texels with.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+/// <param name="fetch">Returns the texel at integer coordinates: `fetch( u, v )`.</param>
+template<typename Fetch>
+static void drawScaledRows( Color* dst, uint32_t stride, int x0, int y0, int x1, int y1, const glm::vec2& uvOrigin, const glm::vec2& duv, const Color& tint, const BlendMode& blendMode, Fetch&& fetch )
+{
+    if ( x0 >= x1 || y0 >= y1 )
+        return;
+
+    // Step through the texel columns in 16.16 fixed-point (the half texel offset rounds to the nearest texel).
+    const int64_t uStep   = std::llround( static_cast<double>( duv.x ) * 65536.0 );
+    const int64_t uOrigin = std::llround( ( static_cast<double>( uvOrigin.x ) + 0.5 ) * 65536.0 );
+
+    parallelRows( y0, y1, static_cast<int64_t>( x1 - x0 ) * TexturedPixelCost, [&]( int y ) {
+        const int v = static_cast<int>( std::floor( uvOrigin.y + static_cast<float>( y ) * duv.y + 0.5f ) );
+
+        // Gather the texels of the row in small chunks, and blend each chunk with the span kernel.
+        constexpr int ChunkSize = 64;
+        Color         texels[ChunkSize];
+        int64_t       u = uOrigin + x0 * uStep;
+
+        for ( int x = x0; x < x1; x += ChunkSize )
+        {
+            const int count = std::min( ChunkSize, x1 - x );
+            for ( int i = 0; i < count; ++i, u += uStep )
+                texels[i] = fetch( static_cast<int>( u >> 16 ), v );
+
+            blendSpan( dst + static_cast<size_t>( y ) * stride + x, texels, count, tint, blendMode );
+        }
+    } );
+}
+
+/// <summary>
+/// Same as drawScaledRows, but the texels are filtered by a sampler.
+/// </summary>
+static void drawFilteredRows( Color* dst, uint32_t stride, int x0, int y0, int x1, int y1, const glm::vec2& uvOrigin, const glm::vec2& duv, const Color& tint, const BlendMode& blendMode, const TextureSampler& sampler )
+{
+    if ( x0 >= x1 || y0 >= y1 )
+        return;
+
+    parallelRows( y0, y1, static_cast<int64_t>( x1 - x0 ) * TexturedPixelCost, [&]( int y ) {
+        constexpr int ChunkSize = 64;
+        Color         texels[ChunkSize];
+        glm::vec2     uv = uvOrigin + glm::vec2 { x0, y } * duv;
+
+        for ( int x = x0; x < x1; x += ChunkSize )
+        {
+            const int count = std::min( ChunkSize, x1 - x );
+            for ( int i = 0; i < count; ++i, uv.x += duv.x )
+                texels[i] = sampler( uv );
+
+            blendSpan( dst + static_cast<size_t>( y ) * stride + x, texels, count, tint, blendMode );
+        }
+    } );
+}
+
+/// <summary>
+/// Compute the level of detail of a triangle from the change in texture coordinates over the triangle.
+/// The texture coordinates are affine across the triangle, so the level of detail is the same for every pixel.
+/// </summary>
+/// <param name="p0">The positions of the triangle vertices.</param>
+/// <param name="t0">The texture coordinates (in texels) of the triangle vertices.</param>
+/// <returns>The level of detail of the triangle.</returns>
+static float triangleLOD( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& t0, const glm::vec2& t1, const glm::vec2& t2 ) noexcept
+{
+    const glm::vec2 e1  = p1 - p0;
+    const glm::vec2 e2  = p2 - p0;
+    const float     det = e1.x * e2.y - e1.y * e2.x;
+
+    if ( std::abs( det ) < 1e-8f )
+        return 0.0f;
+
+    // Solve the 2x2 system [e1 e2] * d = [dt1 dt2] for the texture coordinate gradients.
+    const glm::vec2 dt1   = t1 - t0;
+    const glm::vec2 dt2   = t2 - t0;
+    const glm::vec2 dUVdx = ( dt1 * e2.y - dt2 * e1.y ) / det;
+    const glm::vec2 dUVdy = ( dt2 * e1.x - dt1 * e2.x ) / det;
+
+    return TextureSampler::computeLOD( dUVdx, dUVdy );
+}
+
+/// <summary>
+/// The vertex attributes of a triangle as planes over the image: a( x, y ) = origin + dx * x + dy * y.
+/// The planes are set up once per primitive, so a span only has to evaluate them at its first pixel
+/// and step them with fixed-point adds.
+/// </summary>
+struct AttributePlanes
+{
+    glm::dvec2 uv, duvdx, duvdy;        ///< The texture coordinates (in texels).
+    glm::dvec4 rgba, drgbadx, drgbady;  ///< The color channels (in the range [0..255]).
+    bool       flat;                    ///< The vertices have the same color, so the color doesn't have to be interpolated.
+    Color      color;                   ///< The color of the vertices (if flat).
+
+    /// <summary>
+    /// Set up the planes of a triangle.
+    /// </summary>
+    /// <param name="a">The vertices of the triangle.</param>
+    /// <param name="texSize">The scale that converts the texture coordinates of the vertices to texels.</param>
+    /// <returns>`false` if the triangle is degenerate (covers less than half a pixel).</returns>
+    bool setup( const Vertex& a, const Vertex& b, const Vertex& c, const glm::vec2& texSize ) noexcept
+    {
+        const glm::dvec2 e1  = glm::dvec2 { b.position } - glm::dvec2 { a.position };
+        const glm::dvec2 e2  = glm::dvec2 { c.position } - glm::dvec2 { a.position };
+        const double     det = e1.x * e2.y - e1.y * e2.x;
+
+        // Skip triangles that cover less than half a pixel (twice the area is less than 1).
+        if ( std::abs( det ) < 1.0 )
+            return false;
+
+        // Solve the 2x2 system [e1 e2] * d = [da1 da2] for the gradients of an attribute,
+        // and extrapolate the attribute to the origin of the image.
+        auto plane = [&]<typename T>( const T& a0, const T& a1, const T& a2, T& origin, T& dx, T& dy ) {
+            const T da1 = a1 - a0;
+            const T da2 = a2 - a0;
+            dx          = ( da1 * e2.y - da2 * e1.y ) / det;
+            dy          = ( da2 * e1.x - da1 * e2.x ) / det;
+            origin      = a0 - dx * static_cast<double>( a.position.x ) - dy * static_cast<double>( a.position.y );
+        };
+
+        const glm::dvec2 scale { texSize };
+        plane( glm::dvec2 { a.texCoord } * scale, glm::dvec2 { b.texCoord } * scale, glm::dvec2 { c.texCoord } * scale, uv, duvdx, duvdy );
+
+        flat  = a.color == b.color && a.color == c.color;
+        color = a.color;
+
+        if ( !flat )
+        {
+            auto channels = []( const Color& v ) { return glm::dvec4 { v.r, v.g, v.b, v.a }; };
+            plane( channels( a.color ), channels( b.color ), channels( c.color ), rgba, drgbadx, drgbady );
+        }
+
+        return true;
+    }
+};
+
+/// <summary>
+/// Shade a span of a textured primitive. The texture coordinates (16.16 fixed-point texels) and
+/// the color (16.16 fixed-point channels) are stepped incrementally from pixel to pixel, and the texels
+/// are blended in chunks with the span kernel.
+/// </summary>
+/// <param name="dst">The first pixel of the span.</param>
+/// <param name="x">The first column of the span.</param>
+/// <param name="y">The row of the span.</param>
+/// <param name="count">The number of pixels in the span.</param>
+/// <param name="planes">The vertex attributes of the primitive.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+/// <param name="fetch">Returns the texel at fixed-point texel coordinates: `fetch( u, v )`.</param>
+template<typename Fetch>
+static void shadeSpan( Color* dst, int x, int y, int count, const AttributePlanes& planes, const BlendMode& blendMode, Fetch&& fetch )
+{
+    constexpr double One = 65536.0;
+
+    // The fixed-point attributes are stepped from the start of the row (x = 0), so the value at a pixel doesn't depend on
+    // where its span starts (a span can be split at the edges of the tiles of a deferred image).
+    const glm::dvec2 uv = planes.uv + planes.duvdy * static_cast<double>( y );
+
+    const int64_t du = roundToInt64( planes.duvdx.x * One );
+    const int64_t dv = roundToInt64( planes.duvdx.y * One );
+    int64_t       u  = roundToInt64( uv.x * One ) + du * x;
+    int64_t       v  = roundToInt64( uv.y * One ) + dv * x;
+
+    constexpr int ChunkSize = 64;
+    Color         texels[ChunkSize];
+
+    if ( planes.flat )
+    {
+        for ( int i = 0; i < count; i += ChunkSize )
+        {
+            const int n = std::min( ChunkSize, count - i );
+            for ( int j = 0; j < n; ++j, u += du, v += dv )
+                texels[j] = fetch( u, v );
+
+            blendSpan( dst + i, texels, n, planes.color, blendMode );
+        }
+        return;
+    }
+
+    // The color channels are rounded to the nearest integer (the half is added to the start value).
+    const glm::dvec4 rgba = planes.rgba + planes.drgbady * static_cast<double>( y );
+
+    int32_t c[4], dc[4];
+    for ( int k = 0; k < 4; ++k )
+    {
+        const int64_t step = roundToInt64( planes.drgbadx[k] * One );
+
+        c[k]  = static_cast<int32_t>( roundToInt64( rgba[k] * One ) + 0x8000 + step * x );
+        dc[k] = static_cast<int32_t>( step );
+    }
+
+    // The channels are clamped, because the pixels at the edges can be slightly outside of the primitive.
+    auto channel = []( int32_t value ) { return static_cast<uint8_t>( std::clamp( value >> 16, 0, 255 ) ); };
+
+    for ( int i = 0; i < count; i += ChunkSize )
+    {
+        const int n = std::min( ChunkSize, count - i );
+        for ( int j = 0; j < n; ++j, u += du, v += dv )
+        {
+            texels[j] = fetch( u, v ) * Color { channel( c[0] ), channel( c[1] ), channel( c[2] ), channel( c[3] ) };
+
+            for ( int k = 0; k < 4; ++k )
+                c[k] += dc[k];
+        }
+
+        blendSpan( dst + i, texels, n, Color::White, blendMode );
+    }
+}
+
+/// <summary>
+/// Check if the vertex attributes are affine across the entire quad (the quad is a parallelogram in both
+/// image and texture space, for example a transformed sprite). Then the whole quad is a single primitive.
+/// </summary>
+static bool isAffineQuad( const Vertex ( &verts )[4], const glm::vec2& texSize ) noexcept
+{
+    // Within the sub-pixel precision of the rasterizer.
+    constexpr float Epsilon = 1.0f / SubPixelScale;
+
+    const glm::vec2 dp = verts[0].position + verts[2].position - verts[1].position - verts[3].position;
+    const glm::vec2 dt = ( verts[0].texCoord + verts[2].texCoord - verts[1].texCoord - verts[3].texCoord ) * texSize;
+
+    auto channels = []( const Color& v ) { return glm::ivec4 { v.r, v.g, v.b, v.a }; };
+
+    return std::abs( dp.x ) <= Epsilon && std::abs( dp.y ) <= Epsilon && std::abs( dt.x ) <= Epsilon && std::abs( dt.y ) <= Epsilon &&
+           channels( verts[0].color ) + channels( verts[2].color ) == channels( verts[1].color ) + channels( verts[3].color );
+}
+
+/// <summary>
+/// Rasterize a textured quad that is clipped to a region of the image.
+/// The vertex attributes are set up once, and each span is shaded incrementally (see <see cref="shadeSpan"/>).
+/// A quad with affine attributes is rasterized as a single convex polygon. Other quads are the two triangles
+/// (0, 1, 3) and (1, 2, 3), each with their own attributes; pixels that are covered by both triangles (the shared
+/// edge, or the overlap of a concave quad) are only drawn once, by the second triangle.
+/// Pixels exactly on the edges of the quad are covered (the vertices are at the centers of the outer texels of sprites).
+/// </summary>
+/// <param name="image">The image to draw to.</param>
+/// <param name="verts">The vertices of the quad.</param>
+/// <param name="texSize">The scale that converts the texture coordinates of the vertices to texels.</param>
+/// <param name="clip">The region of the image that can be written to.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+/// <param name="fetch">Returns the texel at 16.16 fixed-point texel coordinates: `fetch( u, v )`.</param>
+template<typename Fetch>
+static void drawTexturedQuad( Image& image, const Vertex ( &verts )[4], const glm::vec2& texSize, const AABB& clip, const BlendMode& blendMode, Fetch&& fetch )
+{
+    Color* const   pixels = image.data();
+    const uint32_t stride = image.getWidth();
+
+    auto shade = [&]( int y, int x0, int x1, const AttributePlanes& planes ) {
+        shadeSpan( pixels + static_cast<size_t>( y ) * stride + x0, x0, y, x1 - x0 + 1, planes, blendMode, fetch );
+    };
+
+    AttributePlanes planes[2];
+
+    if ( isAffineQuad( verts, texSize ) )
+    {
+        if ( !planes[0].setup( verts[0], verts[1], verts[3], texSize ) )
+            return;
+
+        const glm::vec2 positions[] = { verts[0].position, verts[1].position, verts[2].position, verts[3].position };
+
+        rasterize(
+            EdgeRasterizer<4> { positions, true }, clip, [&]( int y, int x0, int x1 ) {
+                shade( y, x0, x1, planes[0] );
+            },
+            TexturedPixelCost );
+        return;
+    }
+
+    const bool valid[] = {
+        planes[0].setup( verts[0], verts[1], verts[3], texSize ),
+        planes[1].setup( verts[1], verts[2], verts[3], texSize ),
+    };
+
+    const glm::vec2 positions0[] = { verts[0].position, verts[1].position, verts[3].position };
+    const glm::vec2 positions1[] = { verts[1].position, verts[2].position, verts[3].position };
+
+    const EdgeRasterizer<3> triangles[] = {
+        EdgeRasterizer<3> { positions0, true },
+        EdgeRasterizer<3> { positions1, true },
+    };
+
+    const int xMin   = static_cast<int>( clip.min.x );
+    const int xMax   = static_cast<int>( clip.max.x );
+    const int yBegin = std::max( std::min( triangles[0].minY(), triangles[1].minY() ), static_cast<int>( clip.min.y ) );
+    const int yEnd   = std::min( std::max( triangles[0].maxY(), triangles[1].maxY() ), static_cast<int>( clip.max.y ) ) + 1;
+
+    if ( yBegin >= yEnd )
+        return;
+
+    parallelRows( yBegin, yEnd, static_cast<int64_t>( xMax - xMin + 1 ) * TexturedPixelCost, [&]( int y ) {
+        int a0, a1, b0 = 0, b1 = -1;
+
+        if ( valid[1] && triangles[1].span( y, xMin, xMax, b0, b1 ) )
+            shade( y, b0, b1, planes[1] );
+
+        if ( !valid[0] || !triangles[0].span( y, xMin, xMax, a0, a1 ) )
+            return;
+
+        // The part of the span of the first triangle to the left and to the right of the span of the second triangle.
+        if ( b0 > b1 )
+        {
+            shade( y, a0, a1, planes[0] );
+            return;
+        }
+
+        if ( a0 < b0 )
+            shade( y, a0, std::min( a1, b0 - 1 ), planes[0] );
+        if ( a1 > b1 )
+            shade( y, std::max( a0, b1 + 1 ), a1, planes[0] );
+    } );
+}
+
+// Round towards negative infinity (std::floor is a library call without SSE4.1).
+static int floorToInt( float f ) noexcept
+{
+    const int i = static_cast<int>( f );
+    return i - ( f < static_cast<float>( i ) ? 1 : 0 );
+}
+
+/// <summary>
+/// A vertex of a 3D primitive after it has been clipped and projected to the image.
+/// </summary>
+struct ProjectedVertex
+{
+    glm::vec2 position;  ///< The position in pixels.
+    float     depth;     ///< The depth in the range [0..1].
+    float     invW;      ///< 1 / w (for perspective-correct interpolation).
+    glm::vec2 texCoord;
+    glm::vec4 color;  ///< The color channels (in the range [0..255]).
+};
+
+// A triangle that is clipped against the 7 planes of the view volume has at most 10 vertices.
+constexpr int MaxClippedVertices = 10;
+
+/// <summary>
+/// Clip a 3D triangle to the view volume and project the vertices of the clipped polygon to the image.
+/// Triangles that are completely inside the view volume (the common case) are only projected.
+/// </summary>
+/// <param name="verts">The vertices of the triangle (in clip space).</param>
+/// <param name="width">The width of the image (in pixels).</param>
+/// <param name="height">The height of the image (in pixels).</param>
+/// <param name="cullMode">The triangles to skip based on their winding order.</param>
+/// <param name="polygon">Receives the vertices of the clipped (convex) polygon.</param>
+/// <returns>The number of vertices of the polygon, or 0 if the triangle is outside the view volume, culled, or degenerate.</returns>
+static int clipTriangle( const ClipVertex ( &verts )[3], float width, float height, CullMode cullMode, ProjectedVertex ( &polygon )[MaxClippedVertices] ) noexcept
+{
+    struct Vertex4
+    {
+        glm::vec4 position;
+        glm::vec2 texCoord;
+        glm::vec4 color;
+    };
+
+    // The signed distance of a vertex to each clip plane (positive inside). The last plane keeps
+    // w away from 0, for projection matrices that don't clip the vertices behind the viewer with the near plane.
+    constexpr int   NumPlanes = 7;
+    constexpr float MinW      = 1e-5f;
+
+    auto distance = []( int plane, const glm::vec4& p ) noexcept {
+        switch ( plane )
+        {
+        case 0: return p.w + p.x;
+        case 1: return p.w - p.x;
+        case 2: return p.w + p.y;
+        case 3: return p.w - p.y;
+        case 4: return p.w + p.z;
+        case 5: return p.w - p.z;
+        default: return p.w - MinW;
+        }
+    };
+
+    auto outCode = [&]( const glm::vec4& p ) noexcept {
+        uint32_t code = 0;
+        for ( int plane = 0; plane < NumPlanes; ++plane )
+            code |= distance( plane, p ) < 0.0f ? 1u << plane : 0u;
+
+        return code;
+    };
+
+    const uint32_t codes[] = { outCode( verts[0].position ), outCode( verts[1].position ), outCode( verts[2].position ) };
+
+    // All vertices are outside of the same plane.
+    if ( codes[0] & codes[1] & codes[2] )
+        return 0;
+
+    Vertex4 buffers[2][MaxClippedVertices];
+    int     count = 3;
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        const Color& c = verts[i].color;
+        buffers[0][i]  = { verts[i].position, verts[i].texCoord, glm::vec4 { c.r, c.g, c.b, c.a } };
+    }
+
+    // Sutherland-Hodgman: clip the polygon against each plane that one of the vertices is outside of.
+    const uint32_t clipPlanes = codes[0] | codes[1] | codes[2];
+    int            current    = 0;
+
+    for ( int plane = 0; plane < NumPlanes && count > 0; ++plane )
+    {
+        if ( !( clipPlanes & 1u << plane ) )
+            continue;
+
+        const Vertex4* in  = buffers[current];
+        Vertex4*       out = buffers[current ^ 1];
+        int            n   = 0;
+
+        for ( int i = 0; i < count; ++i )
+        {
+            const Vertex4& a  = in[i];
+            const Vertex4& b  = in[( i + 1 ) % count];
+            const float    da = distance( plane, a.position );
+            const float    db = distance( plane, b.position );
+
+            if ( da >= 0.0f )
+                out[n++] = a;
+
+            // The edge crosses the plane.
+            if ( ( da >= 0.0f ) != ( db >= 0.0f ) )
+            {
+                const float t = da / ( da - db );
+                out[n++]      = { a.position + ( b.position - a.position ) * t, a.texCoord + ( b.texCoord - a.texCoord ) * t, a.color + ( b.color - a.color ) * t };
+            }
+        }
+
+        count = n;
+        current ^= 1;
+    }
+
+    if ( count < 3 )
+        return 0;
+
+    // Project to the image. Pixel (x, y) is at the integer coordinate (x, y), and +y points down.
+    for ( int i = 0; i < count; ++i )
+    {
+        const Vertex4& v    = buffers[current][i];
+        const float    invW = 1.0f / v.position.w;
+
+        polygon[i] = {
+            { ( v.position.x * invW * 0.5f + 0.5f ) * width - 0.5f, ( 0.5f - v.position.y * invW * 0.5f ) * height - 0.5f },
+            std::clamp( v.position.z * invW * 0.5f + 0.5f, 0.0f, 1.0f ),
+            invW,
+            v.texCoord,
+            v.color,
+        };
+    }
+
+    // Twice the signed area of the polygon. Front faces are counter-clockwise with +y up, so they have a negative area with +y down.
+    float area = 0.0f;
+    for ( int i = 0; i < count; ++i )
+    {
+        const glm::vec2& a = polygon[i].position;
+        const glm::vec2& b = polygon[( i + 1 ) % count].position;
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    if ( area == 0.0f || ( cullMode == CullMode::Back && area > 0.0f ) || ( cullMode == CullMode::Front && area < 0.0f ) )
+        return 0;
+
+    return count;
+}
+
+/// <summary>
+/// The vertex attributes of a projected 3D primitive as planes over the image: a( x, y ) = origin + dx * x + dy * y.
+/// The depth is affine in image space. The other attributes are not, but divided by w they are, so the planes
+/// interpolate 1 / w, and the attributes divided by w, and each pixel divides by the interpolated 1 / w.
+/// </summary>
+struct PerspectivePlanes
+{
+    // The attributes: depth, 1 / w, then u, v, r, g, b, a (each divided by w).
+    static constexpr int Depth = 0;
+    static constexpr int InvW  = 1;
+    static constexpr int U     = 2;
+    static constexpr int R     = 4;
+    static constexpr int Count = 8;
+
+    double origin[Count];
+    double dx[Count];
+    double dy[Count];
+
+    /// <summary>
+    /// Set up the planes of a triangle.
+    /// </summary>
+    /// <param name="a">The vertices of the triangle.</param>
+    /// <param name="texSize">The scale that converts the texture coordinates of the vertices to texels.</param>
+    /// <returns>`false` if the triangle is degenerate.</returns>
+    bool setup( const ProjectedVertex& a, const ProjectedVertex& b, const ProjectedVertex& c, const glm::vec2& texSize ) noexcept
+    {
+        const glm::dvec2 e1  = glm::dvec2 { b.position } - glm::dvec2 { a.position };
+        const glm::dvec2 e2  = glm::dvec2 { c.position } - glm::dvec2 { a.position };
+        const double     det = e1.x * e2.y - e1.y * e2.x;
+
+        if ( det == 0.0 )
+            return false;
+
+        auto attributes = [&]( const ProjectedVertex& v, double ( &attr )[Count] ) {
+            attr[Depth] = v.depth;
+            attr[InvW]  = v.invW;
+            attr[U]     = static_cast<double>( v.texCoord.x ) * texSize.x * v.invW;
+            attr[U + 1] = static_cast<double>( v.texCoord.y ) * texSize.y * v.invW;
+
+            for ( int k = 0; k < 4; ++k )
+                attr[R + k] = static_cast<double>( v.color[k] ) * v.invW;
+        };
+
+        double a0[Count], a1[Count], a2[Count];
+        attributes( a, a0 );
+        attributes( b, a1 );
+        attributes( c, a2 );
+
+        // Solve the 2x2 system [e1 e2] * d = [da1 da2] for the gradients of each attribute (see AttributePlanes).
+        for ( int k = 0; k < Count; ++k )
+        {
+            const double da1 = a1[k] - a0[k];
+            const double da2 = a2[k] - a0[k];
+            dx[k]            = ( da1 * e2.y - da2 * e1.y ) / det;
+            dy[k]            = ( da2 * e1.x - da1 * e2.x ) / det;
+            origin[k]        = a0[k] - dx[k] * a.position.x - dy[k] * a.position.y;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Evaluate an attribute at a pixel.
+    /// </summary>
+    float operator()( int k, int x, int y ) const noexcept
+    {
+        return static_cast<float>( origin[k] + dx[k] * x + dy[k] * y );
+    }
+};
+
+/// <summary>
+/// Rasterize a projected (convex) polygon with depth testing. The polygon is drawn as a fan of triangles
+/// that share the attribute planes of the polygon.
+/// The rows are processed in parallel in rows of depth buffer tiles, so the thread that draws a row of tiles
+/// can update the depth range of the tiles it wrote to. Each span is split at the tile boundaries: a part of the span
+/// that is behind the maximum depth of its tile is skipped, and a part that is in front of the minimum depth of its tile
+/// doesn't read the depth buffer. The pixels that fail the depth test are rejected before the texture is sampled.
+/// </summary>
+/// <param name="image">The image to draw to.</param>
+/// <param name="depthBuffer">The depth buffer.</param>
+/// <param name="polygon">The vertices of the polygon.</param>
+/// <param name="count">The number of vertices of the polygon.</param>
+/// <param name="texSize">The scale that converts the texture coordinates of the vertices to texels.</param>
+/// <param name="clip">The region of the image that can be written to. In deferred mode, the region must be aligned to the depth buffer tiles.</param>
+/// <param name="blendMode">The blend mode to apply.</param>
+/// <param name="fetch">Returns the texel at (floating-point) texel coordinates: `fetch( u, v )`, or `nullptr` for an untextured polygon.</param>
+template<typename Fetch>
+static void drawPolygon3D( Image& image, DepthBuffer& depthBuffer, const ProjectedVertex* polygon, int count, const glm::vec2& texSize, const AABB& clip, const BlendMode& blendMode, Fetch&& fetch )
+{
+    constexpr bool Textured = !std::is_null_pointer_v<std::decay_t<Fetch>>;
+    constexpr int  TileSize = static_cast<int>( DepthBuffer::TileSize );
+
+    EdgeRasterizer<3> triangles[MaxClippedVertices - 2];
+    const int         numTriangles = count - 2;
+
+    int   minX = std::numeric_limits<int>::max(), maxX = std::numeric_limits<int>::min();
+    int   minY = std::numeric_limits<int>::max(), maxY = std::numeric_limits<int>::min();
+    float minDepth = 1.0f;
+
+    for ( int i = 0; i < numTriangles; ++i )
+    {
+        const glm::vec2 positions[] = { polygon[0].position, polygon[i + 1].position, polygon[i + 2].position };
+        triangles[i]                = EdgeRasterizer<3> { positions };
+
+        if ( !triangles[i].empty() )
+        {
+            minX = std::min( minX, triangles[i].minX() );
+            maxX = std::max( maxX, triangles[i].maxX() );
+            minY = std::min( minY, triangles[i].minY() );
+            maxY = std::max( maxY, triangles[i].maxY() );
+        }
+    }
+
+    for ( int i = 0; i < count; ++i )
+        minDepth = std::min( minDepth, polygon[i].depth );
+
+    const int xMin   = std::max( minX, static_cast<int>( clip.min.x ) );
+    const int xMax   = std::min( maxX, static_cast<int>( clip.max.x ) );
+    const int yBegin = std::max( minY, static_cast<int>( clip.min.y ) );
+    const int yEnd   = std::min( maxY, static_cast<int>( clip.max.y ) ) + 1;
+
+    if ( xMin > xMax || yBegin >= yEnd )
+        return;
+
+    // Reject the polygon if it is behind every tile it overlaps.
+    bool visible = false;
+    for ( int ty = yBegin / TileSize; ty <= ( yEnd - 1 ) / TileSize && !visible; ++ty )
+    {
+        for ( int tx = xMin / TileSize; tx <= xMax / TileSize && !visible; ++tx )
+            visible = minDepth < depthBuffer.getTile( tx, ty ).max;
+    }
+
+    if ( !visible )
+        return;
+
+    // Set up the planes from the fan triangle with the largest area (for precision).
+    int   best     = 1;
+    float bestArea = 0.0f;
+    for ( int i = 1; i + 1 < count; ++i )
+    {
+        const glm::vec2 e1   = polygon[i].position - polygon[0].position;
+        const glm::vec2 e2   = polygon[i + 1].position - polygon[0].position;
+        const float     area = std::abs( e1.x * e2.y - e1.y * e2.x );
+
+        if ( area > bestArea )
+        {
+            best     = i;
+            bestArea = area;
+        }
+    }
+
+    PerspectivePlanes planes;
+    if ( !planes.setup( polygon[0], polygon[best], polygon[best + 1], texSize ) )
+        return;
+
+    // The vertices have the same color, so the color doesn't have to be interpolated.
+    bool flat = true;
+    for ( int i = 1; i < count; ++i )
+        flat = flat && polygon[i].color == polygon[0].color;
+
+    const glm::vec4& c0        = polygon[0].color;
+    const Color      flatColor = flat ? Color { static_cast<uint8_t>( c0.x ), static_cast<uint8_t>( c0.y ), static_cast<uint8_t>( c0.z ), static_cast<uint8_t>( c0.w ) } : Color::White;
+
+    Color* const   pixels = image.data();
+    float* const   depths = depthBuffer.data();
+    const uint32_t stride = image.getWidth();
+
+    // Shade the span [x0, x1] of row y. Returns the range of tile columns that were written to.
+    auto shadeRow = [&]( int y, int x0, int x1, int& writtenMin, int& writtenMax ) {
+        constexpr int ChunkSize = 64;
+        Color         texels[ChunkSize];
+        int           runStart = x0;
+        int           runCount = 0;
+
+        Color* const dst = pixels + static_cast<size_t>( y ) * stride;
+        float* const z   = depths + static_cast<size_t>( y ) * stride;
+
+        auto flush = [&] {
+            if ( runCount > 0 )
+            {
+                if ( !Textured && flat )
+                    fillSpan( dst + runStart, runCount, flatColor, blendMode );
+                else
+                    blendSpan( dst + runStart, texels, runCount, flatColor, blendMode );
+            }
+
+            runCount = 0;
+        };
+
+        // The attributes are evaluated at the left of the polygon and stepped by multiplying the offset from there.
+        // The depth of each pixel is a monotonic function of x (which keeps the tile tests consistent with the pixel tests),
+        // and doesn't depend on the clip region (so the tiles of a deferred command buffer draw the same pixels).
+        float start[PerspectivePlanes::Count], step[PerspectivePlanes::Count];
+        for ( int k = 0; k < PerspectivePlanes::Count; ++k )
+        {
+            start[k] = planes( k, minX, y );
+            step[k]  = static_cast<float>( planes.dx[k] );
+        }
+
+        auto depthAt = [&]( int x ) { return start[PerspectivePlanes::Depth] + step[PerspectivePlanes::Depth] * static_cast<float>( x - minX ); };
+
+        const int ty = y / TileSize;
+
+        for ( int x = x0; x <= x1; )
+        {
+            const int                tx   = x / TileSize;
+            const int                end  = std::min( x1, tx * TileSize + TileSize - 1 );
+            const DepthBuffer::Tile& tile = depthBuffer.getTile( tx, ty );
+            const float              d0   = depthAt( x );
+            const float              d1   = depthAt( end );
+
+            // The part of the span in this tile is occluded.
+            if ( std::min( d0, d1 ) >= tile.max )
+            {
+                flush();
+                x = end + 1;
+                continue;
+            }
+
+            // The part of the span in this tile is in front of every pixel of the tile.
+            const bool passAll = std::max( d0, d1 ) < tile.min;
+            bool       written = false;
+
+            for ( ; x <= end; ++x )
+            {
+                const float i     = static_cast<float>( x - minX );
+                const float depth = start[PerspectivePlanes::Depth] + step[PerspectivePlanes::Depth] * i;
+
+                if ( !passAll && !( depth < z[x] ) )
+                {
+                    flush();
+                    continue;
+                }
+
+                z[x]    = depth;
+                written = true;
+
+                if ( runCount == 0 )
+                    runStart = x;
+
+                // Flat untextured pixels don't interpolate any attributes (and are filled without the texel buffer).
+                if ( !Textured && flat )
+                {
+                    ++runCount;
+                    continue;
+                }
+
+                const float w = 1.0f / ( start[PerspectivePlanes::InvW] + step[PerspectivePlanes::InvW] * i );
+
+                Color texel = Color::White;
+                if constexpr ( Textured )
+                    texel = fetch( ( start[PerspectivePlanes::U] + step[PerspectivePlanes::U] * i ) * w, ( start[PerspectivePlanes::U + 1] + step[PerspectivePlanes::U + 1] * i ) * w );
+
+                if ( !flat )
+                {
+                    // The channels are clamped, because the pixels at the edges can be slightly outside of the primitive.
+                    auto channel = [&]( int k ) {
+                        return static_cast<uint8_t>( std::clamp( ( start[PerspectivePlanes::R + k] + step[PerspectivePlanes::R + k] * i ) * w + 0.5f, 0.0f, 255.0f ) );
+                    };
+
+                    const Color color { channel( 0 ), channel( 1 ), channel( 2 ), channel( 3 ) };
+                    texel = Textured ? texel * color : color;
+                }
+
+                texels[runCount] = texel;
+
+                if ( ++runCount == ChunkSize )
+                    flush();
+            }
+
+            if ( written )
+            {
+                writtenMin = std::min( writtenMin, tx );
+                writtenMax = std::max( writtenMax, tx );
+            }
+        }
+
+        flush();
+    };
+
+    const int tyBegin = yBegin / TileSize;
+    const int tyEnd   = ( yEnd - 1 ) / TileSize + 1;
+
+    ThreadPool::get().parallelFor(
+        tyBegin, tyEnd, [&]( int first, int last ) {
+            for ( int ty = first; ty < last; ++ty )
+            {
+                int writtenMin = std::numeric_limits<int>::max();
+                int writtenMax = -1;
+
+                for ( int y = std::max( yBegin, ty * TileSize ); y < std::min( yEnd, ty * TileSize + TileSize ); ++y )
+                {
+                    // The fan triangles don't overlap (the fill rule assigns the pixels on a shared edge to one of them).
+                    for ( int i = 0; i < numTriangles; ++i )
+                    {
+                        int x0, x1;
+                        if ( triangles[i].span( y, xMin, xMax, x0, x1 ) )
+                            shadeRow( y, x0, x1, writtenMin, writtenMax );
+                    }
+                }
+
+                for ( int tx = writtenMin; tx <= writtenMax; ++tx )
+                    depthBuffer.updateTile( static_cast<uint32_t>( tx ), static_cast<uint32_t>( ty ) );
+            }
+        },
+        static_cast<int64_t>( xMax - xMin + 1 ) * TileSize * ( Textured ? TexturedPixelCost : 2 ) );
+}
+
+/// <summary>
+/// The mip levels of an image (starting at level 1).
+/// </summary>
+struct Image::MipChain
+{
+    std::vector<Image> levels;
+};
+
+// Mip chains are built lazily, possibly by several threads that sample the same image.
+// The lock is only taken to build a mip chain (see Image::getMipLevel).
+static std::mutex g_MipChainMutex;
+
 Image::Image() = default;
 
 Image::Image( const std::filesystem::path& fileName )
 {
+    if ( fileName.extension() == TextureFile::Extension )
+    {
+        *this = TextureFile::load( fileName );
+        return;
+    }
+
     int            x, y, n;
     unsigned char* data = stbi_load( fileName.string().c_str(), &x, &y, &n, STBI_rgb_alpha );
     if ( !data )
@@ -41,15 +923,14 @@ Image::Image( const std::filesystem::path& fileName )
 
     resize( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ) );
 
-    memcpy_s( m_data.get(), static_cast<rsize_t>( m_width ) * m_height * sizeof( Color ), data, static_cast<rsize_t>( m_width ) * m_height * sizeof( Color ) );
+    std::memcpy( m_data.get(), data, static_cast<size_t>( m_width ) * m_height * sizeof( Color ) );
 
     stbi_image_free( data );
 }
 
 Image::Image( const Image& copy )
 {
-    resize( copy.m_width, copy.m_height );
-    memcpy_s( data(), static_cast<rsize_t>( m_width ) * m_height * sizeof( Color ), copy.data(), static_cast<rsize_t>( copy.m_width ) * copy.m_height * sizeof( Color ) );
+    *this = copy;
 }
 
 Image::Image( Image&& move ) noexcept
@@ -57,9 +938,16 @@ Image::Image( Image&& move ) noexcept
 , m_height { move.m_height }
 , m_AABB { move.m_AABB }
 , m_data { std::move( move.m_data ) }
+, m_Layout { move.m_Layout }
+, m_CommandBuffer { std::move( move.m_CommandBuffer ) }
+, m_DirtyTracking { move.m_DirtyTracking }
+, m_DirtyRects { std::move( move.m_DirtyRects ) }
+, m_DrawnRects { std::move( move.m_DrawnRects ) }
+, m_MipChain { move.m_MipChain.exchange( nullptr ) }
 {
     move.m_width  = 0u;
     move.m_height = 0u;
+    move.m_Layout = TextureLayout::Linear;
 }
 
 Image::Image( uint32_t width, uint32_t height )
@@ -67,10 +955,38 @@ Image::Image( uint32_t width, uint32_t height )
     resize( width, height );
 }
 
+Image::Image( uint32_t width, uint32_t height, Color* pixels, std::shared_ptr<const void> owner )
+: m_width { width }
+, m_height { height }
+, m_AABB { { 0, 0, 0 }, { width - 1, height - 1, 0 } }
+, m_data { pixels, PixelDeleter { std::move( owner ) } }
+{
+    markDirty( getRect() );
+}
+
+Image::~Image()
+{
+    delete m_MipChain.load();
+}
+
 Image& Image::operator=( const Image& image )
 {
+    if ( this == &image )
+        return *this;
+
     resize( image.m_width, image.m_height );
-    memcpy_s( data(), static_cast<rsize_t>( m_width ) * m_height * sizeof( Color ), image.data(), static_cast<rsize_t>( image.m_width ) * image.m_height * sizeof( Color ) );
+
+    // A tiled image is copied in its layout.
+    if ( image.m_Layout != TextureLayout::Linear )
+    {
+        m_data   = { make_aligned_unique<Color[], 64>( getBufferSize( image.m_Layout, m_width, m_height ) ).release(), PixelDeleter {} };
+        m_Layout = image.m_Layout;
+    }
+
+    std::memcpy( m_data.get(), image.m_data.get(), getBufferSize( m_Layout, m_width, m_height ) * sizeof( Color ) );
+
+    markDirty( getRect() );
+    delete m_MipChain.exchange( nullptr );
 
     return *this;
 }
@@ -81,32 +997,57 @@ Image& Image::operator=( Image&& image ) noexcept
     m_height = image.m_height;
     m_AABB   = image.m_AABB;
 
-    m_data = std::move( image.m_data );
+    m_data          = std::move( image.m_data );
+    m_Layout        = image.m_Layout;
+    m_CommandBuffer = std::move( image.m_CommandBuffer );
+    m_DirtyTracking = image.m_DirtyTracking;
+    m_DirtyRects    = std::move( image.m_DirtyRects );
+    m_DrawnRects    = std::move( image.m_DrawnRects );
+    delete m_MipChain.exchange( image.m_MipChain.exchange( nullptr ) );
 
     image.m_width  = 0u;
     image.m_height = 0u;
+    image.m_Layout = TextureLayout::Linear;
 
     return *this;
 }
 
 void Image::resize( uint32_t width, uint32_t height )
 {
-    if ( m_width == width && m_height == height )
+    // Images that reference external pixels are always moved to owned storage (the pixels may be read-only).
+    // Tiled images get a new (linear) pixel buffer.
+    if ( m_width == width && m_height == height && ownsData() && m_Layout == TextureLayout::Linear )
         return;
 
     m_width  = width;
     m_height = height;
+    m_Layout = TextureLayout::Linear;
     m_AABB   = {
         { 0, 0, 0 },
         { m_width - 1, m_height - 1, 0 }
     };
 
     // Align color buffer to 64-byte boundary for better cache alignment on 64-bit architectures.
-    m_data = make_aligned_unique<Color[], 64>( static_cast<uint64_t>( width ) * height );
+    m_data = { make_aligned_unique<Color[], 64>( static_cast<uint64_t>( width ) * height ).release(), PixelDeleter {} };
+
+    // The regions (and mip levels) of the previous size are meaningless.
+    m_DirtyRects.clear();
+    m_DrawnRects.clear();
+    markDirty( getRect() );
+    delete m_MipChain.exchange( nullptr );
 }
 
 void Image::save( const std::filesystem::path& file ) const
 {
+    // The files store the pixels in rows.
+    if ( m_Layout != TextureLayout::Linear )
+    {
+        Image linear { *this };
+        linear.setTextureLayout( TextureLayout::Linear );
+        linear.save( file );
+        return;
+    }
+
     const auto extension = file.extension();
 
     if ( extension == ".png" )
@@ -125,29 +1066,230 @@ void Image::save( const std::filesystem::path& file ) const
     {
         stbi_write_jpg( file.string().c_str(), static_cast<int>( m_width ), static_cast<int>( m_height ), 4, m_data.get(), 10 );
     }
+    else if ( extension == TextureFile::Extension )
+    {
+        TextureFile::write( file, *this );
+    }
     else
     {
         std::cerr << "Invalid file type: " << file << std::endl;
     }
 }
 
+void Image::beginDeferred( uint32_t tileSize )
+{
+    if ( m_CommandBuffer && m_CommandBuffer->getTileSize() == tileSize )
+        return;
+
+    // Commands that were recorded with a different tile size are executed first.
+    flush();
+
+    m_CommandBuffer = std::make_unique<CommandBuffer>( tileSize );
+}
+
+void Image::flush()
+{
+    if ( !m_CommandBuffer || m_CommandBuffer->empty() )
+        return;
+
+    CommandBuffer& commandBuffer = *m_CommandBuffer;
+    commandBuffer.bin( m_width, m_height );
+
+    execute( commandBuffer, static_cast<int64_t>( commandBuffer.getTileSize() ) * commandBuffer.getTileSize() );
+
+    commandBuffer.clear();
+}
+
+void Image::execute( const CommandBuffer& commandBuffer, int64_t tileCost )
+{
+    const int numTiles = static_cast<int>( commandBuffer.getNumTiles() );
+
+    // Draw functions that are called from inside a tile don't distribute their work over the threads again.
+    parallelRows( 0, numTiles, tileCost, [&]( int tile ) {
+        const AABB clip = commandBuffer.getTileAABB( static_cast<uint32_t>( tile ) );
+
+        for ( uint32_t i: commandBuffer.getBin( static_cast<uint32_t>( tile ) ) )
+        {
+            std::visit(
+                [&]( const auto& cmd ) {
+                    using T = std::decay_t<decltype( cmd )>;
+
+                    if constexpr ( std::is_same_v<T, ClearCommand> )
+                        clearImpl( cmd.color, clip );
+                    else if constexpr ( std::is_same_v<T, CopyCommand> )
+                        copyImpl( *cmd.srcImage, cmd.srcRect, cmd.dstRect, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, CopyImageCommand> )
+                        copyImpl( *cmd.srcImage, cmd.x, cmd.y, clip );
+                    else if constexpr ( std::is_same_v<T, LineCommand> )
+                        drawLineImpl( cmd.x0, cmd.y0, cmd.x1, cmd.y1, cmd.color, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, TriangleCommand> )
+                        drawTriangleImpl( cmd.p0, cmd.p1, cmd.p2, cmd.color, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, Triangle3DCommand> )
+                        drawTriangleImpl( cmd.v0, cmd.v1, cmd.v2, *cmd.depthBuffer, cmd.texture, cmd.addressMode, cmd.cullMode, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, VertexTriangleCommand> )
+                        drawTriangleImpl( cmd.v0, cmd.v1, cmd.v2, cmd.texture, cmd.addressMode, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, TexturedQuadCommand> )
+                        drawQuadImpl( cmd.v0, cmd.v1, cmd.v2, cmd.v3, *cmd.image, cmd.addressMode, cmd.blendMode, cmd.filterMode, clip );
+                    else if constexpr ( std::is_same_v<T, AABBCommand> )
+                        drawAABBImpl( cmd.aabb, cmd.color, cmd.blendMode, clip );
+                    else if constexpr ( std::is_same_v<T, SpriteCommand> )
+                        drawSpriteImpl( cmd.sprite, cmd.matrix, clip );
+                    else if constexpr ( std::is_same_v<T, SpriteCopyCommand> )
+                        drawSpriteImpl( cmd.sprite, cmd.x, cmd.y, clip );
+                    else if constexpr ( std::is_same_v<T, GlyphRunCommand> )
+                        drawGlyphRunImpl( *cmd.run, cmd.x, cmd.y, clip );
+                },
+                commandBuffer[i] );
+        }
+    } );
+}
+
+void Image::endDeferred()
+{
+    flush();
+    m_CommandBuffer.reset();
+}
+
+void Image::setDirtyTracking( bool enabled )
+{
+    m_DirtyTracking = enabled;
+    m_DirtyRects.clear();
+    m_DrawnRects.clear();
+
+    // Nothing is known about the current contents of the image.
+    markDirty( getRect() );
+}
+
+void Image::markDirty( const RectI& rect ) noexcept
+{
+    if ( !m_DirtyTracking )
+        return;
+
+    // Clip to the image.
+    const int left   = std::max( rect.left, 0 );
+    const int top    = std::max( rect.top, 0 );
+    const int right  = std::min( rect.right(), static_cast<int>( m_width ) );
+    const int bottom = std::min( rect.bottom(), static_cast<int>( m_height ) );
+
+    if ( left >= right || top >= bottom )
+        return;
+
+    const RectI r { left, top, right - left, bottom - top };
+    m_DirtyRects.add( r );
+    m_DrawnRects.add( r );
+}
+
+void Image::markDirty( const AABB& bounds ) noexcept
+{
+    if ( !m_DirtyTracking || !m_AABB.intersect( bounds ) )
+        return;
+
+    // Round outwards to whole pixels (the max point of the bounds is inclusive).
+    const AABB b      = bounds.clamped( m_AABB );
+    const int  left   = static_cast<int>( std::floor( b.min.x ) );
+    const int  top    = static_cast<int>( std::floor( b.min.y ) );
+    const int  right  = static_cast<int>( std::ceil( b.max.x ) ) + 1;
+    const int  bottom = static_cast<int>( std::ceil( b.max.y ) ) + 1;
+
+    markDirty( RectI { left, top, right - left, bottom - top } );
+}
+
+void Image::resetDirtyRects() noexcept
+{
+    m_DirtyRects.clear();
+}
+
+void Image::clearDirty( const Color& color ) noexcept
+{
+    if ( !m_DirtyTracking )
+    {
+        clear( color );
+        return;
+    }
+
+    // Restore the background where the previous frame was drawn. Those are the regions that change when the image is presented.
+    for ( const RectI& r: m_DrawnRects )
+    {
+        const AABB aabb = AABB::fromMinMax( { r.left, r.top, 0 }, { r.right() - 1, r.bottom() - 1, 0 } );
+
+        if ( m_CommandBuffer )
+            m_CommandBuffer->push( AABBCommand { aabb, color, {} }, aabb );
+        else
+            drawAABBImpl( aabb, color, {}, m_AABB );
+    }
+
+    std::swap( m_DirtyRects, m_DrawnRects );
+    m_DrawnRects.clear();
+}
+
 void Image::clear( const Color& color ) noexcept
+{
+    if ( m_DirtyTracking )
+    {
+        // The entire image changes, but nothing is drawn on top of the background.
+        m_DirtyRects.clear();
+        m_DrawnRects.clear();
+        m_DirtyRects.add( getRect() );
+    }
+
+    if ( m_CommandBuffer )
+        m_CommandBuffer->push( ClearCommand { color }, m_AABB );
+    else
+        clearImpl( color, m_AABB );
+}
+
+void Image::clearImpl( const Color& color, const AABB& clip ) noexcept
 {
     Color* p = data();
 
-#pragma omp parallel for
-    for ( int i = 0; i < static_cast<int>( m_width * m_height ); ++i )
-        p[i] = color;
+    const int minX = static_cast<int>( clip.min.x );
+    const int maxX = static_cast<int>( clip.max.x );
+    const int minY = static_cast<int>( clip.min.y );
+    const int maxY = static_cast<int>( clip.max.y );
+
+    if ( minX > maxX || minY > maxY )
+        return;
+
+    const int width = maxX - minX + 1;
+
+    // Large clears of entire rows (which are contiguous in memory) are streamed, so they don't flush the cache.
+    if ( minX == 0 && width == static_cast<int>( m_width ) && static_cast<size_t>( maxY - minY + 1 ) * width * sizeof( Color ) >= StreamingClearSize )
+    {
+        ThreadPool::get().parallelFor(
+            minY, maxY + 1, [&]( int first, int last ) {
+                streamFillSpan( p + static_cast<size_t>( first ) * m_width, static_cast<size_t>( last - first ) * m_width, color );
+            },
+            width );
+
+        return;
+    }
+
+    parallelRows( minY, maxY + 1, width, [&]( int y ) {
+        fillSpan( p + static_cast<size_t>( y ) * m_width + minX, width, color, {} );
+    } );
 }
 
 void Image::copy( const Image& srcImage, std::optional<Math::RectI> srcRect, std::optional<Math::RectI> dstRect, const BlendMode& blendMode )
 {
     // If the source rectangle is not provided, use the entire source image.
-    AABB srcAABB = AABB::fromRect( srcRect ? *srcRect : srcImage.getRect() );
+    const RectI src = srcRect ? *srcRect : srcImage.getRect();
     // If the destination rect is not provided, use the entire source image.
     // I assume that the "expected behaviour" of this method is to copy the source image to the
     // destination image (without scaling) even if that results in clipping of the source image.
-    AABB dstAABB = AABB::fromRect( dstRect ? *dstRect : srcImage.getRect() );
+    const RectI dst = dstRect ? *dstRect : srcImage.getRect();
+
+    markDirty( dst );
+
+    if ( m_CommandBuffer )
+        m_CommandBuffer->push( CopyCommand { &srcImage, src, dst, blendMode }, AABB::fromRect( dst ) );
+    else
+        copyImpl( srcImage, src, dst, blendMode, m_AABB );
+}
+
+void Image::copyImpl( const Image& srcImage, const RectI& srcRect, const RectI& dstRect, const BlendMode& blendMode, const AABB& clip ) noexcept
+{
+    AABB srcAABB = AABB::fromRect( srcRect );
+    AABB dstAABB = AABB::fromRect( dstRect );
 
     // If the source AABB doesn't intersect with the source image bounds.
     // In other words, the source image rectangle doesn't cover any part of the source image.
@@ -173,71 +1315,92 @@ void Image::copy( const Image& srcImage, std::optional<Math::RectI> srcRect, std
     const int dH = static_cast<int>( dstAABB.height() );
 
     // Clamp the dstAABB to the bounds of this image (to prevent writing outside of this image's bounds).
-    AABB dstImage = dstAABB.clamped( m_AABB );
+    const AABB dstImage = dstAABB.clamped( m_AABB );
+
+    // The top-left corner of the clamped destination region.
+    const int iX = static_cast<int>( dstImage.min.x );
+    const int iY = static_cast<int>( dstImage.min.y );
+
+    // The part of the clamped destination region that is inside the clip region.
+    const int x0 = std::max( iX, static_cast<int>( clip.min.x ) );
+    const int y0 = std::max( iY, static_cast<int>( clip.min.y ) );
+    const int x1 = std::min( iX + static_cast<int>( dstImage.width() ), static_cast<int>( clip.max.x ) + 1 );
+    const int y1 = std::min( iY + static_cast<int>( dstImage.height() ), static_cast<int>( clip.max.y ) + 1 );
 
-    // Clamped image width.
-    const int iW = static_cast<int>( dstImage.width() );
-    // Clamped image height.
-    const int iH = static_cast<int>( dstImage.height() );
-    // Clamped image area
-    const int iA = iW * iH;
+    // Source image offset.
+    const int sX = static_cast<int>( srcAABB.min.x );
+    const int sY = static_cast<int>( srcAABB.min.y );
 
-    // Pointer to source image data.
-    const Color* src = srcImage.data();
     // Pointer to destination image data.
     Color* dst = data();
 
-#pragma omp parallel for firstprivate( srcAABB, dstAABB, dstImage, sW, sH, dW, dH, iW, iH )
-    for ( int i = 0; i < iA; ++i )
-    {
-        const int x  = i % iW;
-        const int y  = i / iW;
-        const int dx = x + static_cast<int>( dstImage.min.x );
-        const int dy = y + static_cast<int>( dstImage.min.y );
-        const int sx = ( x * sW / dW ) + static_cast<int>( srcAABB.min.x );
-        const int sy = ( y * sH / dH ) + static_cast<int>( srcAABB.min.y );
+    parallelRows( y0, y1, x1 - x0, [&]( int dy ) {
+        const int sy     = ( ( dy - iY ) * sH / dH ) + sY;
+        Color*    dstRow = dst + static_cast<size_t>( dy ) * m_width;
 
-        const Color sC = src[sy * srcImage.getWidth() + sx];
-        const Color dC = dst[dy * m_width + dx];
+        // Without horizontal scaling, the source row can be blended directly (if it is stored in a row).
+        if ( sW == dW && srcImage.m_Layout == TextureLayout::Linear )
+        {
+            blendSpan( dstRow + x0, srcImage.m_data.get() + static_cast<size_t>( sy ) * srcImage.getWidth() + ( x0 - iX ) + sX, x1 - x0, Color::White, blendMode );
+            return;
+        }
 
-        dst[dy * m_width + dx] = blendMode.Blend( sC, dC );
-    }
+        // Otherwise, gather the (scaled) source pixels in chunks and blend those.
+        Color row[256];
+        for ( int dx = x0; dx < x1; dx += static_cast<int>( std::size( row ) ) )
+        {
+            const int n = std::min( x1 - dx, static_cast<int>( std::size( row ) ) );
+
+            for ( int i = 0; i < n; ++i )
+                row[i] = srcImage.texel( static_cast<uint32_t>( ( ( dx + i - iX ) * sW / dW ) + sX ), static_cast<uint32_t>( sy ) );
+
+            blendSpan( dstRow + dx, row, n, Color::White, blendMode );
+        }
+    } );
 }
 
 void Image::copy( const Image& srcImage, int x, int y )
 {
-    // Source image coords.
-    const int sX = x < 0 ? -x : 0;
-    const int sY = y < 0 ? -y : 0;
-    const int sW = static_cast<int>( srcImage.getWidth() ) - sX;
-    const int sH = static_cast<int>( srcImage.getHeight() ) - sY;
+    markDirty( RectI { x, y, static_cast<int>( srcImage.getWidth() ), static_cast<int>( srcImage.getHeight() ) } );
 
-    // Check if source image is offscreen.
-    if ( sW <= 0 || sH <= 0 )
-        return;
+    if ( m_CommandBuffer )
+    {
+        const AABB bounds {
+            { x, y, 0 },
+            { x + static_cast<int>( srcImage.getWidth() ) - 1, y + static_cast<int>( srcImage.getHeight() ) - 1, 0 }
+        };
 
-    // Destination coords.
-    const int dX = x < 0 ? 0 : x;
-    const int dY = y < 0 ? 0 : y;
-    const int dW = static_cast<int>( m_width ) - dX;
-    const int dH = static_cast<int>( m_height ) - dY;
+        m_CommandBuffer->push( CopyImageCommand { &srcImage, x, y }, bounds );
+    }
+    else
+    {
+        copyImpl( srcImage, x, y, m_AABB );
+    }
+}
 
-    // Check if the destination range is offscreen.
-    if ( dW <= 0 || dH <= 0 )
+void Image::copyImpl( const Image& srcImage, int x, int y, const AABB& clip ) noexcept
+{
+    // Destination region.
+    const int dX0 = std::max( x, static_cast<int>( clip.min.x ) );
+    const int dY0 = std::max( y, static_cast<int>( clip.min.y ) );
+    const int dX1 = std::min( x + static_cast<int>( srcImage.getWidth() ), static_cast<int>( clip.max.x ) + 1 );
+    const int dY1 = std::min( y + static_cast<int>( srcImage.getHeight() ), static_cast<int>( clip.max.y ) + 1 );
+
+    // Check if the destination region is empty.
+    if ( dX0 >= dX1 || dY0 >= dY1 )
         return;
 
-    // The destination copy region is the minimum of the source
-    // and destination dimensions.
-    const int w = std::min( sW, dW );
-    const int h = std::min( sH, dH );
+    // Source image coords.
+    const int sX = dX0 - x;
+    const int sY = dY0 - y;
+    const int w  = dX1 - dX0;
+    const int h  = dY1 - dY0;
 
-    const uint32_t srcWidth = srcImage.getWidth();
-    const Color*   src      = srcImage.data();
-    Color*         dst      = data();
+    Color* dst = data();
 
-#pragma omp parallel for firstprivate( w, h, sX, sY, dX, dY )
-    for ( int i = 0; i < h; ++i )
-        memcpy_s( dst + ( i + dY ) * m_width + dX, w * sizeof( Color ), src + ( i + sY ) * srcWidth + sX, w * sizeof( Color ) );
+    parallelRows( 0, h, w, [&]( int i ) {
+        srcImage.readRow( static_cast<uint32_t>( sX ), static_cast<uint32_t>( i + sY ), static_cast<uint32_t>( w ), dst + static_cast<size_t>( i + dY0 ) * m_width + dX0 );
+    } );
 }
 
 // Source: https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
@@ -247,6 +1410,32 @@ void Image::drawLine( int x0, int y0, int x1, int y1, const Color& color, const
     if ( !m_AABB.clip( x0, y0, x1, y1 ) )
         return;
 
+    const AABB bounds {
+        { x0, y0, 0 },
+        { x1, y1, 0 }
+    };
+
+    markDirty( bounds );
+
+    if ( m_CommandBuffer )
+    {
+        m_CommandBuffer->push( LineCommand { x0, y0, x1, y1, color, blendMode }, bounds );
+    }
+    else
+    {
+        drawLineImpl( x0, y0, x1, y1, color, blendMode, m_AABB );
+    }
+}
+
+void Image::drawLineImpl( int x0, int y0, int x1, int y1, const Color& color, const BlendMode& blendMode, const AABB& clip ) noexcept
+{
+    // The line is always stepped from the same end point (even if it is clipped by
+    // a tile) so that lines are drawn identically in immediate and deferred mode.
+    const int minX = static_cast<int>( clip.min.x );
+    const int maxX = static_cast<int>( clip.max.x );
+    const int minY = static_cast<int>( clip.min.y );
+    const int maxY = static_cast<int>( clip.max.y );
+
     const int dx = std::abs( x1 - x0 );
     const int dy = -std::abs( y1 - y0 );
     const int sx = x0 < x1 ? 1 : -1;
@@ -256,7 +1445,9 @@ void Image::drawLine( int x0, int y0, int x1, int y1, const Color& color, const
 
     while ( true )
     {
-        plot<false>( x0, y0, color, blendMode );
+        if ( x0 >= minX && x0 <= maxX && y0 >= minY && y0 <= maxY )
+            plot<false>( x0, y0, color, blendMode );
+
         const int e2 = err * 2;
 
         if ( e2 >= dy )
@@ -298,134 +1489,363 @@ void Image::drawTriangle( const glm::vec2& p0, const glm::vec2& p1, const glm::v
     break;
     case FillMode::Solid:
     {
-        // Clamp the triangle AABB to the screen bounds.
-        aabb.clamp( m_AABB );
+        markDirty( aabb );
+
+        if ( m_CommandBuffer )
+            m_CommandBuffer->push( TriangleCommand { p0, p1, p2, color, blendMode }, aabb );
+        else
+            drawTriangleImpl( p0, p1, p2, color, blendMode, m_AABB );
+    }
+    break;
+    }
+}
+
+void Image::drawTriangleImpl( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const Color& color, const BlendMode& blendMode, const AABB& clip ) noexcept
+{
+    const glm::vec2 verts[] = { p0, p1, p2 };
+
+    rasterize( EdgeRasterizer<3> { verts }, clip, [&]( int y, int x0, int x1 ) {
+        fillSpan( data() + static_cast<size_t>( y ) * m_width + x0, x1 - x0 + 1, color, blendMode );
+    } );
+}
+
+void Image::drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, CullMode cullMode, const BlendMode& blendMode ) noexcept
+{
+    drawTriangle( v0, v1, v2, depthBuffer, nullptr, AddressMode::Wrap, cullMode, blendMode );
+}
+
+void Image::drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image& texture, AddressMode addressMode, CullMode cullMode, const BlendMode& blendMode ) noexcept
+{
+    drawTriangle( v0, v1, v2, depthBuffer, &texture, addressMode, cullMode, blendMode );
+}
+
+void Image::drawTriangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image* texture, AddressMode addressMode, CullMode cullMode, const BlendMode& blendMode ) noexcept
+{
+    const ClipVertex verts[] = { v0, v1, v2 };
+    ProjectedVertex  polygon[MaxClippedVertices];
 
-#pragma omp parallel for schedule( dynamic ) firstprivate( aabb )
-        for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
+    const int count = clipTriangle( verts, static_cast<float>( m_width ), static_cast<float>( m_height ), cullMode, polygon );
+    if ( count == 0 )
+        return;
+
+    AABB bounds;
+    for ( int i = 0; i < count; ++i )
+        bounds.expand( glm::vec3 { polygon[i].position, 0.0f } );
+
+    if ( !m_AABB.intersect( bounds ) )
+        return;
+
+    markDirty( bounds );
+
+    // The tiles of the command buffer must not share a depth buffer tile, because the thread that draws
+    // a tile updates the depth range of the depth buffer tiles it writes to.
+    if ( m_CommandBuffer && m_CommandBuffer->getTileSize() % DepthBuffer::TileSize == 0 )
+    {
+        m_CommandBuffer->push( Triangle3DCommand { v0, v1, v2, &depthBuffer, texture, addressMode, cullMode, blendMode }, bounds );
+    }
+    else
+    {
+        flush();
+        drawTriangleImpl( v0, v1, v2, depthBuffer, texture, addressMode, cullMode, blendMode, m_AABB );
+    }
+}
+
+void Image::drawTriangleImpl( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, DepthBuffer& depthBuffer, const Image* texture, AddressMode addressMode, CullMode cullMode, const BlendMode& blendMode, const AABB& clip ) noexcept
+{
+    assert( depthBuffer.getWidth() == m_width && depthBuffer.getHeight() == m_height );
+
+    const ClipVertex verts[] = { v0, v1, v2 };
+    ProjectedVertex  polygon[MaxClippedVertices];
+
+    const int count = clipTriangle( verts, static_cast<float>( m_width ), static_cast<float>( m_height ), cullMode, polygon );
+    if ( count == 0 )
+        return;
+
+    // Don't write outside of the depth buffer.
+    const AABB region = clip.clamped( AABB::fromMinMax( glm::vec3 { 0.0f }, glm::vec3 { static_cast<float>( depthBuffer.getWidth() ) - 1.0f, static_cast<float>( depthBuffer.getHeight() ) - 1.0f, 0.0f } ) );
+
+    if ( !texture )
+    {
+        drawPolygon3D( *this, depthBuffer, polygon, count, glm::vec2 { 0.0f }, region, blendMode, nullptr );
+        return;
+    }
+
+    // Texel centers are at half-integer coordinates (texture coordinates [0..1] cover the texture exactly once),
+    // as in OpenGL, so a texture wraps seamlessly around a mesh.
+    drawPolygon3D( *this, depthBuffer, polygon, count, glm::vec2 { texture->getWidth(), texture->getHeight() }, region, blendMode, [&]( float u, float v ) -> const Color& {
+        return texture->sample( floorToInt( u ), floorToInt( v ), addressMode );
+    } );
+}
+
+void Image::drawQuad( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const Color& color, const BlendMode& blendMode, FillMode fillMode ) noexcept
+{
+    AABB aabb = AABB::fromQuad( { p0, 0 }, { p1, 0 }, { p2, 0 }, { p3, 0 } );
+
+    // Check if the triangle is on screen.
+    if ( !m_AABB.intersect( aabb ) )
+        return;
+
+    switch ( fillMode )
+    {
+    case FillMode::WireFrame:
+    {
+        drawLine( p0, p1, color, blendMode );
+        drawLine( p1, p2, color, blendMode );
+        drawLine( p2, p3, color, blendMode );
+        drawLine( p3, p0, color, blendMode );
+    }
+    break;
+    case FillMode::Solid:
+    {
+        markDirty( aabb );
+
+        // The quad is split into two triangles. The fill rules guarantee that
+        // pixels on the shared edge are only plotted once.
+        if ( m_CommandBuffer )
         {
-            for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
-            {
-                if ( pointInsideTriangle( { x, y }, p0, p1, p2 ) )
-                    plot<false>( x, y, color, blendMode );
-            }
+            m_CommandBuffer->push( TriangleCommand { p0, p1, p3, color, blendMode }, aabb );
+            m_CommandBuffer->push( TriangleCommand { p1, p2, p3, color, blendMode }, aabb );
+        }
+        else
+        {
+            drawTriangleImpl( p0, p1, p3, color, blendMode, m_AABB );
+            drawTriangleImpl( p1, p2, p3, color, blendMode, m_AABB );
+        }
+    }
+    break;
+    }
+}
+
+void Image::drawQuad( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode, const BlendMode& blendMode, FilterMode filterMode ) noexcept
+{
+    const AABB bounds {
+        { v0.position, 0.0f },
+        { v1.position, 0.0f },
+        { v2.position, 0.0f },
+        { v3.position, 0.0f }
+    };
+
+    markDirty( bounds );
+
+    if ( m_CommandBuffer )
+    {
+        m_CommandBuffer->push( TexturedQuadCommand { v0, v1, v2, v3, &image, addressMode, blendMode, filterMode }, bounds );
+    }
+    else
+    {
+        drawQuadImpl( v0, v1, v2, v3, image, addressMode, blendMode, filterMode, m_AABB );
+    }
+}
+
+void Image::drawQuadImpl( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode, const BlendMode& blendMode, FilterMode filterMode, const AABB& clip ) noexcept
+{
+    // Compute an AABB over the sprite quad.
+    AABB aabb {
+        { v0.position, 0.0f },
+        { v1.position, 0.0f },
+        { v2.position, 0.0f },
+        { v3.position, 0.0f }
+    };
+
+    // Check if the AABB of the sprite is on screen.
+    if ( !clip.intersect( aabb ) )
+        return;
+
+    // Clamp to the clip region.
+    aabb.clamp( clip );
+
+    // A rectangle with the texture mapped along its edges and a single color doesn't need the per-pixel inside test.
+    // The vertices can go either way around the rectangle.
+    const bool horizontalFirst = v0.position.y == v1.position.y && v1.position.x == v2.position.x && v2.position.y == v3.position.y && v3.position.x == v0.position.x && v0.texCoord.y == v1.texCoord.y && v1.texCoord.x == v2.texCoord.x && v2.texCoord.y == v3.texCoord.y && v3.texCoord.x == v0.texCoord.x;
+    const bool verticalFirst   = v0.position.x == v1.position.x && v1.position.y == v2.position.y && v2.position.x == v3.position.x && v3.position.y == v0.position.y && v0.texCoord.x == v1.texCoord.x && v1.texCoord.y == v2.texCoord.y && v2.texCoord.x == v3.texCoord.x && v3.texCoord.y == v0.texCoord.y;
+
+    if ( ( horizontalFirst || verticalFirst ) && v0.color == v1.color && v0.color == v2.color && v0.color == v3.color )
+    {
+        // The opposite corners of the rectangle.
+        const Vertex& a = v0;
+        const Vertex& b = v2;
+
+        if ( a.position.x == b.position.x || a.position.y == b.position.y )
+            return;
+
+        // Texel coordinates per pixel.
+        const glm::vec2 texSize { image.getWidth(), image.getHeight() };
+        const glm::vec2 duv = ( b.texCoord - a.texCoord ) * texSize / ( b.position - a.position );
+
+        // Pixels with integer coordinates between the corners are covered.
+        const int x0 = static_cast<int>( std::ceil( aabb.min.x ) );
+        const int y0 = static_cast<int>( std::ceil( aabb.min.y ) );
+        const int x1 = static_cast<int>( std::floor( aabb.max.x ) ) + 1;
+        const int y1 = static_cast<int>( std::floor( aabb.max.y ) ) + 1;
+
+        const glm::vec2 uvOrigin = a.texCoord * texSize - a.position * duv;
+
+        if ( filterMode != FilterMode::Point )
+        {
+            const TextureSampler sampler { image, filterMode, addressMode, TextureSampler::computeLOD( { duv.x, 0.0f }, { 0.0f, duv.y } ) };
+            drawFilteredRows( data(), m_width, x0, y0, x1, y1, uvOrigin, duv, a.color, blendMode, sampler );
+            return;
         }
+
+        drawScaledRows( data(), m_width, x0, y0, x1, y1, uvOrigin, duv, a.color, blendMode, [&]( int u, int v ) {
+            return image.sample( u, v, addressMode );
+        } );
+        return;
     }
-    break;
+
+    const Vertex    verts[] = { v0, v1, v2, v3 };
+    const glm::vec2 texSize { image.getWidth(), image.getHeight() };
+
+    if ( filterMode != FilterMode::Point )
+    {
+        const float          lod = triangleLOD( v0.position, v1.position, v3.position, v0.texCoord * texSize, v1.texCoord * texSize, v3.texCoord * texSize );
+        const TextureSampler sampler { image, filterMode, addressMode, lod };
+
+        drawTexturedQuad( *this, verts, texSize, aabb, blendMode, [&]( int64_t u, int64_t v ) {
+            return sampler( glm::vec2 { u, v } * ( 1.0f / 65536.0f ) );
+        } );
+        return;
     }
+
+    // Round to the nearest texel.
+    drawTexturedQuad( *this, verts, texSize, aabb, blendMode, [&]( int64_t u, int64_t v ) {
+        return image.sample( static_cast<int>( ( u + 0x8000 ) >> 16 ), static_cast<int>( ( v + 0x8000 ) >> 16 ), addressMode );
+    } );
 }
 
-void Image::drawQuad( const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const Color& color, const BlendMode& blendMode, FillMode fillMode ) noexcept
+// The sides of the image that a point is outside of.
+enum OutCode : uint8_t
 {
-    AABB aabb = AABB::fromQuad( { p0, 0 }, { p1, 0 }, { p2, 0 }, { p3, 0 } );
+    OutLeft   = 1 << 0,
+    OutRight  = 1 << 1,
+    OutTop    = 1 << 2,
+    OutBottom = 1 << 3,
+};
 
-    // Check if the triangle is on screen.
-    if ( !m_AABB.intersect( aabb ) )
-        return;
+static uint8_t outCode( const glm::vec2& p, const AABB& aabb ) noexcept
+{
+    return static_cast<uint8_t>( ( p.x < aabb.min.x ? OutLeft : 0 ) | ( p.x > aabb.max.x ? OutRight : 0 ) | ( p.y < aabb.min.y ? OutTop : 0 ) | ( p.y > aabb.max.y ? OutBottom : 0 ) );
+}
 
-    switch ( fillMode )
-    {
-    case FillMode::WireFrame:
+void Image::drawIndexed( std::span<const Vertex> vertices, std::span<const uint32_t> indices, const Image* texture, const BlendMode& blendMode, const glm::mat3& matrix, AddressMode addressMode, CullMode cullMode )
+{
+    // The post-transform vertex cache: the transformed position of each vertex, and the sides of the image it is outside of.
+    // The storage is reused by the following draws (of the same thread).
+    static thread_local std::vector<glm::vec2> t_Positions;
+    static thread_local std::vector<uint8_t>   t_OutCodes;
+
+    t_Positions.resize( vertices.size() );
+    t_OutCodes.resize( vertices.size() );
+
+    for ( size_t i = 0; i < vertices.size(); ++i )
     {
-        drawLine( p0, p1, color, blendMode );
-        drawLine( p1, p2, color, blendMode );
-        drawLine( p2, p3, color, blendMode );
-        drawLine( p3, p0, color, blendMode );
+        t_Positions[i] = matrix * glm::vec3 { vertices[i].position, 1.0f };
+        t_OutCodes[i]  = outCode( t_Positions[i], m_AABB );
     }
-    break;
-    case FillMode::Solid:
+
+    // In immediate mode, the triangles are binned into tiles (like the commands of a deferred image), and all of the tiles
+    // are drawn in a single parallel pass, instead of a parallel pass per triangle.
+    static thread_local CommandBuffer t_Batch { IndexedTileSize };
+
+    CommandBuffer& batch = m_CommandBuffer ? *m_CommandBuffer : t_Batch;
+    int64_t        cost  = 0;
+
+    if ( !m_CommandBuffer )
+        t_Batch.clear();
+
+    for ( size_t i = 0; i + 2 < indices.size(); i += 3 )
     {
-        glm::vec2 verts[] = {
-            p0, p1, p2, p3
-        };
+        const uint32_t i0 = indices[i + 0];
+        const uint32_t i1 = indices[i + 1];
+        const uint32_t i2 = indices[i + 2];
 
-        // Index buffer for the two triangles of the quad.
-        const uint32_t indicies[] = {
-            0, 1, 3,
-            1, 2, 3
-        };
+        if ( i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size() )
+            continue;
 
-        // Clamp to the size of the screen.
-        aabb.clamp( m_AABB );
+        // All of the vertices are outside of the same side of the image.
+        if ( t_OutCodes[i0] & t_OutCodes[i1] & t_OutCodes[i2] )
+            continue;
 
-#pragma omp parallel for schedule( dynamic ) firstprivate( aabb, indicies, verts )
-        for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
+        const glm::vec2& p0 = t_Positions[i0];
+        const glm::vec2& p1 = t_Positions[i1];
+        const glm::vec2& p2 = t_Positions[i2];
+
+        // Twice the signed area of the triangle. Front faces are counter-clockwise as displayed, so they have a negative area with +y down
+        // (the same as the 3D triangles).
+        const float area = ( p1.x - p0.x ) * ( p2.y - p0.y ) - ( p1.y - p0.y ) * ( p2.x - p0.x );
+
+        if ( area == 0.0f || ( cullMode == CullMode::Back && area > 0.0f ) || ( cullMode == CullMode::Front && area < 0.0f ) )
+            continue;
+
+        const Vertex v0 { p0, vertices[i0].texCoord, vertices[i0].color };
+        const Vertex v1 { p1, vertices[i1].texCoord, vertices[i1].color };
+        const Vertex v2 { p2, vertices[i2].texCoord, vertices[i2].color };
+
+        const AABB bounds = AABB::fromTriangle( { p0, 0 }, { p1, 0 }, { p2, 0 } );
+
+        markDirty( bounds );
+        batch.push( VertexTriangleCommand { v0, v1, v2, texture, addressMode, blendMode }, bounds );
+
+        // Estimate the cost of the triangle by half of its (clipped) bounds.
+        if ( !m_CommandBuffer )
         {
-            for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
-            {
-                for ( uint32_t i = 0; i < std::size( indicies ); i += 3 )
-                {
-                    const uint32_t i0 = indicies[i + 0];
-                    const uint32_t i1 = indicies[i + 1];
-                    const uint32_t i2 = indicies[i + 2];
+            const float   w         = std::min( bounds.max.x, m_AABB.max.x ) - std::max( bounds.min.x, m_AABB.min.x ) + 1.0f;
+            const float   h         = std::min( bounds.max.y, m_AABB.max.y ) - std::max( bounds.min.y, m_AABB.min.y ) + 1.0f;
+            const bool    solid     = !texture && v0.color == v1.color && v0.color == v2.color;
+            const int64_t pixelCost = solid ? 1 : TexturedPixelCost;
 
-                    glm::vec3 bc = barycentric( verts[i0], verts[i1], verts[i2], { x, y } );
-                    if ( barycentricInside( bc ) )
-                    {
-                        plot<false>( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ), color, blendMode );
-                    }
-                }
-            }
+            cost += static_cast<int64_t>( std::max( w, 1.0f ) * std::max( h, 1.0f ) * 0.5f ) * pixelCost;
         }
     }
-    break;
-    }
+
+    // Deferred images draw the triangles when they are flushed.
+    if ( m_CommandBuffer )
+        return;
+
+    batch.bin( m_width, m_height );
+    execute( batch, cost / std::max<int64_t>( batch.getNumTiles(), 1 ) );
+    batch.clear();
 }
 
-void Image::drawQuad( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Vertex& v3, const Image& image, AddressMode addressMode, const BlendMode& _blendMode ) noexcept
+void Image::drawTriangleImpl( const Vertex& v0, const Vertex& v1, const Vertex& v2, const Image* texture, AddressMode addressMode, const BlendMode& blendMode, const AABB& clip ) noexcept
 {
-    // Compute an AABB over the sprite quad.
-    AABB aabb {
-        { v0.position, 0.0f },
-        { v1.position, 0.0f },
-        { v2.position, 0.0f },
-        { v3.position, 0.0f }
-    };
+    const glm::vec2         positions[] = { v0.position, v1.position, v2.position };
+    const EdgeRasterizer<3> triangle { positions };
 
-    // Check if the AABB of the sprite is on screen.
-    if ( !m_AABB.intersect( aabb ) )
+    // A single color without a texture is a solid fill.
+    if ( !texture && v0.color == v1.color && v0.color == v2.color )
+    {
+        rasterize( triangle, clip, [&]( int y, int x0, int x1 ) {
+            fillSpan( data() + static_cast<size_t>( y ) * m_width + x0, x1 - x0 + 1, v0.color, blendMode );
+        } );
         return;
+    }
 
-    // Clamp to the size of the screen.
-    aabb.clamp( m_AABB );
+    const glm::vec2 texSize = texture ? glm::vec2 { texture->getWidth(), texture->getHeight() } : glm::vec2 { 0 };
 
-    Vertex verts[] = {
-        v0, v1, v2, v3
-    };
+    AttributePlanes planes;
+    if ( !planes.setup( v0, v1, v2, texSize ) )
+        return;
 
-    // Index buffer for the two triangles of the quad.
-    const uint32_t indicies[] = {
-        0, 1, 3,
-        1, 2, 3
+    auto draw = [&]( auto&& fetch ) {
+        rasterize(
+            triangle, clip, [&]( int y, int x0, int x1 ) {
+                shadeSpan( data() + static_cast<size_t>( y ) * m_width + x0, x0, y, x1 - x0 + 1, planes, blendMode, fetch );
+            },
+            TexturedPixelCost );
     };
 
-    const BlendMode blendMode = _blendMode;
-
-#pragma omp parallel for schedule( dynamic ) firstprivate( aabb, indicies, verts, addressMode, blendMode )
-    for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
+    if ( !texture )
     {
-        for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
-        {
-            for ( uint32_t i = 0; i < std::size( indicies ); i += 3 )
-            {
-                const uint32_t i0 = indicies[i + 0];
-                const uint32_t i1 = indicies[i + 1];
-                const uint32_t i2 = indicies[i + 2];
-
-                glm::vec3 bc = barycentric( verts[i0].position, verts[i1].position, verts[i2].position, { x, y } );
-                if ( barycentricInside( bc ) )
-                {
-                    // Compute interpolated UV
-                    const glm::vec2 texCoord = verts[i0].texCoord * bc.x + verts[i1].texCoord * bc.y + verts[i2].texCoord * bc.z;
-                    const Color     color    = verts[i0].color * bc.x + verts[i1].color * bc.y + verts[i2].color * bc.z;
-                    // Sample the texture.
-                    const Color c = image.sample( texCoord.x, texCoord.y, addressMode ) * color;
-                    // Plot.
-                    plot<false>( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ), c, blendMode );
-                }
-            }
-        }
+        // The vertex colors are interpolated (they are multiplied by white texels).
+        draw( []( int64_t, int64_t ) { return Color::White; } );
+        return;
     }
+
+    // Round to the nearest texel.
+    draw( [&]( int64_t u, int64_t v ) {
+        return texture->sample( static_cast<int>( ( u + 0x8000 ) >> 16 ), static_cast<int>( ( v + 0x8000 ) >> 16 ), addressMode );
+    } );
 }
 
 void Image::drawAABB( AABB aabb, const Color& color, const BlendMode& blendMode, FillMode fillMode ) noexcept
@@ -449,22 +1869,33 @@ void Image::drawAABB( AABB aabb, const Color& color, const BlendMode& blendMode,
     break;
     case FillMode::Solid:
     {
-        // Clamp to screen bounds.
-        aabb.clamp( m_AABB );
+        markDirty( aabb );
 
-#pragma omp parallel for schedule( dynamic ) firstprivate( aabb )
-        for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
-        {
-            for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
-            {
-                plot<false>( x, y, color, blendMode );
-            }
-        }
+        if ( m_CommandBuffer )
+            m_CommandBuffer->push( AABBCommand { aabb, color, blendMode }, aabb );
+        else
+            drawAABBImpl( aabb, color, blendMode, m_AABB );
     }
     break;
     }
 }
 
+void Image::drawAABBImpl( AABB aabb, const Color& color, const BlendMode& blendMode, const AABB& clip ) noexcept
+{
+    // Clamp to the clip region.
+    aabb.clamp( clip );
+
+    if ( !aabb.isValid() )
+        return;
+
+    const int x     = static_cast<int>( aabb.min.x );
+    const int width = static_cast<int>( aabb.max.x ) - x + 1;
+
+    parallelRows( static_cast<int>( aabb.min.y ), static_cast<int>( aabb.max.y ) + 1, width, [&]( int y ) {
+        fillSpan( data() + static_cast<size_t>( y ) * m_width + x, width, color, blendMode );
+    } );
+}
+
 void Image::drawCircle( const Math::Circle& c, const Color& color, const BlendMode& blendMode, FillMode fillMode ) noexcept
 {
     if ( !m_AABB.intersect( c ) )
@@ -490,23 +1921,23 @@ void Image::drawCircle( const Math::Circle& c, const Color& color, const BlendMo
     }
 }
 
-void Image::drawSprite( const Sprite& sprite, const glm::mat3& matrix ) noexcept
+/// <summary>
+/// Compute the transformed vertices of a sprite.
+/// </summary>
+/// <param name="sprite">The sprite to transform.</param>
+/// <param name="matrix">The transformation matrix.</param>
+/// <param name="verts">The transformed vertices (in clockwise order starting at the top-left corner).</param>
+/// <returns>The screen-space AABB of the transformed sprite.</returns>
+static AABB transformSprite( const Sprite& sprite, const glm::mat3& matrix, Vertex ( &verts )[4] ) noexcept
 {
-    std::shared_ptr<Image> image = sprite.getImage();
-    if ( !image )
-        return;
-
-    const Color       color     = sprite.getColor();
-    const BlendMode   blendMode = sprite.getBlendMode();
-    const glm::ivec2& uv        = sprite.getUV();
-    const glm::ivec2& size      = sprite.getSize();
+    const Color       color = sprite.getColor();
+    const glm::ivec2& uv    = sprite.getUV();
+    const glm::ivec2& size  = sprite.getSize();
 
-    Vertex verts[] = {
-        Vertex { { 0, 0 }, { uv.x, uv.y }, color },                                              // Top-left
-        Vertex { { size.x - 1, 0 }, { uv.x + size.x - 1, uv.y }, color },                        // Top-right
-        Vertex { { size.x - 1, size.y - 1 }, { uv.x + size.x - 1, uv.y + size.y - 1 }, color },  // Bottom-right
-        Vertex { { 0, size.y - 1 }, { uv.x, uv.y + size.y - 1 }, color }                         // Bottom-left
-    };
+    verts[0] = Vertex { { 0, 0 }, { uv.x, uv.y }, color };                                              // Top-left
+    verts[1] = Vertex { { size.x - 1, 0 }, { uv.x + size.x - 1, uv.y }, color };                        // Top-right
+    verts[2] = Vertex { { size.x - 1, size.y - 1 }, { uv.x + size.x - 1, uv.y + size.y - 1 }, color };  // Bottom-right
+    verts[3] = Vertex { { 0, size.y - 1 }, { uv.x, uv.y + size.y - 1 }, color };                        // Bottom-left
 
     // Transform verts.
     for ( Vertex& v: verts )
@@ -515,55 +1946,172 @@ void Image::drawSprite( const Sprite& sprite, const glm::mat3& matrix ) noexcept
     }
 
     // Compute an AABB over the sprite quad.
-    AABB aabb {
+    return {
         { verts[0].position, 0.0f },
         { verts[1].position, 0.0f },
         { verts[2].position, 0.0f },
         { verts[3].position, 0.0f }
     };
+}
 
-    // Check if the AABB of the sprite is on screen.
-    if ( !m_AABB.intersect( aabb ) )
+void Image::drawSprite( const Sprite& sprite, const glm::mat3& _matrix ) noexcept
+{
+    if ( !sprite.getImage() )
         return;
 
-    // Clamp to the size of the screen.
-    aabb.clamp( m_AABB );
+    // Move trimmed sprites to their position in the untrimmed frame.
+    const glm::ivec2 offset = sprite.getOffset();
+    glm::mat3        matrix = _matrix;
+    matrix[2] += matrix[0] * static_cast<float>( offset.x ) + matrix[1] * static_cast<float>( offset.y );
 
-    // Index buffer for the two triangles of the quad.
-    const uint32_t indicies[] = {
-        0, 1, 3,
-        1, 2, 3
-    };
+    if ( m_CommandBuffer || m_DirtyTracking )
+    {
+        Vertex     verts[4];
+        const AABB bounds = transformSprite( sprite, matrix, verts );
+
+        markDirty( bounds );
+
+        if ( m_CommandBuffer )
+        {
+            m_CommandBuffer->push( SpriteCommand { sprite, matrix }, bounds );
+            return;
+        }
+    }
+
+    drawSpriteImpl( sprite, matrix, m_AABB );
+}
+
+void Image::drawSpriteImpl( const Sprite& sprite, const glm::mat3& matrix, const AABB& clip ) noexcept
+{
+    const Image* image = sprite.getImage().get();
+    if ( !image )
+        return;
+
+    const Color     color     = sprite.getColor();
+    const BlendMode blendMode = sprite.getBlendMode();
 
-#pragma omp parallel for schedule( dynamic ) firstprivate( aabb, indicies, verts, color, blendMode )
-    for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
+    // Tiles, backgrounds, and UI elements are usually only translated (and scaled), so the sprite stays axis-aligned.
+    if ( matrix[0][1] == 0.0f && matrix[1][0] == 0.0f )
     {
-        for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
+        const glm::vec2 scale { matrix[0][0], matrix[1][1] };
+        const glm::vec2 translation { matrix[2][0], matrix[2][1] };
+
+        if ( scale.x == 0.0f || scale.y == 0.0f )
+            return;
+
+        // A 1:1 copy to integer coordinates.
+        if ( scale == glm::vec2 { 1.0f } && translation == glm::floor( translation ) )
         {
-            for ( uint32_t i = 0; i < std::size( indicies ); i += 3 )
-            {
-                const uint32_t i0 = indicies[i + 0];
-                const uint32_t i1 = indicies[i + 1];
-                const uint32_t i2 = indicies[i + 2];
+            drawSpriteImpl( sprite, static_cast<int>( translation.x ), static_cast<int>( translation.y ), clip );
+            return;
+        }
 
-                glm::vec3 bc = barycentric( verts[i0].position, verts[i1].position, verts[i2].position, { x, y } );
-                if ( barycentricInside( bc ) )
-                {
-                    // Compute interpolated UV
-                    const glm::ivec2 texCoord = round( verts[i0].texCoord * bc.x + verts[i1].texCoord * bc.y + verts[i2].texCoord * bc.z );
-                    // Sample the sprite's texture.
-                    const Color c = image->sample( texCoord.x, texCoord.y, AddressMode::Clamp ) * color;
-                    // Plot.
-                    plot<false>( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ), c, blendMode );
-                }
-            }
+        const glm::ivec2 uv   = sprite.getUV();
+        const glm::ivec2 size = sprite.getSize();
+
+        // The pixels (with integer coordinates) that are covered by the sprite.
+        const glm::vec2 p0 = translation;
+        const glm::vec2 p1 = translation + scale * glm::vec2 { size - 1 };
+        const int       x0 = std::max( static_cast<int>( std::ceil( std::min( p0.x, p1.x ) ) ), static_cast<int>( clip.min.x ) );
+        const int       y0 = std::max( static_cast<int>( std::ceil( std::min( p0.y, p1.y ) ) ), static_cast<int>( clip.min.y ) );
+        const int       x1 = std::min( static_cast<int>( std::floor( std::max( p0.x, p1.x ) ) ), static_cast<int>( clip.max.x ) ) + 1;
+        const int       y1 = std::min( static_cast<int>( std::floor( std::max( p0.y, p1.y ) ) ), static_cast<int>( clip.max.y ) ) + 1;
+
+        // Sprite coordinates at pixel (0, 0), and per pixel.
+        const glm::vec2 duv      = 1.0f / scale;
+        const glm::vec2 uvOrigin = -translation * duv;
+
+        // Texels are clamped to the sprite rectangle (and the image, like AddressMode::Clamp).
+        const glm::ivec2 minUV = glm::max( uv, glm::ivec2 { 0 } );
+        const glm::ivec2 maxUV = glm::min( uv + size, glm::ivec2 { image->getWidth(), image->getHeight() } ) - 1;
+
+        if ( sprite.getFilterMode() != FilterMode::Point )
+        {
+            const RectI          rect = sprite.getRect();
+            const TextureSampler sampler { *image, sprite.getFilterMode(), AddressMode::Clamp, TextureSampler::computeLOD( { duv.x, 0.0f }, { 0.0f, duv.y } ), &rect };
+
+            drawFilteredRows( data(), m_width, x0, y0, x1, y1, glm::vec2 { uv } + uvOrigin, duv, color, blendMode, sampler );
+            return;
+        }
+
+        auto drawRows = [&]( auto&& fetch ) {
+            drawScaledRows( data(), m_width, x0, y0, x1, y1, glm::vec2 { uv } + uvOrigin, duv, color, blendMode, [&]( int u, int v ) {
+                return fetch( std::clamp( u, minUV.x, maxUV.x ), std::clamp( v, minUV.y, maxUV.y ) );
+            } );
+        };
+
+        if ( image->getTextureLayout() == TextureLayout::Tiled )
+        {
+            drawRows( [&]( int u, int v ) { return image->texel( static_cast<uint32_t>( u ), static_cast<uint32_t>( v ) ); } );
+            return;
         }
+
+        const Color* src    = image->data();
+        const size_t stride = image->getWidth();
+
+        drawRows( [&]( int u, int v ) { return src[static_cast<size_t>( v ) * stride + u]; } );
+        return;
+    }
+
+    Vertex verts[4];
+    AABB   aabb = transformSprite( sprite, matrix, verts );
+
+    // Check if the AABB of the sprite is on screen.
+    if ( !clip.intersect( aabb ) )
+        return;
+
+    // Clamp to the clip region.
+    aabb.clamp( clip );
+
+    if ( sprite.getFilterMode() != FilterMode::Point )
+    {
+        const RectI          rect = sprite.getRect();
+        const float          lod  = triangleLOD( verts[0].position, verts[1].position, verts[3].position, verts[0].texCoord, verts[1].texCoord, verts[3].texCoord );
+        const TextureSampler sampler { *image, sprite.getFilterMode(), AddressMode::Clamp, lod, &rect };
+
+        drawTexturedQuad( *this, verts, glm::vec2 { 1.0f }, aabb, blendMode, [&]( int64_t u, int64_t v ) {
+            return sampler( glm::vec2 { u, v } * ( 1.0f / 65536.0f ) );
+        } );
+        return;
     }
+
+    // The texture coordinates of the sprite are in texels. Round to the nearest texel.
+    drawTexturedQuad( *this, verts, glm::vec2 { 1.0f }, aabb, blendMode, [&]( int64_t u, int64_t v ) {
+        return image->sample( static_cast<int>( ( u + 0x8000 ) >> 16 ), static_cast<int>( ( v + 0x8000 ) >> 16 ), AddressMode::Clamp );
+    } );
 }
 
 void Image::drawSprite( const Sprite& sprite, int x, int y ) noexcept
 {
-    std::shared_ptr<Image> image = sprite.getImage();
+    if ( !sprite.getImage() )
+        return;
+
+    // Move trimmed sprites to their position in the untrimmed frame.
+    x += sprite.getOffset().x;
+    y += sprite.getOffset().y;
+
+    const glm::ivec2 size = sprite.getSize();
+
+    markDirty( RectI { x, y, size.x, size.y } );
+
+    if ( m_CommandBuffer )
+    {
+        const AABB bounds {
+            { x, y, 0 },
+            { x + size.x - 1, y + size.y - 1, 0 }
+        };
+
+        m_CommandBuffer->push( SpriteCopyCommand { sprite, x, y }, bounds );
+    }
+    else
+    {
+        drawSpriteImpl( sprite, x, y, m_AABB );
+    }
+}
+
+void Image::drawSpriteImpl( const Sprite& sprite, int x, int y, const AABB& clip ) noexcept
+{
+    const Image* image = sprite.getImage().get();
     if ( !image )
         return;
 
@@ -572,73 +2120,125 @@ void Image::drawSprite( const Sprite& sprite, int x, int y ) noexcept
     const glm::ivec2 uv        = sprite.getUV();
     const glm::ivec2 size      = sprite.getSize();
 
-    // Source sprite coords
-    const int sX = x < 0 ? -x : 0;
-    const int sY = y < 0 ? -y : 0;
-    const int sW = size.x - sX;
-    const int sH = size.y - sY;
+    // Destination region.
+    const int dX0 = std::max( x, static_cast<int>( clip.min.x ) );
+    const int dY0 = std::max( y, static_cast<int>( clip.min.y ) );
+    const int dX1 = std::min( x + size.x, static_cast<int>( clip.max.x ) + 1 );
+    const int dY1 = std::min( y + size.y, static_cast<int>( clip.max.y ) + 1 );
 
     // Check if the sprite is offscreen.
-    if ( sW <= 0 || sH <= 0 )
-        return;
-
-    // Destination coords.
-    const int dX = x < 0 ? 0 : x;
-    const int dY = y < 0 ? 0 : y;
-    const int dW = static_cast<int>( m_width ) - dX;
-    const int dH = static_cast<int>( m_height ) - dY;
-
-    // Check if the destination region is offscreen.
-    if ( dW <= 0 || dH <= 0 )
+    if ( dX0 >= dX1 || dY0 >= dY1 )
         return;
 
     // Source image width.
     const int iW = static_cast<int>( image->getWidth() );
 
-    // The destination copy region is the minimum of the source
-    // and destination dimensions.
-    const int w = std::min( sW, dW );
-    const int h = std::min( sH, dH );
-    const int a = w * h;
+    // Offset from the destination to the source coordinates.
+    const int oX = uv.x - x;
+    const int oY = uv.y - y;
 
-    const Color* src = image->data();
-    Color*       dst = data();
+    Color* dst = data();
 
-#pragma omp parallel for firstprivate( w, h, a, iW, color, blendMode )
-    for ( int i = 0; i < a; ++i )
+    // The rows of a tiled image are gathered in chunks.
+    if ( image->getTextureLayout() == TextureLayout::Tiled )
     {
-        const int x  = i % w;
-        const int y  = i / w;
-        const int dx = dX + x;
-        const int dy = dY + y;
-        const int sx = ( sX + uv.x ) + x;
-        const int sy = ( sY + uv.y ) + y;
-
-        Color dC = dst[dy * m_width + dx];
-        Color sC = src[sy * iW + sx] * color;
+        parallelRows( dY0, dY1, dX1 - dX0, [&]( int dy ) {
+            Color row[256];
+            for ( int dx = dX0; dx < dX1; dx += static_cast<int>( std::size( row ) ) )
+            {
+                const int n = std::min( dX1 - dx, static_cast<int>( std::size( row ) ) );
 
-        dst[dy * m_width + dx] = blendMode.Blend( sC, dC );
+                image->readRow( static_cast<uint32_t>( dx + oX ), static_cast<uint32_t>( dy + oY ), static_cast<uint32_t>( n ), row );
+                blendSpan( dst + static_cast<size_t>( dy ) * m_width + dx, row, n, color, blendMode );
+            }
+        } );
+        return;
     }
+
+    const Color* src = image->data();
+
+    parallelRows( dY0, dY1, dX1 - dX0, [&]( int dy ) {
+        blendSpan( dst + static_cast<size_t>( dy ) * m_width + dX0, src + static_cast<size_t>( dy + oY ) * iW + dX0 + oX, dX1 - dX0, color, blendMode );
+    } );
 }
 
 void Image::drawText( const Font& font, std::string_view text, int x, int y, const Color& color ) noexcept
 {
-    font.drawText( *this, text, x, y, color );
+    drawGlyphRun( font.getGlyphRun( text, color ), x, y );
 }
 
 void Image::drawText( const Font& font, std::wstring_view text, int x, int y, const Color& color ) noexcept
 {
-    font.drawText( *this, text, x, y, color );
+    drawGlyphRun( font.getGlyphRun( text, color ), x, y );
+}
+
+void Image::drawGlyphRun( std::shared_ptr<const GlyphRun> run, int x, int y ) noexcept
+{
+    if ( !run || run->spans.empty() )
+        return;
+
+    const RectI& b = run->bounds;
+
+    markDirty( RectI { x + b.left, y + b.top, b.width, b.height } );
+
+    if ( m_CommandBuffer )
+    {
+        const AABB bounds {
+            { x + b.left, y + b.top, 0 },
+            { x + b.right() - 1, y + b.bottom() - 1, 0 }
+        };
+
+        // The command shares ownership of the run, so it stays alive even if it is evicted from the font's cache.
+        m_CommandBuffer->push( GlyphRunCommand { std::move( run ), x, y }, bounds );
+    }
+    else
+    {
+        drawGlyphRunImpl( *run, x, y, m_AABB );
+    }
 }
 
-constexpr int fast_floor( float x ) noexcept
+void Image::drawGlyphRunImpl( const GlyphRun& run, int x, int y, const AABB& clip ) noexcept
 {
-    return static_cast<int>( static_cast<double>( x ) + 1073741823.0 ) - 1073741823;
+    const int minX = static_cast<int>( clip.min.x );
+    const int minY = static_cast<int>( clip.min.y );
+    const int maxX = static_cast<int>( clip.max.x );
+    const int maxY = static_cast<int>( clip.max.y );
+
+    const auto   numSpans = static_cast<int>( run.spans.size() );
+    const auto   avgCount = static_cast<int64_t>( run.pixels.size() ) / numSpans;
+    Color*       dst      = data();
+    const Color* src      = run.pixels.data();
+
+    // The spans don't overlap, so they can be blended in parallel (short strings are blended on the calling thread).
+    ThreadPool::get().parallelFor(
+        0, numSpans, [&]( int first, int last ) {
+            for ( int i = first; i < last; ++i )
+            {
+                const GlyphRun::Span& span = run.spans[i];
+
+                const int sy = y + span.y;
+                const int sx = x + span.x;
+                const int x0 = std::max( sx, minX );
+                const int x1 = std::min( sx + span.count - 1, maxX );
+
+                if ( sy < minY || sy > maxY || x0 > x1 )
+                    continue;
+
+                blendSpan( dst + static_cast<size_t>( sy ) * m_width + x0, src + span.offset + ( x0 - sx ), x1 - x0 + 1, Color::White, run.blendMode );
+            }
+        },
+        avgCount );
 }
 
+// The remainder of x / y, rounded towards negative infinity (y must be positive).
+// Textures with a power of two size only need a mask.
 constexpr int fast_mod( int x, int y ) noexcept
 {
-    return x - y * fast_floor( static_cast<float>( x ) / static_cast<float>( y ) );
+    if ( ( y & ( y - 1 ) ) == 0 )
+        return x & ( y - 1 );
+
+    const int m = x % y;
+    return m < 0 ? m + y : m;
 }
 
 const Color& Image::sample( int u, int v, AddressMode addressMode ) const noexcept
@@ -671,5 +2271,160 @@ const Color& Image::sample( int u, int v, AddressMode addressMode ) const noexce
     assert( u >= 0 && u < w );
     assert( v >= 0 && v < h );
 
-    return m_data[static_cast<uint64_t>( v ) * m_width + u];
+    return m_data[index( static_cast<uint32_t>( u ), static_cast<uint32_t>( v ) )];
+}
+
+Color Image::sample( const glm::vec2& uv, FilterMode filterMode, float lod, AddressMode addressMode ) const noexcept
+{
+    if ( filterMode == FilterMode::Point )
+        return sample( uv.x, uv.y, addressMode );
+
+    const TextureSampler sampler { *this, filterMode, addressMode, lod };
+
+    return sampler( uv * glm::vec2 { m_width, m_height } );
+}
+
+/// <summary>
+/// Downsample an image to half its size (rounded down) with a 2x2 box filter.
+/// </summary>
+static Image downsample( const Image& src )
+{
+    const uint32_t w = std::max( src.getWidth() / 2u, 1u );
+    const uint32_t h = std::max( src.getHeight() / 2u, 1u );
+
+    Image dst { w, h };
+
+    for ( uint32_t y = 0; y < h; ++y )
+    {
+        const uint32_t y0 = std::min( y * 2u, src.getHeight() - 1u );
+        const uint32_t y1 = std::min( y * 2u + 1u, src.getHeight() - 1u );
+
+        for ( uint32_t x = 0; x < w; ++x )
+        {
+            const uint32_t x0 = std::min( x * 2u, src.getWidth() - 1u );
+            const uint32_t x1 = std::min( x * 2u + 1u, src.getWidth() - 1u );
+
+            const Color& a = src( x0, y0 );
+            const Color& b = src( x1, y0 );
+            const Color& c = src( x0, y1 );
+            const Color& d = src( x1, y1 );
+
+            dst( x, y ) = {
+                static_cast<uint8_t>( ( a.r + b.r + c.r + d.r + 2 ) / 4 ),
+                static_cast<uint8_t>( ( a.g + b.g + c.g + d.g + 2 ) / 4 ),
+                static_cast<uint8_t>( ( a.b + b.b + c.b + d.b + 2 ) / 4 ),
+                static_cast<uint8_t>( ( a.a + b.a + c.a + d.a + 2 ) / 4 ),
+            };
+        }
+    }
+
+    return dst;
+}
+
+const Image& Image::getMipLevel( uint32_t level ) const
+{
+    if ( level == 0 || getNumMipLevels() <= 1 )
+        return *this;
+
+    const MipChain* mipChain = m_MipChain.load( std::memory_order_acquire );
+
+    if ( !mipChain )
+    {
+        // The levels are built on the calling thread (not the thread pool), because other threads may be waiting for the lock.
+        std::lock_guard lock { g_MipChainMutex };
+
+        mipChain = m_MipChain.load( std::memory_order_relaxed );
+        if ( !mipChain )
+        {
+            auto newChain = std::make_unique<MipChain>();
+            newChain->levels.reserve( getNumMipLevels() - 1 );
+
+            for ( const Image* prev = this; prev->m_width > 1 || prev->m_height > 1; prev = &newChain->levels.back() )
+            {
+                newChain->levels.push_back( downsample( *prev ) );
+
+                // The mip levels use the layout of level 0.
+                newChain->levels.back().setTextureLayout( m_Layout );
+            }
+
+            mipChain = newChain.get();
+            m_MipChain.store( newChain.release(), std::memory_order_release );
+        }
+    }
+
+    return mipChain->levels[std::min<size_t>( level, mipChain->levels.size() ) - 1];
+}
+
+uint32_t Image::getNumMipLevels() const noexcept
+{
+    return std::bit_width( std::max( m_width, m_height ) );
+}
+
+void Image::generateMipmaps()
+{
+    {
+        std::lock_guard lock { g_MipChainMutex };
+        delete m_MipChain.exchange( nullptr );
+    }
+
+    getMipLevel( 1 );
+}
+
+void Image::setTextureLayout( TextureLayout layout )
+{
+    if ( layout == m_Layout )
+        return;
+
+    if ( m_data )
+    {
+        auto pixels = make_aligned_unique<Color[], 64>( getBufferSize( layout, m_width, m_height ) );
+
+        // Both layouts store runs of 4 pixels of a row (starting at a multiple of 4) contiguously.
+        for ( uint32_t y = 0; y < m_height; ++y )
+        {
+            for ( uint32_t x = 0; x < m_width; x += 4u )
+                readRow( x, y, std::min( m_width - x, 4u ), pixels.get() + index( layout, m_width, x, y ) );
+        }
+
+        m_data = { pixels.release(), PixelDeleter {} };
+    }
+
+    m_Layout = layout;
+
+    if ( MipChain* mipChain = m_MipChain.load() )
+    {
+        for ( Image& level: mipChain->levels )
+            level.setTextureLayout( layout );
+    }
+}
+
+size_t Image::getBufferSize( TextureLayout layout, uint32_t width, uint32_t height ) noexcept
+{
+    if ( layout == TextureLayout::Tiled )
+        return static_cast<size_t>( ( width + 3u ) / 4u ) * ( ( height + 3u ) / 4u ) * 16u;
+
+    return static_cast<size_t>( width ) * height;
+}
+
+void Image::readRow( uint32_t x, uint32_t y, uint32_t count, Color* dst ) const noexcept
+{
+    assert( x + count <= m_width );
+    assert( y < m_height );
+
+    if ( m_Layout == TextureLayout::Linear )
+    {
+        std::memcpy( dst, m_data.get() + static_cast<size_t>( y ) * m_width + x, count * sizeof( Color ) );
+        return;
+    }
+
+    // In a tiled image, the pixels of a row are contiguous up to the end of the block.
+    while ( count > 0 )
+    {
+        const uint32_t n = std::min( 4u - x % 4u, count );
+        std::memcpy( dst, m_data.get() + index( x, y ), n * sizeof( Color ) );
+
+        dst += n;
+        x += n;
+        count -= n;
+    }
 }
@@ -0,0 +1,63 @@
+#include "PixelStream.hpp"
+
+#include <Graphics/ThreadPool.hpp>
+
+#include <cstring>
+
+using namespace Graphics;
+using namespace Math;
+
+void PixelStream::upload( const Image& image )
+{
+    if ( !image )
+        return;
+
+    const uint32_t width  = image.getWidth();
+    const uint32_t height = image.getHeight();
+
+    bool full = !image.isDirtyTracking() || &image != m_Image;
+
+    if ( width != m_Width || height != m_Height )
+    {
+        allocate( width, height );
+        m_Width  = width;
+        m_Height = height;
+        m_Slot   = 0u;
+        full     = true;
+    }
+
+    m_Image = &image;
+
+    m_Regions.clear();
+    if ( full )
+        m_Regions.push_back( image.getRect() );
+    else
+        m_Regions.assign( image.getDirtyRects().begin(), image.getDirtyRects().end() );
+
+    // Nothing changed since the previous frame.
+    if ( m_Regions.empty() )
+        return;
+
+    Color*       dst = acquire( m_Slot );
+    const Color* src = image.data();
+
+    // The staging buffers have the same layout as the image, so the regions are copied to the same offsets.
+    for ( const RectI& r: m_Regions )
+    {
+        const size_t rowSize = static_cast<size_t>( r.width ) * sizeof( Color );
+
+        ThreadPool::get().parallelFor(
+            r.top, r.bottom(), [&]( int first, int last ) {
+                for ( int y = first; y < last; ++y )
+                {
+                    const size_t offset = static_cast<size_t>( y ) * width + r.left;
+                    std::memcpy( dst + offset, src + offset, rowSize );
+                }
+            },
+            r.width );
+    }
+
+    transfer( m_Slot, m_Regions );
+
+    m_Slot = ( m_Slot + 1u ) % RingSize;
+}
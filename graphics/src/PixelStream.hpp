@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Graphics/Image.hpp>
+
+#include <Math/Rect.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Graphics
+{
+/// <summary>
+/// Streams the pixels of presented images to a texture through a ring of staging buffers.
+/// The texture storage and the staging buffers are only allocated when the size of the presented image changes.
+/// Each frame is copied to the next staging buffer in the ring, so the rasterizer can start on the next frame
+/// while the previous frames are still being transferred to the texture.
+/// If the same image is presented again with dirty rectangle tracking enabled, only the dirty rectangles are streamed.
+/// </summary>
+/// <remarks>
+/// The backends implement the storage and the transfers (for example, persistently mapped pixel buffers in OpenGL).
+/// </remarks>
+class PixelStream
+{
+public:
+    /// <summary>
+    /// The number of staging buffers in the ring.
+    /// </summary>
+    static constexpr uint32_t RingSize = 3u;
+
+    virtual ~PixelStream() = default;
+
+    /// <summary>
+    /// Stream the pixels of an image to the texture.
+    /// </summary>
+    /// <param name="image">The image to upload.</param>
+    void upload( const Image& image );
+
+    /// <summary>
+    /// Get the width of the texture (in pixels).
+    /// </summary>
+    uint32_t getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    /// <summary>
+    /// Get the height of the texture (in pixels).
+    /// </summary>
+    uint32_t getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+protected:
+    /// <summary>
+    /// Allocate the texture and the staging buffers. The previous storage (if any) can be released.
+    /// Each staging buffer holds width * height pixels.
+    /// </summary>
+    /// <param name="width">The width of the texture (in pixels).</param>
+    /// <param name="height">The height of the texture (in pixels).</param>
+    virtual void allocate( uint32_t width, uint32_t height ) = 0;
+
+    /// <summary>
+    /// Wait until the previous transfer from a staging buffer is complete, and get a pointer to its pixels.
+    /// </summary>
+    /// <param name="slot">The index of the staging buffer in the ring.</param>
+    /// <returns>The pixels of the staging buffer (with a pitch of width pixels).</returns>
+    virtual Color* acquire( uint32_t slot ) = 0;
+
+    /// <summary>
+    /// Start the transfer of regions of a staging buffer to the same regions of the texture.
+    /// </summary>
+    /// <param name="slot">The index of the staging buffer in the ring.</param>
+    /// <param name="regions">The regions to transfer.</param>
+    virtual void transfer( uint32_t slot, std::span<const Math::RectI> regions ) = 0;
+
+private:
+    uint32_t                 m_Width  = 0u;
+    uint32_t                 m_Height = 0u;
+    uint32_t                 m_Slot   = 0u;       ///< The next staging buffer in the ring.
+    const Image*             m_Image  = nullptr;  ///< The image that was uploaded last.
+    std::vector<Math::RectI> m_Regions;           ///< The regions to stream this frame.
+};
+}  // namespace Graphics
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Graphics
+{
+/// <summary>
+/// The number of sub-pixel bits used by the rasterizer.
+/// Vertex positions are snapped to 1/256th of a pixel.
+/// </summary>
+constexpr int     SubPixelBits  = 8;
+constexpr int64_t SubPixelScale = int64_t { 1 } << SubPixelBits;
+
+/// <summary>
+/// Vertices further than this (in pixels) from the origin are rejected.
+/// This keeps the fixed-point edge equations well within 64-bit range.
+/// </summary>
+constexpr float GuardBand = static_cast<float>( 1 << 21 );
+
+/// <summary>
+/// Round to the nearest integer, with halfway cases rounded away from zero (like std::llround, which is a library call without SSE4.1).
+/// </summary>
+constexpr int64_t roundToInt64( double d ) noexcept
+{
+    return static_cast<int64_t>( d < 0.0 ? d - 0.5 : d + 0.5 );
+}
+
+/// <summary>
+/// Convert a floating-point pixel coordinate to 24.8 fixed-point.
+/// </summary>
+constexpr int64_t toFixed( float f ) noexcept
+{
+    return roundToInt64( static_cast<double>( f ) * SubPixelScale );
+}
+
+/// <summary>
+/// Integer division that rounds towards negative infinity (the divisor must be positive).
+/// </summary>
+constexpr int64_t floorDiv( int64_t a, int64_t b ) noexcept
+{
+    const int64_t q = a / b;
+    return ( a % b != 0 && a < 0 ) ? q - 1 : q;
+}
+
+/// <summary>
+/// Integer division that rounds towards positive infinity (the divisor must be positive).
+/// </summary>
+constexpr int64_t ceilDiv( int64_t a, int64_t b ) noexcept
+{
+    const int64_t q = a / b;
+    return ( a % b != 0 && a > 0 ) ? q + 1 : q;
+}
+
+/// <summary>
+/// A fixed-point edge function E(x, y) = A * x + B * y + C for the directed edge (a, b).
+/// E(x, y) is positive for points to the right of the edge (in screen space, where +y points down).
+/// </summary>
+struct EdgeFunction
+{
+    EdgeFunction() = default;
+
+    EdgeFunction( int64_t ax, int64_t ay, int64_t bx, int64_t by, bool inclusive = false ) noexcept
+    : A { ay - by }
+    , B { bx - ax }
+    , C { ax * by - ay * bx }
+    {
+        // Top-left fill rule: pixels exactly on an edge belong to the polygon only
+        // if the edge is a left edge or a horizontal top edge. All other edges require
+        // E(x, y) > 0, which for integer edge values is the same as E(x, y) - 1 >= 0.
+        if ( !inclusive && !( A > 0 || ( A == 0 && B > 0 ) ) )
+            C -= 1;
+    }
+
+    /// <summary>
+    /// Evaluate the edge function at the center of pixel (x, y).
+    /// </summary>
+    int64_t operator()( int x, int y ) const noexcept
+    {
+        return A * ( static_cast<int64_t>( x ) << SubPixelBits ) + B * ( static_cast<int64_t>( y ) << SubPixelBits ) + C;
+    }
+
+    int64_t A = 0;
+    int64_t B = 0;
+    int64_t C = 0;
+};
+
+/// <summary>
+/// Scanline rasterizer for convex polygons with N vertices.
+/// Pixel (x, y) is sampled at the integer coordinate (x, y).
+/// The polygon is set up once; each row then only needs to find the span
+/// of covered pixels from the edge equations, so pixels outside of the polygon
+/// are never visited.
+/// </summary>
+/// <typeparam name="N">The number of vertices (and edges) of the polygon.</typeparam>
+template<int N>
+class EdgeRasterizer
+{
+public:
+    static_assert( N >= 3 );
+
+    /// <summary>
+    /// An empty polygon.
+    /// </summary>
+    EdgeRasterizer() = default;
+
+    /// <summary>
+    /// Set up the edges of a polygon.
+    /// </summary>
+    /// <param name="verts">The vertices of the polygon (in either winding order).</param>
+    /// <param name="inclusive">(optional) Pixels that are exactly on any edge belong to the polygon, instead of
+    /// applying the top-left fill rule. Used for polygons whose vertices are at the centers of the outer pixels,
+    /// like sprites. Adjacent inclusive polygons draw the pixels on their shared edge twice.</param>
+    explicit EdgeRasterizer( const glm::vec2 ( &verts )[N], bool inclusive = false ) noexcept
+    {
+        int64_t x[N], y[N];
+
+        for ( int i = 0; i < N; ++i )
+        {
+            if ( !( std::abs( verts[i].x ) < GuardBand && std::abs( verts[i].y ) < GuardBand ) )
+                return;
+
+            x[i] = toFixed( verts[i].x );
+            y[i] = toFixed( verts[i].y );
+        }
+
+        // Twice the signed area of the polygon (shoelace formula).
+        int64_t area = 0;
+        for ( int i = 0; i < N; ++i )
+        {
+            const int j = ( i + 1 ) % N;
+            area += x[i] * y[j] - x[j] * y[i];
+        }
+
+        // Degenerate polygons don't cover any pixels.
+        if ( area == 0 )
+            return;
+
+        // Make sure the interior is on the positive side of each edge.
+        if ( area < 0 )
+        {
+            std::reverse( x, x + N );
+            std::reverse( y, y + N );
+        }
+
+        int64_t minX = x[0], maxX = x[0];
+        int64_t minY = y[0], maxY = y[0];
+
+        for ( int i = 0; i < N; ++i )
+        {
+            const int j = ( i + 1 ) % N;
+            m_Edges[i]  = EdgeFunction { x[i], y[i], x[j], y[j], inclusive };
+
+            minX = std::min( minX, x[i] );
+            maxX = std::max( maxX, x[i] );
+            minY = std::min( minY, y[i] );
+            maxY = std::max( maxY, y[i] );
+        }
+
+        // Pixels whose centers are inside the bounding box of the polygon.
+        m_MinX = static_cast<int>( ceilDiv( minX, SubPixelScale ) );
+        m_MaxX = static_cast<int>( floorDiv( maxX, SubPixelScale ) );
+        m_MinY = static_cast<int>( ceilDiv( minY, SubPixelScale ) );
+        m_MaxY = static_cast<int>( floorDiv( maxY, SubPixelScale ) );
+    }
+
+    /// <summary>
+    /// Check if the polygon doesn't cover any pixel centers.
+    /// </summary>
+    bool empty() const noexcept
+    {
+        return m_MinX > m_MaxX || m_MinY > m_MaxY;
+    }
+
+    int minX() const noexcept
+    {
+        return m_MinX;
+    }
+
+    int maxX() const noexcept
+    {
+        return m_MaxX;
+    }
+
+    int minY() const noexcept
+    {
+        return m_MinY;
+    }
+
+    int maxY() const noexcept
+    {
+        return m_MaxY;
+    }
+
+    const EdgeFunction& edge( int i ) const noexcept
+    {
+        return m_Edges[i];
+    }
+
+    /// <summary>
+    /// Find the covered span of each row in the range [yBegin, yEnd) and invoke the span function
+    /// with `( y, x0, x1 )` where [x0, x1] is the (inclusive) range of covered pixels in that row.
+    /// The intercepts of the edges are stepped incrementally from one row to the next (a DDA with an integer
+    /// quotient and remainder), so only the setup divides.
+    /// </summary>
+    /// <param name="yBegin">The first row to rasterize.</param>
+    /// <param name="yEnd">One past the last row to rasterize.</param>
+    /// <param name="clipMinX">The left-most pixel that can be written.</param>
+    /// <param name="clipMaxX">The right-most pixel that can be written.</param>
+    /// <param name="spanFunc">The function to invoke for each non-empty span.</param>
+    template<typename SpanFunc>
+    void forEachSpan( int yBegin, int yEnd, int clipMinX, int clipMaxX, SpanFunc&& spanFunc ) const
+    {
+        const int xMin = std::max( clipMinX, m_MinX );
+        const int xMax = std::min( clipMaxX, m_MaxX );
+
+        if ( xMin > xMax )
+            return;
+
+        Intercept intercepts[N];
+        for ( int i = 0; i < N; ++i )
+            intercepts[i] = Intercept { m_Edges[i], yBegin };
+
+        for ( int y = yBegin; y < yEnd; ++y )
+        {
+            int64_t x0 = xMin;
+            int64_t x1 = xMax;
+
+            for ( Intercept& intercept: intercepts )
+            {
+                intercept.clip( x0, x1 );
+                intercept.step();
+            }
+
+            if ( x0 <= x1 )
+                spanFunc( y, static_cast<int>( x0 ), static_cast<int>( x1 ) );
+        }
+    }
+
+    /// <summary>
+    /// Find the covered span of a single row.
+    /// </summary>
+    /// <param name="y">The row.</param>
+    /// <param name="clipMinX">The left-most pixel that can be written.</param>
+    /// <param name="clipMaxX">The right-most pixel that can be written.</param>
+    /// <param name="x0">Receives the first covered pixel.</param>
+    /// <param name="x1">Receives the last covered pixel.</param>
+    /// <returns>`true` if the row covers any pixels (x0 &lt;= x1).</returns>
+    bool span( int y, int clipMinX, int clipMaxX, int& x0, int& x1 ) const noexcept
+    {
+        int64_t s0 = std::max( clipMinX, m_MinX );
+        int64_t s1 = std::min( clipMaxX, m_MaxX );
+
+        if ( y < m_MinY || y > m_MaxY )
+            s1 = s0 - 1;
+
+        for ( int i = 0; i < N && s0 <= s1; ++i )
+            clipToEdge( m_Edges[i], m_Edges[i]( 0, y ), s0, s1 );
+
+        x0 = static_cast<int>( s0 );
+        x1 = static_cast<int>( s1 );
+
+        return x0 <= x1;
+    }
+
+private:
+    // The pixel where an edge crosses a row: E(x, y) >= 0 for x >= -q (if A > 0), or for x <= q (if A < 0),
+    // where q = floor( E(0, y) / |A * S| ). The quotient and remainder are stepped from row to row.
+    struct Intercept
+    {
+        Intercept() = default;
+
+        Intercept( const EdgeFunction& edge, int y ) noexcept
+        : sign { edge.A > 0 ? 1 : edge.A < 0 ? -1 : 0 }
+        , m { std::abs( edge.A ) * SubPixelScale }
+        {
+            const int64_t row  = edge( 0, y );
+            const int64_t step = edge.B * SubPixelScale;
+
+            // Horizontal edges only keep the value of the edge function (in the remainder).
+            if ( m == 0 )
+            {
+                r  = row;
+                dr = step;
+                return;
+            }
+
+            q  = floorDiv( row, m );
+            r  = row - q * m;
+            dq = floorDiv( step, m );
+            dr = step - dq * m;
+        }
+
+        // Clip the span [x0, x1] to the pixels on the positive side of the edge.
+        void clip( int64_t& x0, int64_t& x1 ) const noexcept
+        {
+            if ( sign > 0 )
+                x0 = std::max( x0, -q );
+            else if ( sign < 0 )
+                x1 = std::min( x1, q );
+            else if ( r < 0 )
+                x1 = x0 - 1;  // Horizontal edge and this row is outside.
+        }
+
+        // Move to the next row.
+        void step() noexcept
+        {
+            q += dq;
+            r += dr;
+
+            if ( m != 0 && r >= m )
+            {
+                r -= m;
+                ++q;
+            }
+        }
+
+        int     sign = 0;
+        int64_t m    = 0;  ///< |A| * S (0 for horizontal edges).
+        int64_t q    = 0;  ///< floor( E(0, y) / m ).
+        int64_t r    = 0;  ///< E(0, y) - q * m, in [0, m).
+        int64_t dq   = 0;  ///< The steps of the quotient and the remainder per row.
+        int64_t dr   = 0;
+    };
+
+    // Clip the span [x0, x1] to the pixels on the positive side of an edge.
+    // `row` is the value of the edge function at pixel x = 0 of the row.
+    static void clipToEdge( const EdgeFunction& edge, int64_t row, int64_t& x0, int64_t& x1 ) noexcept
+    {
+        // Solve A * x * S + row >= 0 for the pixel x.
+        const int64_t a = edge.A * SubPixelScale;
+
+        if ( a > 0 )
+            x0 = std::max( x0, ceilDiv( -row, a ) );
+        else if ( a < 0 )
+            x1 = std::min( x1, floorDiv( row, -a ) );
+        else if ( row < 0 )
+            x1 = x0 - 1;  // Horizontal edge and this row is outside.
+    }
+
+    EdgeFunction m_Edges[N];
+
+    int m_MinX = 0;
+    int m_MaxX = -1;
+    int m_MinY = 0;
+    int m_MaxY = -1;
+};
+
+}  // namespace Graphics
@@ -1,7 +1,20 @@
 #include <Graphics/ResourceManager.hpp>
 
+#include <Graphics/Timer.hpp>
+
+#include "FontFace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional> // std::hash
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 using namespace Graphics;
 
@@ -12,12 +25,10 @@ struct FontKey
 {
     std::filesystem::path fontFile;
     float                 size;
-    uint32_t              firstChar;
-    uint32_t              numChars;
 
     bool operator==( const FontKey& other ) const
     {
-        return fontFile == other.fontFile && size == other.size && firstChar == other.firstChar && numChars == other.numChars;
+        return fontFile == other.fontFile && size == other.size;
     }
 };
 
@@ -81,33 +92,377 @@ struct std::hash<FontKey>
 
         hash_combine( seed, key.fontFile );
         hash_combine( seed, key.size );
-        hash_combine( seed, key.firstChar );
-        hash_combine( seed, key.numChars );
 
         return seed;
     }
 };
 
+template<typename T>
+using Future = ResourceManager::Future<T>;
+
+template<typename T>
+using Promise = std::promise<std::shared_ptr<T>>;
+
+/// <summary>
+/// The threads that load resources in the background.
+/// The threads are started when the first resource is loaded asynchronously.
+/// </summary>
+class Loader final
+{
+public:
+    ~Loader()
+    {
+        {
+            std::scoped_lock lock( m_Mutex );
+            m_Stop = true;
+        }
+
+        m_TaskCV.notify_all();
+
+        for ( auto& thread: m_Threads )
+            thread.join();
+    }
+
+    void enqueue( std::function<void()> task )
+    {
+        {
+            std::scoped_lock lock( m_Mutex );
+
+            if ( m_Threads.empty() )
+            {
+                // Leave a hardware thread for the main thread.
+                const uint32_t numThreads = std::clamp( std::thread::hardware_concurrency(), 2u, 5u ) - 1u;
+                for ( uint32_t i = 0; i < numThreads; ++i )
+                    m_Threads.emplace_back( &Loader::run, this );
+            }
+
+            m_Tasks.push( std::move( task ) );
+            ++m_Pending;
+        }
+
+        m_TaskCV.notify_one();
+    }
+
+    void waitIdle()
+    {
+        std::unique_lock lock( m_Mutex );
+        m_IdleCV.wait( lock, [this] { return m_Pending == 0; } );
+    }
+
+    size_t getPendingCount()
+    {
+        std::scoped_lock lock( m_Mutex );
+        return m_Pending;
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock( m_Mutex );
+
+        while ( true )
+        {
+            m_TaskCV.wait( lock, [this] { return m_Stop || !m_Tasks.empty(); } );
+
+            if ( m_Stop )
+                break;
+
+            auto task = std::move( m_Tasks.front() );
+            m_Tasks.pop();
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            if ( --m_Pending == 0 )
+                m_IdleCV.notify_all();
+        }
+    }
+
+    std::vector<std::thread>          m_Threads;
+    std::queue<std::function<void()>> m_Tasks;
+    size_t                            m_Pending = 0;  ///< The number of tasks that are queued or running.
+    bool                              m_Stop    = false;
+
+    std::mutex              m_Mutex;
+    std::condition_variable m_TaskCV;
+    std::condition_variable m_IdleCV;
+};
+
+/// <summary>
+/// A completion callback that is waiting for a resource to be loaded.
+/// </summary>
+struct Completion
+{
+    std::function<bool()> isReady;
+    std::function<void()> invoke;
+};
+
+/// <summary>
+/// A resource in a store. The resource is stored as a future, so requests for
+/// a resource that is still being loaded wait for the same load.
+/// </summary>
+template<typename T>
+struct Entry
+{
+    Future<T> future;
+    bool      loaded   = false;  ///< Set when the resource was loaded successfully.
+    size_t    bytes    = 0;      ///< The size of the resource in memory.
+    double    loadTime = 0.0;    ///< The time it took to load the resource (in seconds).
+    uint64_t  hits     = 0;      ///< The number of requests that found the resource in the store.
+    uint64_t  lastUsed = 0;      ///< The tick of the last request for the resource.
+};
+
+template<typename Key, typename T>
+using Store = std::unordered_map<Key, Entry<T>>;
+
+// Guards the resource stores and the statistics.
+static std::mutex g_Mutex;
+
 // Image store.
-static std::unordered_map<std::filesystem::path, std::shared_ptr<Image>> g_ImageMap;
+static Store<std::filesystem::path, Image> g_ImageMap;
+
+// Font face store. The fonts of all sizes that are loaded from the same file share the font face.
+static Store<std::filesystem::path, FontFace> g_FontFaceMap;
 
 // Font store.
-static std::unordered_map<FontKey, std::shared_ptr<Font>> g_FontMap;
+static Store<FontKey, Font> g_FontMap;
 
-std::shared_ptr<Image> ResourceManager::loadImage( const std::filesystem::path& filePath )
+// The maximum size of the images in the image store (0 for no limit).
+static size_t g_MemoryBudget = 0;
+
+// The texture layout that loaded images are converted to.
+static std::atomic<TextureLayout> g_TextureLayout = TextureLayout::Linear;
+
+static uint64_t g_Tick      = 0;
+static uint64_t g_Hits      = 0;
+static uint64_t g_Misses    = 0;
+static uint64_t g_Evictions = 0;
+static size_t   g_Resident  = 0;  ///< The size of the loaded resources in all stores.
+
+// The completion callbacks that are invoked by ResourceManager::update.
+static std::mutex              g_CompletionMutex;
+static std::vector<Completion> g_Completions;
+
+// The loader is declared after the stores, so the loader threads are stopped before the stores are destroyed.
+static Loader g_Loader;
+
+// The size of a resource in memory.
+static size_t getResourceSize( const Image& image ) noexcept
+{
+    return static_cast<size_t>( image.getWidth() ) * image.getHeight() * sizeof( Color );
+}
+
+static size_t getResourceSize( const FontFace& face ) noexcept
+{
+    return face.getDataSize();
+}
+
+static size_t getResourceSize( const Font& ) noexcept
+{
+    // The font data is accounted to the font face.
+    return 0;
+}
+
+// Check if a resource was loaded. Image and font files that can't be read are loaded as empty resources.
+static bool isValid( const Image& image ) noexcept
+{
+    return static_cast<bool>( image );
+}
+
+static bool isValid( const FontFace& face ) noexcept
+{
+    return face.isValid();
+}
+
+static bool isValid( const Font& ) noexcept
+{
+    // The font face is checked when it is loaded.
+    return true;
+}
+
+// Evict the least recently used images that are not referenced outside of the image store,
+// until the size of the resources is within the memory budget.
+// The mutex must be locked.
+static void trimLocked()
+{
+    if ( g_MemoryBudget == 0 )
+        return;
+
+    while ( g_Resident > g_MemoryBudget )
+    {
+        auto lru = g_ImageMap.end();
+        for ( auto iter = g_ImageMap.begin(); iter != g_ImageMap.end(); ++iter )
+        {
+            const Entry<Image>& entry = iter->second;
+            if ( entry.loaded && entry.future.get().use_count() == 1 && ( lru == g_ImageMap.end() || entry.lastUsed < lru->second.lastUsed ) )
+                lru = iter;
+        }
+
+        // All of the images are in use.
+        if ( lru == g_ImageMap.end() )
+            break;
+
+        g_Resident -= lru->second.bytes;
+        ++g_Evictions;
+        g_ImageMap.erase( lru );
+    }
+}
+
+// Find a resource in a store. If the resource is not in the store, a promise for the resource is added to the store
+// and returned in promise. The caller must then load the resource with fulfill.
+template<typename Key, typename T>
+static Future<T> find( Store<Key, T>& store, const Key& key, std::shared_ptr<Promise<T>>& promise )
+{
+    std::scoped_lock lock( g_Mutex );
+
+    auto [iter, inserted] = store.try_emplace( key );
+    Entry<T>& entry       = iter->second;
+
+    if ( inserted )
+    {
+        promise      = std::make_shared<Promise<T>>();
+        entry.future = promise->get_future().share();
+        ++g_Misses;
+    }
+    else
+    {
+        ++entry.hits;
+        ++g_Hits;
+    }
+
+    entry.lastUsed = ++g_Tick;
+
+    return entry.future;
+}
+
+// Load a resource and fulfill its promise.
+// If loading throws, or returns nullptr or an empty resource, the resource is removed from the store so that
+// loading it can be retried.
+template<typename Key, typename T, typename Func>
+static void fulfill( Store<Key, T>& store, const Key& key, Promise<T>& promise, Func&& load )
 {
-    const auto iter = g_ImageMap.find( filePath );
+    try
+    {
+        Timer              timer;
+        std::shared_ptr<T> resource = load();
+        timer.tick();
+
+        const bool   valid = resource && isValid( *resource );
+        const size_t bytes = valid ? getResourceSize( *resource ) : 0;
+
+        promise.set_value( std::move( resource ) );
+
+        std::scoped_lock lock( g_Mutex );
+
+        // The store may have been cleared while the resource was loading.
+        if ( const auto iter = store.find( key ); iter != store.end() && !iter->second.loaded )
+        {
+            if ( !valid )
+            {
+                store.erase( iter );
+                return;
+            }
 
-    if ( iter == g_ImageMap.end() )
+            iter->second.loaded   = true;
+            iter->second.bytes    = bytes;
+            iter->second.loadTime = timer.elapsedSeconds();
+            g_Resident += bytes;
+
+            trimLocked();
+        }
+    }
+    catch ( ... )
     {
-        auto image = std::make_shared<Image>( filePath );
+        promise.set_exception( std::current_exception() );
+
+        std::scoped_lock lock( g_Mutex );
+        store.erase( key );
+    }
+}
+
+// Queue a callback that is invoked by ResourceManager::update when the resource is loaded.
+template<typename T>
+static void onCompletion( Future<T> future, ResourceManager::Callback<T> callback )
+{
+    if ( !callback )
+        return;
+
+    Completion completion {
+        [future] { return future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready; },
+        [future, callback = std::move( callback )] {
+            std::shared_ptr<T> resource;
+            try
+            {
+                resource = future.get();
+            }
+            catch ( ... )
+            {
+                // The callback receives nullptr if the resource failed to load.
+            }
+
+            callback( std::move( resource ) );
+        }
+    };
+
+    std::scoped_lock lock( g_CompletionMutex );
+    g_Completions.push_back( std::move( completion ) );
+}
 
-        g_ImageMap[filePath] = image;
+static std::shared_ptr<FontFace> loadFontFace( const std::filesystem::path& fontFile )
+{
+    std::shared_ptr<Promise<FontFace>> promise;
+    auto                               future = find( g_FontFaceMap, fontFile, promise );
+
+    if ( promise )
+        fulfill( g_FontFaceMap, fontFile, *promise, [&] { return std::make_shared<FontFace>( fontFile ); } );
+
+    return future.get();
+}
+
+// Load an image, in the texture layout of the loaded images.
+static std::shared_ptr<Image> loadImageFile( const std::filesystem::path& filePath )
+{
+    auto image = std::make_shared<Image>( filePath );
+    image->setTextureLayout( g_TextureLayout );
 
-        return image;
+    return image;
+}
+
+// Load an image on a loader thread. Asynchronous loads report an image that can't be loaded as nullptr.
+static std::shared_ptr<Image> loadImageOrNull( const std::filesystem::path& filePath )
+{
+    auto image = loadImageFile( filePath );
+    return *image ? image : nullptr;
+}
+
+std::shared_ptr<Image> ResourceManager::loadImage( const std::filesystem::path& filePath )
+{
+    std::shared_ptr<Promise<Image>> promise;
+    auto                            future = find( g_ImageMap, filePath, promise );
+
+    // Load the image on this thread, unless it is already loaded (or being loaded by another thread).
+    if ( promise )
+        fulfill( g_ImageMap, filePath, *promise, [&] { return loadImageFile( filePath ); } );
+
+    return future.get();
+}
+
+ResourceManager::Future<Image> ResourceManager::loadImageAsync( const std::filesystem::path& filePath, Callback<Image> onLoaded )
+{
+    std::shared_ptr<Promise<Image>> promise;
+    auto                            future = find( g_ImageMap, filePath, promise );
+
+    if ( promise )
+    {
+        g_Loader.enqueue( [filePath, promise] {
+            fulfill( g_ImageMap, filePath, *promise, [&] { return loadImageOrNull( filePath ); } );
+        } );
     }
 
-    return iter->second;
+    onCompletion( future, std::move( onLoaded ) );
+
+    return future;
 }
 
 std::shared_ptr<SpriteSheet> ResourceManager::loadSpriteSheet( const std::filesystem::path& filePath, std::optional<uint32_t> spriteWidth, std::optional<uint32_t> spriteHeight, uint32_t padding, uint32_t margin, const BlendMode& blendMode )
@@ -118,23 +473,146 @@ std::shared_ptr<SpriteSheet> ResourceManager::loadSpriteSheet( const std::filesy
 
 std::shared_ptr<Font> ResourceManager::loadFont( const std::filesystem::path& fontFile, float size, uint32_t firstChar, uint32_t numChars )
 {
-    FontKey    key { fontFile, size, firstChar, numChars };
-    const auto iter = g_FontMap.find( key );
+    FontKey                        key { fontFile, size };
+    std::shared_ptr<Promise<Font>> promise;
+    auto                           future = find( g_FontMap, key, promise );
 
-    if ( iter == g_FontMap.end() )
+    if ( promise )
     {
-        auto font = std::make_shared<Font>( fontFile, size, firstChar, numChars );
+        fulfill( g_FontMap, key, *promise, [&] {
+            // Font's constructor is private.
+            return std::shared_ptr<Font>( new Font( loadFontFace( fontFile ), size, firstChar, numChars ) );
+        } );
+    }
 
-        g_FontMap[key] = font;
+    return future.get();
+}
 
-        return font;
+ResourceManager::Future<Font> ResourceManager::loadFontAsync( const std::filesystem::path& fontFile, float size, uint32_t firstChar, uint32_t numChars, Callback<Font> onLoaded )
+{
+    FontKey                        key { fontFile, size };
+    std::shared_ptr<Promise<Font>> promise;
+    auto                           future = find( g_FontMap, key, promise );
+
+    if ( promise )
+    {
+        g_Loader.enqueue( [key, promise, firstChar, numChars] {
+            fulfill( g_FontMap, key, *promise, [&] {
+                auto face = loadFontFace( key.fontFile );
+                return face->isValid() ? std::shared_ptr<Font>( new Font( std::move( face ), key.size, firstChar, numChars ) ) : nullptr;
+            } );
+        } );
     }
 
-    return iter->second;
+    onCompletion( future, std::move( onLoaded ) );
+
+    return future;
+}
+
+void ResourceManager::setMemoryBudget( size_t bytes )
+{
+    std::scoped_lock lock( g_Mutex );
+
+    g_MemoryBudget = bytes;
+    trimLocked();
+}
+
+size_t ResourceManager::getMemoryBudget()
+{
+    std::scoped_lock lock( g_Mutex );
+    return g_MemoryBudget;
+}
+
+void ResourceManager::setTextureLayout( TextureLayout layout )
+{
+    g_TextureLayout = layout;
+}
+
+TextureLayout ResourceManager::getTextureLayout()
+{
+    return g_TextureLayout;
+}
+
+void ResourceManager::trim()
+{
+    std::scoped_lock lock( g_Mutex );
+    trimLocked();
+}
+
+ResourceManager::Statistics ResourceManager::getStatistics()
+{
+    std::scoped_lock lock( g_Mutex );
+
+    Statistics stats;
+    stats.hits          = g_Hits;
+    stats.misses        = g_Misses;
+    stats.evictions     = g_Evictions;
+    stats.residentBytes = g_Resident;
+    stats.memoryBudget  = g_MemoryBudget;
+    stats.numImages     = g_ImageMap.size();
+    stats.numFonts      = g_FontMap.size();
+
+    return stats;
+}
+
+std::vector<ResourceManager::AssetStatistics> ResourceManager::getAssetStatistics()
+{
+    std::scoped_lock lock( g_Mutex );
+
+    std::vector<AssetStatistics> assets;
+    assets.reserve( g_ImageMap.size() + g_FontFaceMap.size() );
+
+    for ( const auto& [filePath, entry]: g_ImageMap )
+    {
+        if ( entry.loaded )
+            assets.push_back( { filePath, entry.bytes, entry.hits, entry.loadTime } );
+    }
+
+    for ( const auto& [fontFile, entry]: g_FontFaceMap )
+    {
+        if ( entry.loaded )
+            assets.push_back( { fontFile, entry.bytes, entry.hits, entry.loadTime } );
+    }
+
+    return assets;
+}
+
+void ResourceManager::update()
+{
+    std::vector<Completion> completed;
+
+    {
+        std::scoped_lock lock( g_CompletionMutex );
+
+        const auto iter = std::stable_partition( g_Completions.begin(), g_Completions.end(), []( const Completion& c ) { return !c.isReady(); } );
+        std::move( iter, g_Completions.end(), std::back_inserter( completed ) );
+        g_Completions.erase( iter, g_Completions.end() );
+    }
+
+    // The callbacks are invoked without holding the lock, so they can load more resources.
+    for ( auto& completion: completed )
+        completion.invoke();
+
+    // Images that were released since the last update can be evicted now.
+    trim();
+}
+
+void ResourceManager::waitIdle()
+{
+    g_Loader.waitIdle();
+}
+
+size_t ResourceManager::getPendingCount()
+{
+    return g_Loader.getPendingCount();
 }
 
 void ResourceManager::clear()
 {
+    std::scoped_lock lock( g_Mutex );
+
     g_ImageMap.clear();
     g_FontMap.clear();
+    g_FontFaceMap.clear();
+    g_Resident = 0;
 }
@@ -0,0 +1,275 @@
+#include <Graphics/Image.hpp>
+#include <Graphics/Sprite.hpp>
+#include <Graphics/SpriteBatch.hpp>
+#include <Graphics/StaticBlendMode.hpp>
+#include <Graphics/ThreadPool.hpp>
+
+#include "TextureSampler.hpp"
+
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+
+using namespace Graphics;
+using namespace Math;
+
+// Tolerance for the edges of the sprite, so that pixels exactly on the edge are not rejected due to rounding errors.
+constexpr float EdgeEpsilon = 1e-3f;
+
+SpriteBatch::SpriteBatch( SpriteSortMode sortMode, uint32_t tileSize )
+: m_SortMode { sortMode }
+, m_TileSize { std::max( tileSize, 1u ) }
+{}
+
+void SpriteBatch::clear() noexcept
+{
+    m_Images.clear();
+    m_Rects.clear();
+    m_InvMatrices.clear();
+    m_Bounds.clear();
+    m_Colors.clear();
+    m_BlendModes.clear();
+    m_FilterModes.clear();
+}
+
+void SpriteBatch::reserve( size_t numSprites )
+{
+    m_Images.reserve( numSprites );
+    m_Rects.reserve( numSprites );
+    m_InvMatrices.reserve( numSprites );
+    m_Bounds.reserve( numSprites );
+    m_Colors.reserve( numSprites );
+    m_BlendModes.reserve( numSprites );
+    m_FilterModes.reserve( numSprites );
+}
+
+// Move trimmed sprites to their position in the untrimmed frame.
+static glm::mat3 offsetMatrix( const Sprite& sprite, glm::mat3 matrix ) noexcept
+{
+    const glm::ivec2 offset = sprite.getOffset();
+    matrix[2] += matrix[0] * static_cast<float>( offset.x ) + matrix[1] * static_cast<float>( offset.y );
+
+    return matrix;
+}
+
+void SpriteBatch::draw( const Sprite& sprite, const glm::mat3& matrix )
+{
+    add( sprite.getImage().get(), sprite.getRect(), offsetMatrix( sprite, matrix ), sprite.getColor(), sprite.getBlendMode(), sprite.getFilterMode() );
+}
+
+void SpriteBatch::draw( const Sprite& sprite, const glm::mat3& matrix, const Color& color )
+{
+    add( sprite.getImage().get(), sprite.getRect(), offsetMatrix( sprite, matrix ), color, sprite.getBlendMode(), sprite.getFilterMode() );
+}
+
+void SpriteBatch::add( const Image* image, const RectI& rect, const glm::mat3& matrix, const Color& color, const BlendMode& blendMode, FilterMode filterMode )
+{
+    if ( !image || rect.width <= 0 || rect.height <= 0 )
+        return;
+
+    // Sprites are transformed as 2D points (the projective row of the matrix is ignored).
+    glm::mat3 affine = matrix;
+    affine[0][2]     = 0.0f;
+    affine[1][2]     = 0.0f;
+    affine[2][2]     = 1.0f;
+
+    // Sprites that are scaled to zero don't cover any pixels.
+    if ( std::abs( glm::determinant( affine ) ) < 1e-8f )
+        return;
+
+    const glm::vec2 size { rect.width - 1, rect.height - 1 };
+
+    m_Images.push_back( image );
+    m_Rects.push_back( rect );
+    m_InvMatrices.push_back( glm::inverse( affine ) );
+    m_Bounds.emplace_back(
+        glm::vec3 { glm::vec2 { affine * glm::vec3 { 0, 0, 1 } }, 0.0f },
+        glm::vec3 { glm::vec2 { affine * glm::vec3 { size.x, 0, 1 } }, 0.0f },
+        glm::vec3 { glm::vec2 { affine * glm::vec3 { size.x, size.y, 1 } }, 0.0f },
+        glm::vec3 { glm::vec2 { affine * glm::vec3 { 0, size.y, 1 } }, 0.0f } );
+    m_Colors.push_back( color );
+    m_BlendModes.push_back( blendMode );
+    m_FilterModes.push_back( filterMode );
+}
+
+void SpriteBatch::render( Image& image )
+{
+    if ( empty() || !image )
+        return;
+
+    // Commands that were recorded before the batch are drawn below it.
+    image.flush();
+
+    const int  width  = static_cast<int>( image.getWidth() );
+    const int  height = static_cast<int>( image.getHeight() );
+    const AABB screen { { 0, 0, 0 }, { width - 1, height - 1, 0 } };
+
+    // Cull the sprites that are not on screen.
+    m_Order.clear();
+    for ( uint32_t i = 0; i < static_cast<uint32_t>( m_Bounds.size() ); ++i )
+    {
+        if ( screen.intersect( m_Bounds[i] ) )
+            m_Order.push_back( i );
+    }
+
+    if ( image.isDirtyTracking() )
+    {
+        for ( uint32_t i: m_Order )
+        {
+            const AABB& bounds = m_Bounds[i];
+            const int   left   = static_cast<int>( std::floor( bounds.min.x ) );
+            const int   top    = static_cast<int>( std::floor( bounds.min.y ) );
+            const int   right  = static_cast<int>( std::ceil( bounds.max.x ) ) + 1;
+            const int   bottom = static_cast<int>( std::ceil( bounds.max.y ) ) + 1;
+
+            image.markDirty( { left, top, right - left, bottom - top } );
+        }
+    }
+
+    if ( m_Order.empty() )
+        return;
+
+    if ( m_SortMode == SpriteSortMode::Image )
+        std::ranges::stable_sort( m_Order, std::less {}, [this]( uint32_t i ) { return m_Images[i]; } );
+
+    const int tileSize = static_cast<int>( m_TileSize );
+    const int tilesX   = ( width + tileSize - 1 ) / tileSize;
+    const int tilesY   = ( height + tileSize - 1 ) / tileSize;
+    const int numTiles = tilesX * tilesY;
+
+    // Invoke a function for each tile that is overlapped by a sprite.
+    auto forEachTile = [&]( uint32_t i, auto&& func ) {
+        const AABB& bounds = m_Bounds[i];
+        const int   x0     = std::clamp( static_cast<int>( std::floor( bounds.min.x ) ), 0, width - 1 ) / tileSize;
+        const int   y0     = std::clamp( static_cast<int>( std::floor( bounds.min.y ) ), 0, height - 1 ) / tileSize;
+        const int   x1     = std::clamp( static_cast<int>( std::ceil( bounds.max.x ) ), 0, width - 1 ) / tileSize;
+        const int   y1     = std::clamp( static_cast<int>( std::ceil( bounds.max.y ) ), 0, height - 1 ) / tileSize;
+
+        for ( int ty = y0; ty <= y1; ++ty )
+        {
+            for ( int tx = x0; tx <= x1; ++tx )
+                func( ty * tilesX + tx );
+        }
+    };
+
+    // Bin the sprites into the tiles with a counting sort, so that each tile has a contiguous list of sprites.
+    m_TileOffsets.assign( static_cast<size_t>( numTiles ) + 1, 0u );
+    for ( uint32_t i: m_Order )
+        forEachTile( i, [&]( int tile ) { ++m_TileOffsets[tile + 1]; } );
+
+    for ( int tile = 0; tile < numTiles; ++tile )
+        m_TileOffsets[tile + 1] += m_TileOffsets[tile];
+
+    m_TileSprites.resize( m_TileOffsets[numTiles] );
+    for ( uint32_t i: m_Order )
+        forEachTile( i, [&]( int tile ) { m_TileSprites[m_TileOffsets[tile]++] = i; } );
+
+    // Filling the bins moved the offset of each tile to the offset of the next tile.
+    std::shift_right( m_TileOffsets.begin(), m_TileOffsets.end(), 1 );
+    m_TileOffsets[0] = 0u;
+
+    const int64_t tileCost = static_cast<int64_t>( tileSize ) * tileSize;
+
+    ThreadPool::get().parallelFor(
+        0, numTiles, [&]( int first, int last ) {
+            for ( int tile = first; tile < last; ++tile )
+            {
+                const int  tx = tile % tilesX * tileSize;
+                const int  ty = tile / tilesX * tileSize;
+                const AABB clip { { tx, ty, 0 }, { std::min( tx + tileSize, width ) - 1, std::min( ty + tileSize, height ) - 1, 0 } };
+
+                for ( uint32_t j = m_TileOffsets[tile]; j < m_TileOffsets[tile + 1]; ++j )
+                    rasterize( image, m_TileSprites[j], clip );
+            }
+        },
+        tileCost );
+}
+
+void SpriteBatch::rasterize( Image& image, uint32_t sprite, const AABB& clip ) const noexcept
+{
+    const AABB&      bounds = m_Bounds[sprite];
+    const glm::mat3& inv    = m_InvMatrices[sprite];
+    const RectI&     rect   = m_Rects[sprite];
+    const Color      color  = m_Colors[sprite];
+
+    const int yBegin = std::max( static_cast<int>( std::floor( bounds.min.y ) ), static_cast<int>( clip.min.y ) );
+    const int yEnd   = std::min( static_cast<int>( std::ceil( bounds.max.y ) ), static_cast<int>( clip.max.y ) );
+
+    // The size of the sprite (in sprite space) and the change in sprite coordinates per pixel step in x.
+    const glm::vec2 size { rect.width - 1, rect.height - 1 };
+    const glm::vec2 dx { inv[0][0], inv[0][1] };
+
+    const Image& srcImage = *m_Images[sprite];
+    const bool   tiled    = srcImage.getTextureLayout() == TextureLayout::Tiled;
+    const Color* src      = tiled ? nullptr : srcImage.data() + static_cast<size_t>( rect.top ) * srcImage.getWidth() + rect.left;
+    const size_t stride   = srcImage.getWidth();
+
+    // The filtered sampler uses image coordinates (the point sampler uses sprite coordinates).
+    std::optional<TextureSampler> sampler;
+    if ( m_FilterModes[sprite] != FilterMode::Point )
+        sampler.emplace( srcImage, m_FilterModes[sprite], AddressMode::Clamp, TextureSampler::computeLOD( dx, { inv[1][0], inv[1][1] } ), &rect );
+
+    const glm::vec2 rectOrigin { rect.left, rect.top };
+
+    // Specialize the inner loop for the blend mode.
+    dispatchBlendMode( m_BlendModes[sprite], [&]( const auto blend ) {
+        for ( int y = yBegin; y <= yEnd; ++y )
+        {
+            // The sprite coordinates at x = 0.
+            const glm::vec2 origin { inv[1][0] * static_cast<float>( y ) + inv[2][0], inv[1][1] * static_cast<float>( y ) + inv[2][1] };
+
+            // Solve for the span of pixels in this row that map inside the sprite.
+            float xMin  = clip.min.x;
+            float xMax  = clip.max.x;
+            bool  empty = false;
+
+            for ( int c = 0; c < 2; ++c )
+            {
+                if ( std::abs( dx[c] ) < 1e-8f )
+                {
+                    empty = empty || origin[c] < -EdgeEpsilon || origin[c] > size[c] + EdgeEpsilon;
+                }
+                else
+                {
+                    const float t0 = ( -EdgeEpsilon - origin[c] ) / dx[c];
+                    const float t1 = ( size[c] + EdgeEpsilon - origin[c] ) / dx[c];
+                    xMin           = std::max( xMin, std::min( t0, t1 ) );
+                    xMax           = std::min( xMax, std::max( t0, t1 ) );
+                }
+            }
+
+            if ( empty )
+                continue;
+
+            const int x0 = static_cast<int>( std::ceil( xMin ) );
+            const int x1 = static_cast<int>( std::floor( xMax ) );
+
+            if ( sampler )
+            {
+                for ( int x = x0; x <= x1; ++x )
+                    image.plot<false>( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ), ( *sampler )( rectOrigin + origin + dx * static_cast<float>( x ) ) * color, blend );
+
+                continue;
+            }
+
+            auto drawSpan = [&]( auto&& fetch ) {
+                for ( int x = x0; x <= x1; ++x )
+                {
+                    const glm::vec2 uv = origin + dx * static_cast<float>( x );
+                    const int       u  = std::clamp( static_cast<int>( uv.x + 0.5f ), 0, rect.width - 1 );
+                    const int       v  = std::clamp( static_cast<int>( uv.y + 0.5f ), 0, rect.height - 1 );
+
+                    image.plot<false>( static_cast<uint32_t>( x ), static_cast<uint32_t>( y ), fetch( u, v ) * color, blend );
+                }
+            };
+
+            if ( tiled )
+                drawSpan( [&]( int u, int v ) { return srcImage.texel( static_cast<uint32_t>( rect.left + u ), static_cast<uint32_t>( rect.top + v ) ); } );
+            else
+                drawSpan( [&]( int u, int v ) { return src[v * stride + u]; } );
+        }
+    } );
+}
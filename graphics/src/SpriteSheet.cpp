@@ -1,5 +1,9 @@
 #include <Graphics/ResourceManager.hpp>
 #include <Graphics/SpriteSheet.hpp>
+#include <Graphics/SpriteSheetFile.hpp>
+
+#include <algorithm>
+#include <iostream>
 
 using namespace Graphics;
 
@@ -91,9 +95,10 @@ SpriteSheet::SpriteSheet( const SpriteSheet& copy )
 , rows { copy.rows }
 , padding { copy.padding }
 , margin { copy.margin }
-{
-    initSprites();
-}
+, sprites { copy.sprites }
+, spriteNames { copy.spriteNames }
+, animations { copy.animations }
+{}
 
 SpriteSheet::SpriteSheet( SpriteSheet&& other ) noexcept
 : image { std::move( other.image ) }
@@ -103,9 +108,10 @@ SpriteSheet::SpriteSheet( SpriteSheet&& other ) noexcept
 , rows { other.rows }
 , padding { other.padding }
 , margin { other.margin }
+, sprites { std::move( other.sprites ) }
+, spriteNames { std::move( other.spriteNames ) }
+, animations { std::move( other.animations ) }
 {
-    initSprites();
-
     other.rows    = 0u;
     other.columns = 0u;
     other.sprites.clear();
@@ -123,8 +129,9 @@ SpriteSheet& SpriteSheet::operator=( const SpriteSheet& copy )
     rows        = copy.rows;
     padding     = copy.padding;
     margin      = copy.margin;
-
-    initSprites();
+    sprites     = copy.sprites;
+    spriteNames = copy.spriteNames;
+    animations  = copy.animations;
 
     return *this;
 }
@@ -141,8 +148,9 @@ SpriteSheet& SpriteSheet::operator=( SpriteSheet&& other ) noexcept
     rows        = other.rows;
     padding     = other.padding;
     margin      = other.margin;
-
-    initSprites();
+    sprites     = std::move( other.sprites );
+    spriteNames = std::move( other.spriteNames );
+    animations  = std::move( other.animations );
 
     other.columns = 0u;
     other.rows    = 0u;
@@ -188,6 +196,86 @@ std::shared_ptr<SpriteSheet> SpriteSheet::fromGrid( const std::filesystem::path&
     return std::make_shared<SpriteSheet>( image, w, h, padding, margin, blendMode );
 }
 
+std::shared_ptr<SpriteSheet> SpriteSheet::fromPacked( const std::filesystem::path& indexFile, const BlendMode& blendMode )
+{
+    SpriteSheetFile::Index index;
+    if ( !SpriteSheetFile::read( indexFile, index ) )
+        return nullptr;
+
+    // The pages are texture files, so loading them only maps the files into memory.
+    std::vector<std::shared_ptr<Image>> pages;
+    pages.reserve( index.pages.size() );
+
+    for ( const auto& page: index.pages )
+    {
+        auto image = ResourceManager::loadImage( indexFile.parent_path() / page );
+        if ( !image )
+            return nullptr;
+
+        pages.push_back( std::move( image ) );
+    }
+
+    // The index may be out of date (or corrupt), and drawing a sprite doesn't check that its rect is inside its image.
+    for ( const auto& s: index.sprites )
+    {
+        const Image&  page   = *pages[s.page];
+        const int64_t right  = int64_t { s.rect.left } + s.rect.width;
+        const int64_t bottom = int64_t { s.rect.top } + s.rect.height;
+
+        if ( s.rect.left < 0 || s.rect.top < 0 || s.rect.width < 0 || s.rect.height < 0 || right > page.getWidth() || bottom > page.getHeight() )
+        {
+            std::cerr << "ERROR: Invalid sprite sheet file: " << indexFile.string() << std::endl;
+            return nullptr;
+        }
+    }
+
+    auto spriteSheet = std::make_shared<SpriteSheet>();
+
+    spriteSheet->image     = pages.empty() ? nullptr : pages.front();
+    spriteSheet->blendMode = blendMode;
+    spriteSheet->columns   = static_cast<uint32_t>( index.sprites.size() );
+    spriteSheet->rows      = 1u;
+
+    spriteSheet->spriteRects.reserve( index.sprites.size() );
+    spriteSheet->sprites.reserve( index.sprites.size() );
+    spriteSheet->spriteNames.reserve( index.sprites.size() );
+
+    for ( auto& s: index.sprites )
+    {
+        Sprite& sprite = spriteSheet->sprites.emplace_back( pages[s.page], s.rect, blendMode );
+        sprite.setOffset( s.offset );
+        sprite.setPivot( s.pivot );
+
+        spriteSheet->spriteRects.push_back( s.rect );
+        spriteSheet->spriteNames.push_back( std::move( s.name ) );
+    }
+
+    spriteSheet->animations.reserve( index.animations.size() );
+
+    for ( auto& animation: index.animations )
+        spriteSheet->animations.push_back( { std::move( animation.name ), std::move( animation.frames ) } );
+
+    return spriteSheet;
+}
+
+int SpriteSheet::findSprite( std::string_view name ) const noexcept
+{
+    const auto iter = std::ranges::find( spriteNames, name );
+    if ( iter == spriteNames.end() )
+        return -1;
+
+    return static_cast<int>( iter - spriteNames.begin() );
+}
+
+std::span<const int> SpriteSheet::getAnimation( std::string_view name ) const noexcept
+{
+    const auto iter = std::ranges::find( animations, name, &Animation::name );
+    if ( iter == animations.end() )
+        return {};
+
+    return iter->frames;
+}
+
 void SpriteSheet::initSpriteRects()
 {
     spriteRects.clear();
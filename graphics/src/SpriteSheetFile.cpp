@@ -0,0 +1,245 @@
+#include <Graphics/File.hpp>
+#include <Graphics/SpriteSheetFile.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace Graphics;
+
+/// <summary>
+/// The header at the start of an index file.
+/// </summary>
+struct SpriteSheetFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numPages;
+    uint32_t numSprites;
+    uint32_t numAnimations;
+    uint32_t numFrames;    ///< The total number of frames of all animations.
+    uint32_t stringsSize;  ///< The size (in bytes) of the string table.
+    uint32_t reserved;
+};
+
+struct SpriteRecord
+{
+    uint32_t nameOffset;
+    uint32_t page;
+    int32_t  rect[4];
+    int32_t  offset[2];
+    int32_t  sourceSize[2];
+    float    pivot[2];
+};
+
+struct AnimationRecord
+{
+    uint32_t nameOffset;
+    uint32_t firstFrame;
+    uint32_t numFrames;
+    uint32_t reserved;
+};
+
+static_assert( sizeof( SpriteSheetFileHeader ) == 32 );
+static_assert( sizeof( SpriteRecord ) == 48 );
+static_assert( sizeof( AnimationRecord ) == 16 );
+
+// "SRSS"
+constexpr uint32_t SpriteSheetFileMagic = 'S' | 'R' << 8 | 'S' << 16 | 'S' << 24;
+
+/// <summary>
+/// Builds the string table of an index file. Identical strings are only stored once.
+/// </summary>
+class StringTable
+{
+public:
+    uint32_t add( const std::string& str )
+    {
+        if ( const auto iter = m_Offsets.find( str ); iter != m_Offsets.end() )
+            return iter->second;
+
+        const auto offset = static_cast<uint32_t>( m_Data.size() );
+        m_Data.insert( m_Data.end(), str.begin(), str.end() );
+        m_Data.push_back( '\0' );
+        m_Offsets.emplace( str, offset );
+
+        return offset;
+    }
+
+    const std::vector<char>& data() const noexcept
+    {
+        return m_Data;
+    }
+
+private:
+    std::vector<char>                         m_Data;
+    std::unordered_map<std::string, uint32_t> m_Offsets;
+};
+
+bool SpriteSheetFile::write( const std::filesystem::path& file, const Index& index )
+{
+    StringTable strings;
+
+    std::vector<uint32_t> pages;
+    pages.reserve( index.pages.size() );
+
+    for ( const auto& page: index.pages )
+        pages.push_back( strings.add( page.generic_string() ) );
+
+    std::vector<SpriteRecord> sprites;
+    sprites.reserve( index.sprites.size() );
+
+    for ( const Sprite& sprite: index.sprites )
+    {
+        sprites.push_back( {
+            strings.add( sprite.name ),
+            sprite.page,
+            { sprite.rect.left, sprite.rect.top, sprite.rect.width, sprite.rect.height },
+            { sprite.offset.x, sprite.offset.y },
+            { sprite.sourceSize.x, sprite.sourceSize.y },
+            { sprite.pivot.x, sprite.pivot.y },
+        } );
+    }
+
+    std::vector<AnimationRecord> animations;
+    std::vector<int32_t>         frames;
+    animations.reserve( index.animations.size() );
+
+    for ( const Animation& animation: index.animations )
+    {
+        animations.push_back( { strings.add( animation.name ), static_cast<uint32_t>( frames.size() ), static_cast<uint32_t>( animation.frames.size() ), 0u } );
+        frames.insert( frames.end(), animation.frames.begin(), animation.frames.end() );
+    }
+
+    SpriteSheetFileHeader header {};
+    header.magic         = SpriteSheetFileMagic;
+    header.version       = Version;
+    header.numPages      = static_cast<uint32_t>( pages.size() );
+    header.numSprites    = static_cast<uint32_t>( sprites.size() );
+    header.numAnimations = static_cast<uint32_t>( animations.size() );
+    header.numFrames     = static_cast<uint32_t>( frames.size() );
+    header.stringsSize   = static_cast<uint32_t>( strings.data().size() );
+
+    std::ofstream out( file, std::ios::binary | std::ios::trunc );
+    if ( !out )
+    {
+        std::cerr << "ERROR: Could not write: " << file.string() << std::endl;
+        return false;
+    }
+
+    auto writeArray = [&out]<typename T>( const std::vector<T>& v ) {
+        out.write( reinterpret_cast<const char*>( v.data() ), static_cast<std::streamsize>( v.size() * sizeof( T ) ) );
+    };
+
+    out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    writeArray( pages );
+    writeArray( sprites );
+    writeArray( animations );
+    writeArray( frames );
+    writeArray( strings.data() );
+
+    return out.good();
+}
+
+bool SpriteSheetFile::read( const std::filesystem::path& file, Index& index )
+{
+    std::vector<std::byte> data;
+
+    try
+    {
+        data = File::readFile<std::byte>( file, std::ios::binary );
+    }
+    catch ( const std::exception& )
+    {
+        std::cerr << "ERROR: Could not load: " << file.string() << std::endl;
+        return false;
+    }
+
+    SpriteSheetFileHeader header {};
+    if ( data.size() >= sizeof( header ) )
+        std::memcpy( &header, data.data(), sizeof( header ) );
+
+    const uint64_t pagesOffset      = sizeof( header );
+    const uint64_t spritesOffset    = pagesOffset + uint64_t { header.numPages } * sizeof( uint32_t );
+    const uint64_t animationsOffset = spritesOffset + uint64_t { header.numSprites } * sizeof( SpriteRecord );
+    const uint64_t framesOffset     = animationsOffset + uint64_t { header.numAnimations } * sizeof( AnimationRecord );
+    const uint64_t stringsOffset    = framesOffset + uint64_t { header.numFrames } * sizeof( int32_t );
+
+    // The string table must be null-terminated, so names can't run past the end of the file.
+    const bool valid = header.magic == SpriteSheetFileMagic && header.version == Version && stringsOffset + header.stringsSize == data.size() &&
+                       ( header.stringsSize == 0 || data.back() == std::byte { 0 } );
+
+    auto invalid = [&file] {
+        std::cerr << "ERROR: Invalid sprite sheet file: " << file.string() << std::endl;
+        return false;
+    };
+
+    if ( !valid )
+        return invalid();
+
+    const char* strings = reinterpret_cast<const char*>( data.data() + stringsOffset );
+
+    auto getString = [&]( uint32_t offset, std::string& str ) {
+        if ( offset >= header.stringsSize )
+            return false;
+
+        str = strings + offset;
+        return true;
+    };
+
+    index.pages.resize( header.numPages );
+    index.sprites.resize( header.numSprites );
+    index.animations.resize( header.numAnimations );
+
+    for ( uint32_t i = 0; i < header.numPages; ++i )
+    {
+        uint32_t    nameOffset;
+        std::string name;
+        std::memcpy( &nameOffset, data.data() + pagesOffset + i * sizeof( uint32_t ), sizeof( nameOffset ) );
+
+        if ( !getString( nameOffset, name ) )
+            return invalid();
+
+        index.pages[i] = name;
+    }
+
+    for ( uint32_t i = 0; i < header.numSprites; ++i )
+    {
+        SpriteRecord r;
+        std::memcpy( &r, data.data() + spritesOffset + i * sizeof( SpriteRecord ), sizeof( r ) );
+
+        Sprite& sprite = index.sprites[i];
+        if ( !getString( r.nameOffset, sprite.name ) || r.page >= header.numPages )
+            return invalid();
+
+        sprite.page       = r.page;
+        sprite.rect       = { r.rect[0], r.rect[1], r.rect[2], r.rect[3] };
+        sprite.offset     = { r.offset[0], r.offset[1] };
+        sprite.sourceSize = { r.sourceSize[0], r.sourceSize[1] };
+        sprite.pivot      = { r.pivot[0], r.pivot[1] };
+    }
+
+    for ( uint32_t i = 0; i < header.numAnimations; ++i )
+    {
+        AnimationRecord r;
+        std::memcpy( &r, data.data() + animationsOffset + i * sizeof( AnimationRecord ), sizeof( r ) );
+
+        Animation& animation = index.animations[i];
+        if ( !getString( r.nameOffset, animation.name ) || uint64_t { r.firstFrame } + r.numFrames > header.numFrames )
+            return invalid();
+
+        animation.frames.resize( r.numFrames );
+        std::memcpy( animation.frames.data(), data.data() + framesOffset + uint64_t { r.firstFrame } * sizeof( int32_t ), r.numFrames * sizeof( int32_t ) );
+
+        for ( const int frame: animation.frames )
+        {
+            if ( frame < 0 || static_cast<uint32_t>( frame ) >= header.numSprites )
+                return invalid();
+        }
+    }
+
+    return true;
+}
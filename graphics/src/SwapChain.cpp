@@ -0,0 +1,143 @@
+#include <Graphics/SwapChain.hpp>
+#include <Graphics/Timer.hpp>
+#include <Graphics/Window.hpp>
+
+#include <algorithm>
+#include <utility>
+
+using namespace Graphics;
+
+SwapChain::SwapChain( Window& window, uint32_t width, uint32_t height, uint32_t numBuffers )
+: m_Window { window }
+, m_VSync { window.isVSync() }
+{
+    numBuffers = std::clamp( numBuffers, 2u, MaxBuffers );
+
+    m_Buffers.reserve( numBuffers );
+    for ( uint32_t i = 0; i < numBuffers; ++i )
+        m_Buffers.emplace_back( width, height );
+
+    m_BufferFences.assign( numBuffers, 0u );
+    m_MaxFrameLatency = numBuffers - 1u;
+
+    // The window is presented from the present thread from now on.
+    m_Window.releaseContext();
+    m_Thread = std::thread( &SwapChain::presentThread, this );
+}
+
+SwapChain::~SwapChain()
+{
+    {
+        std::scoped_lock lock( m_Mutex );
+        m_Stop = true;
+    }
+    m_QueueCV.notify_one();
+    m_Thread.join();
+}
+
+Image& SwapChain::getBackBuffer()
+{
+    wait( m_BufferFences[m_BackBuffer] );
+
+    return m_Buffers[m_BackBuffer];
+}
+
+uint64_t SwapChain::present()
+{
+    Image& image = getBackBuffer();
+
+    // Recorded commands are drawn on this thread, so the present thread only reads finished images.
+    if ( image.isDeferred() )
+        image.flush();
+
+    // Bound the number of queued frames.
+    if ( m_SubmittedFence >= m_MaxFrameLatency )
+        wait( m_SubmittedFence - m_MaxFrameLatency + 1u );
+
+    const uint64_t fence = ++m_SubmittedFence;
+    {
+        std::scoped_lock lock( m_Mutex );
+        m_BufferFences[m_BackBuffer] = fence;
+        m_Queue.push( m_BackBuffer );
+    }
+    m_QueueCV.notify_one();
+
+    m_BackBuffer = ( m_BackBuffer + 1u ) % getNumBuffers();
+
+    return fence;
+}
+
+void SwapChain::wait( uint64_t fence )
+{
+    if ( getCompletedFence() >= fence )
+        return;
+
+    std::unique_lock lock( m_Mutex );
+    m_CompletedCV.wait( lock, [this, fence] { return getCompletedFence() >= fence; } );
+}
+
+void SwapChain::waitIdle()
+{
+    wait( m_SubmittedFence );
+}
+
+void SwapChain::setMaxFrameLatency( uint32_t maxFrameLatency ) noexcept
+{
+    m_MaxFrameLatency = std::clamp( maxFrameLatency, 1u, getNumBuffers() - 1u );
+}
+
+void SwapChain::setVSync( bool enabled ) noexcept
+{
+    std::scoped_lock lock( m_Mutex );
+    m_VSync.store( enabled, std::memory_order_relaxed );
+    m_VSyncChanged = true;
+}
+
+void SwapChain::resize( uint32_t width, uint32_t height )
+{
+    waitIdle();
+
+    for ( Image& buffer: m_Buffers )
+        buffer.resize( width, height );
+}
+
+void SwapChain::presentThread()
+{
+    Timer timer;
+
+    std::unique_lock lock( m_Mutex );
+
+    while ( true )
+    {
+        m_QueueCV.wait( lock, [this] { return m_Stop || !m_Queue.empty(); } );
+
+        // Frames that are still queued when the swap chain is destroyed are presented first.
+        if ( m_Queue.empty() )
+            break;
+
+        const uint32_t buffer = m_Queue.front();
+        m_Queue.pop();
+
+        const bool vSyncChanged = std::exchange( m_VSyncChanged, false );
+        const bool vSync        = m_VSync.load( std::memory_order_relaxed );
+
+        lock.unlock();
+
+        timer.tick();
+
+        if ( vSyncChanged )
+            m_Window.setVSync( vSync );
+
+        m_Window.present( m_Buffers[buffer] );
+
+        timer.tick();
+        m_PresentTime.store( timer.elapsedSeconds(), std::memory_order_relaxed );
+
+        lock.lock();
+        m_CompletedFence.fetch_add( 1u, std::memory_order_release );
+        m_CompletedCV.notify_all();
+    }
+
+    // Allow the window to be used on other threads again.
+    m_Window.releaseContext();
+}
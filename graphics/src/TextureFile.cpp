@@ -0,0 +1,209 @@
+#include <Graphics/TextureFile.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#if defined( _WIN32 )
+    #include "Win32/IncludeWin32.hpp"
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace Graphics;
+
+/// <summary>
+/// The header at the start of a texture file.
+/// </summary>
+struct TextureFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t pixelOffset;  ///< The offset of the pixels from the start of the file.
+    uint64_t rectOffset;   ///< The offset of the rect table from the start of the file.
+    uint32_t numRects;
+    uint32_t reserved[7];
+};
+
+static_assert( sizeof( TextureFileHeader ) == 64, "The pixels must start on a 64-byte boundary." );
+
+// "SRTX"
+constexpr uint32_t TextureFileMagic = 'S' | 'R' << 8 | 'T' << 16 | 'X' << 24;
+
+/// <summary>
+/// A file that is mapped into memory with copy-on-write pages.
+/// Writing to the mapped memory doesn't modify the file.
+/// </summary>
+struct FileMapping
+{
+    std::byte* data = nullptr;
+    size_t     size = 0;
+
+    FileMapping( std::byte* data, size_t size )
+    : data { data }
+    , size { size }
+    {}
+
+    ~FileMapping()
+    {
+#if defined( _WIN32 )
+        ::UnmapViewOfFile( data );
+#else
+        ::munmap( data, size );
+#endif
+    }
+
+    FileMapping( const FileMapping& )            = delete;
+    FileMapping( FileMapping&& )                 = delete;
+    FileMapping& operator=( const FileMapping& ) = delete;
+    FileMapping& operator=( FileMapping&& )      = delete;
+};
+
+static std::shared_ptr<FileMapping> mapFile( const std::filesystem::path& file )
+{
+#if defined( _WIN32 )
+    HANDLE hFile = ::CreateFileW( file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( hFile == INVALID_HANDLE_VALUE )
+        return nullptr;
+
+    LARGE_INTEGER fileSize {};
+    if ( !::GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart == 0 )
+    {
+        ::CloseHandle( hFile );
+        return nullptr;
+    }
+
+    // The view keeps the file mapping (and the file) open.
+    HANDLE hMapping = ::CreateFileMappingW( hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+    ::CloseHandle( hFile );
+
+    if ( !hMapping )
+        return nullptr;
+
+    void* view = ::MapViewOfFile( hMapping, FILE_MAP_COPY, 0, 0, 0 );
+    ::CloseHandle( hMapping );
+
+    if ( !view )
+        return nullptr;
+
+    const auto size = static_cast<size_t>( fileSize.QuadPart );
+#else
+    const int fd = ::open( file.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        return nullptr;
+
+    struct stat st {};
+    if ( ::fstat( fd, &st ) != 0 || st.st_size == 0 )
+    {
+        ::close( fd );
+        return nullptr;
+    }
+
+    const auto size = static_cast<size_t>( st.st_size );
+
+    // The mapping stays valid after the file is closed.
+    void* view = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+
+    if ( view == MAP_FAILED )
+        return nullptr;
+#endif
+
+    return std::make_shared<FileMapping>( static_cast<std::byte*>( view ), size );
+}
+
+bool TextureFile::write( const std::filesystem::path& file, const Image& image, std::span<const Math::RectI> rects )
+{
+    // The file stores the pixels in rows.
+    if ( image.getTextureLayout() != TextureLayout::Linear )
+    {
+        Image linear { image };
+        linear.setTextureLayout( TextureLayout::Linear );
+
+        return write( file, linear, rects );
+    }
+
+    const uint64_t pixelBytes = static_cast<uint64_t>( image.getWidth() ) * image.getHeight() * sizeof( Color );
+
+    TextureFileHeader header {};
+    header.magic       = TextureFileMagic;
+    header.version     = Version;
+    header.width       = image.getWidth();
+    header.height      = image.getHeight();
+    header.pixelOffset = sizeof( TextureFileHeader );
+    header.rectOffset  = header.pixelOffset + pixelBytes;
+    header.numRects    = static_cast<uint32_t>( rects.size() );
+
+    std::ofstream out( file, std::ios::binary | std::ios::trunc );
+    if ( !out )
+    {
+        std::cerr << "ERROR: Could not write: " << file.string() << std::endl;
+        return false;
+    }
+
+    out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    out.write( reinterpret_cast<const char*>( image.data() ), static_cast<std::streamsize>( pixelBytes ) );
+
+    for ( const Math::RectI& rect: rects )
+    {
+        const int32_t r[4] = { rect.left, rect.top, rect.width, rect.height };
+        out.write( reinterpret_cast<const char*>( r ), sizeof( r ) );
+    }
+
+    return out.good();
+}
+
+Image TextureFile::load( const std::filesystem::path& file, std::vector<Math::RectI>* rects )
+{
+    auto mapping = mapFile( file );
+    if ( !mapping )
+    {
+        std::cerr << "ERROR: Could not load: " << file.string() << std::endl;
+        return {};
+    }
+
+    TextureFileHeader header {};
+    if ( mapping->size >= sizeof( header ) )
+        std::memcpy( &header, mapping->data, sizeof( header ) );
+
+    const uint64_t rectBytes = static_cast<uint64_t>( header.numRects ) * 4 * sizeof( int32_t );
+
+    // The offsets and sizes are checked against the size of the file, so a corrupt file can't point outside of the mapping.
+    // The size of the pixels is checked by dividing the available bytes (multiplying the dimensions could overflow).
+    const bool valid = header.magic == TextureFileMagic && header.version == Version && header.width > 0 && header.height > 0 &&
+                       header.pixelOffset % alignof( Color ) == 0 && header.pixelOffset <= mapping->size &&
+                       header.width <= ( mapping->size - header.pixelOffset ) / sizeof( Color ) / header.height &&
+                       header.rectOffset <= mapping->size && rectBytes <= mapping->size - header.rectOffset;
+
+    if ( !valid )
+    {
+        std::cerr << "ERROR: Invalid texture file: " << file.string() << std::endl;
+        return {};
+    }
+
+    if ( rects )
+    {
+        rects->resize( header.numRects );
+
+        const std::byte* r = mapping->data + header.rectOffset;
+        for ( Math::RectI& rect: *rects )
+        {
+            int32_t v[4];
+            std::memcpy( v, r, sizeof( v ) );
+            r += sizeof( v );
+
+            rect = { v[0], v[1], v[2], v[3] };
+        }
+    }
+
+    auto* pixels = reinterpret_cast<Color*>( mapping->data + header.pixelOffset );
+
+    return { header.width, header.height, pixels, std::move( mapping ) };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Graphics/Color.hpp>
+#include <Graphics/Enums.hpp>
+#include <Graphics/Image.hpp>
+
+#include <Math/Rect.hpp>
+
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Graphics
+{
+/// <summary>
+/// Samples an image with bilinear or trilinear filtering.
+/// The mip levels (and the blend weight between them) are chosen once per primitive,
+/// so sampling a texel only costs the bilinear interpolation.
+/// </summary>
+/// <remarks>
+/// Texture coordinates are in texels of level 0 (not normalized), and the center of a texel is at integer coordinates,
+/// which matches the rounding of point sampling.
+/// </remarks>
+class TextureSampler
+{
+public:
+    /// <summary>
+    /// Create a sampler for a primitive.
+    /// </summary>
+    /// <param name="image">The image to sample.</param>
+    /// <param name="filterMode">The filter mode (FilterMode::Point is sampled as FilterMode::Bilinear).</param>
+    /// <param name="addressMode">The address mode to use for texels outside of the image.</param>
+    /// <param name="lod">The level of detail (see <see cref="computeLOD"/>).</param>
+    /// <param name="rect">(optional) Clamp the texels to this rectangle (of level 0), for example the rectangle of a sprite.</param>
+    TextureSampler( const Image& image, FilterMode filterMode, AddressMode addressMode, float lod, const Math::RectI* rect = nullptr )
+    : m_AddressMode { addressMode }
+    , m_ClampToRect { rect != nullptr }
+    {
+        const float maxLevel = static_cast<float>( image.getNumMipLevels() - 1 );
+
+        uint32_t level0 = 0;
+        uint32_t level1 = 0;
+
+        if ( lod > 0.0f )
+        {
+            if ( filterMode == FilterMode::Trilinear )
+            {
+                lod      = std::min( lod, maxLevel );
+                level0   = static_cast<uint32_t>( lod );
+                level1   = std::min( level0 + 1, static_cast<uint32_t>( maxLevel ) );
+                m_Weight = static_cast<int>( ( lod - static_cast<float>( level0 ) ) * 256.0f + 0.5f );
+            }
+            else
+            {
+                level0 = level1 = static_cast<uint32_t>( std::min( std::round( lod ), maxLevel ) );
+            }
+        }
+
+        m_NumLevels = m_Weight > 0 && level0 != level1 ? 2 : 1;
+        initLevel( m_Levels[0], image, image.getMipLevel( level0 ), rect );
+        initLevel( m_Levels[1], image, image.getMipLevel( level1 ), rect );
+    }
+
+    /// <summary>
+    /// Compute the level of detail of a primitive from the change in texture coordinates per pixel.
+    /// </summary>
+    /// <param name="dUVdx">The change in texture coordinates (in texels) per pixel step in x.</param>
+    /// <param name="dUVdy">The change in texture coordinates (in texels) per pixel step in y.</param>
+    /// <returns>The level of detail. Values less than or equal to 0 mean the texture is magnified.</returns>
+    static float computeLOD( const glm::vec2& dUVdx, const glm::vec2& dUVdy ) noexcept
+    {
+        const float rho = std::max( dUVdx.x * dUVdx.x + dUVdx.y * dUVdx.y, dUVdy.x * dUVdy.x + dUVdy.y * dUVdy.y );
+
+        // log2( sqrt( rho ) )
+        return rho > 0.0f ? 0.5f * std::log2( rho ) : 0.0f;
+    }
+
+    /// <summary>
+    /// Sample the image.
+    /// </summary>
+    /// <param name="uv">The texture coordinates (in texels of level 0).</param>
+    /// <returns>The filtered color.</returns>
+    Color operator()( const glm::vec2& uv ) const noexcept
+    {
+        const Color c0 = bilinear( m_Levels[0], uv );
+
+        if ( m_NumLevels == 1 )
+            return c0;
+
+        return lerp( c0, bilinear( m_Levels[1], uv ), m_Weight );
+    }
+
+private:
+    struct Level
+    {
+        const Image* image;
+        glm::vec2    scale;  ///< The size of this level relative to level 0.
+        glm::ivec2   minUV;  ///< The texels are clamped to [minUV, maxUV] (if the sampler clamps to a rect).
+        glm::ivec2   maxUV;
+    };
+
+    static void initLevel( Level& level, const Image& base, const Image& image, const Math::RectI* rect ) noexcept
+    {
+        level.image = &image;
+        level.scale = glm::vec2 { image.getWidth(), image.getHeight() } / glm::vec2 { base.getWidth(), base.getHeight() };
+
+        const glm::ivec2 size { image.getWidth(), image.getHeight() };
+
+        if ( rect )
+        {
+            // The texels of this level that overlap the rect.
+            level.minUV = glm::clamp( glm::ivec2 { glm::floor( glm::vec2 { rect->left, rect->top } * level.scale ) }, glm::ivec2 { 0 }, size - 1 );
+            level.maxUV = glm::clamp( glm::ivec2 { glm::ceil( glm::vec2 { rect->right(), rect->bottom() } * level.scale ) } - 1, level.minUV, size - 1 );
+        }
+    }
+
+    // Interpolate each channel: ( a * ( 256 - t ) + b * t ) / 256, with t in [0..256].
+    // Two channels are interpolated with a single multiply (each channel has 16 bits of room in a 32-bit word).
+    static Color lerp( const Color& a, const Color& b, int t ) noexcept
+    {
+        constexpr uint32_t Mask = 0x00FF00FF;
+
+        const uint32_t wb = static_cast<uint32_t>( t );
+        const uint32_t wa = 256u - wb;
+        const uint32_t rb = ( ( a.argb & Mask ) * wa + ( b.argb & Mask ) * wb ) >> 8 & Mask;
+        const uint32_t ag = ( ( a.argb >> 8 & Mask ) * wa + ( b.argb >> 8 & Mask ) * wb ) & ~Mask;
+
+        return Color { rb | ag };
+    }
+
+    const Color& fetch( const Level& level, int u, int v ) const noexcept
+    {
+        if ( m_ClampToRect )
+        {
+            u = std::clamp( u, level.minUV.x, level.maxUV.x );
+            v = std::clamp( v, level.minUV.y, level.maxUV.y );
+
+            return level.image->texel( static_cast<uint32_t>( u ), static_cast<uint32_t>( v ) );
+        }
+
+        return level.image->sample( u, v, m_AddressMode );
+    }
+
+    Color bilinear( const Level& level, const glm::vec2& uv ) const noexcept
+    {
+        // Texel centers are at integer coordinates in every level.
+        const glm::vec2 p = ( uv + 0.5f ) * level.scale - 0.5f;
+
+        const float u0 = std::floor( p.x );
+        const float v0 = std::floor( p.y );
+        const int   tu = static_cast<int>( ( p.x - u0 ) * 256.0f + 0.5f );
+        const int   tv = static_cast<int>( ( p.y - v0 ) * 256.0f + 0.5f );
+        const int   u  = static_cast<int>( u0 );
+        const int   v  = static_cast<int>( v0 );
+
+        const Color top    = lerp( fetch( level, u, v ), fetch( level, u + 1, v ), tu );
+        const Color bottom = lerp( fetch( level, u, v + 1 ), fetch( level, u + 1, v + 1 ), tu );
+
+        return lerp( top, bottom, tv );
+    }
+
+    Level       m_Levels[2];
+    int         m_NumLevels = 1;
+    int         m_Weight    = 0;  ///< The weight (0..256) of the second level.
+    AddressMode m_AddressMode;
+    bool        m_ClampToRect;
+};
+}  // namespace Graphics
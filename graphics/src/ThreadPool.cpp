@@ -0,0 +1,302 @@
+#include <Graphics/ThreadPool.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+#if defined( _WIN32 )
+    #include "Win32/IncludeWin32.hpp"
+#elif defined( __linux__ )
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+using namespace Graphics;
+
+// Set while the current thread executes the iterations of a parallel loop.
+// Nested loops are executed on the current thread.
+static thread_local bool t_InParallelFor = false;
+
+/// <summary>
+/// A range of iterations [begin, end) that is packed in a single atomic, so that the owner
+/// can take iterations from the front while other threads steal iterations from the back.
+/// </summary>
+struct alignas( 64 ) ThreadPool::Range
+{
+    std::atomic<uint64_t> range { 0 };
+
+    static constexpr uint64_t pack( int begin, int end ) noexcept
+    {
+        return static_cast<uint64_t>( static_cast<uint32_t>( begin ) ) << 32 | static_cast<uint32_t>( end );
+    }
+
+    static constexpr int first( uint64_t r ) noexcept
+    {
+        return static_cast<int>( static_cast<uint32_t>( r >> 32 ) );
+    }
+
+    static constexpr int last( uint64_t r ) noexcept
+    {
+        return static_cast<int>( static_cast<uint32_t>( r ) );
+    }
+
+    // Take (at most) grainSize iterations from the front of the range.
+    bool take( int grainSize, int& begin, int& end ) noexcept
+    {
+        uint64_t r = range.load( std::memory_order_relaxed );
+        do
+        {
+            begin = first( r );
+            end   = std::min( last( r ), begin + grainSize );
+            if ( begin >= end )
+                return false;
+        } while ( !range.compare_exchange_weak( r, pack( end, last( r ) ), std::memory_order_acquire, std::memory_order_relaxed ) );
+
+        return true;
+    }
+
+    // Steal half of the remaining iterations from the back of the range.
+    bool steal( int grainSize, int& begin, int& end ) noexcept
+    {
+        uint64_t r = range.load( std::memory_order_relaxed );
+        do
+        {
+            const int b     = first( r );
+            const int e     = last( r );
+            const int count = e - b;
+            if ( count <= 0 )
+                return false;
+
+            begin = count > grainSize ? e - count / 2 : b;
+            end   = e;
+        } while ( !range.compare_exchange_weak( r, pack( first( r ), begin ), std::memory_order_acquire, std::memory_order_relaxed ) );
+
+        return true;
+    }
+};
+
+struct ThreadPool::Job
+{
+    Invoke   invoke;
+    void*    func;
+    int      grainSize;
+    uint32_t numParticipants;
+    int      refs = 0;  ///< The number of worker threads that are executing the job (guarded by m_Mutex).
+};
+
+static void setThreadAffinity( std::thread& thread, uint32_t core )
+{
+#if defined( _WIN32 )
+    ::SetThreadAffinityMask( thread.native_handle(), DWORD_PTR { 1 } << ( core % ( sizeof( DWORD_PTR ) * 8 ) ) );
+#elif defined( __linux__ )
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    CPU_SET( core % CPU_SETSIZE, &cpuSet );
+    pthread_setaffinity_np( thread.native_handle(), sizeof( cpu_set_t ), &cpuSet );
+#else
+    // Thread affinity is not supported on this platform.
+    (void)thread;
+    (void)core;
+#endif
+}
+
+static void clearThreadAffinity( std::thread& thread )
+{
+#if defined( _WIN32 )
+    DWORD_PTR processMask, systemMask;
+    if ( ::GetProcessAffinityMask( ::GetCurrentProcess(), &processMask, &systemMask ) )
+        ::SetThreadAffinityMask( thread.native_handle(), processMask );
+#elif defined( __linux__ )
+    cpu_set_t cpuSet;
+    if ( sched_getaffinity( 0, sizeof( cpu_set_t ), &cpuSet ) == 0 )
+        pthread_setaffinity_np( thread.native_handle(), sizeof( cpu_set_t ), &cpuSet );
+#else
+    (void)thread;
+#endif
+}
+
+ThreadPool& ThreadPool::get()
+{
+    static ThreadPool threadPool {
+        [] {
+            const char* numThreads = std::getenv( "SR_NUM_THREADS" );  // NOLINT(concurrency-mt-unsafe)
+            return numThreads ? static_cast<uint32_t>( std::strtoul( numThreads, nullptr, 10 ) ) : 0u;
+        }()
+    };
+
+    return threadPool;
+}
+
+ThreadPool::ThreadPool( uint32_t numThreads )
+{
+    start( numThreads );
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+void ThreadPool::setNumThreads( uint32_t numThreads )
+{
+    std::lock_guard lock { m_JobMutex };
+
+    stop();
+    start( numThreads );
+}
+
+void ThreadPool::setAffinity( bool pinThreads )
+{
+    std::lock_guard lock { m_JobMutex };
+
+    m_PinThreads = pinThreads;
+
+    // The calling thread is participant 0, so the workers are pinned to the other hardware threads.
+    for ( uint32_t i = 0; i < m_Workers.size(); ++i )
+    {
+        if ( pinThreads )
+            setThreadAffinity( m_Workers[i], i + 1 );
+        else
+            clearThreadAffinity( m_Workers[i] );
+    }
+}
+
+void ThreadPool::start( uint32_t numThreads )
+{
+    if ( numThreads == 0 )
+        numThreads = std::max( std::thread::hardware_concurrency(), 1u );
+
+    m_Stop   = false;
+    m_Ranges = std::make_unique<Range[]>( numThreads );
+
+    m_Workers.reserve( numThreads - 1 );
+    for ( uint32_t i = 1; i < numThreads; ++i )
+    {
+        m_Workers.emplace_back( &ThreadPool::workerMain, this, i );
+
+        if ( m_PinThreads )
+            setThreadAffinity( m_Workers.back(), i );
+    }
+}
+
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard lock { m_Mutex };
+        m_Stop = true;
+    }
+    m_WorkCV.notify_all();
+
+    for ( auto& worker: m_Workers )
+        worker.join();
+
+    m_Workers.clear();
+}
+
+void ThreadPool::run( int begin, int end, int grainSize, Invoke invoke, void* func )
+{
+    // Nested loops, and loops that are started while another thread is using the pool, are executed inline.
+    std::unique_lock jobLock { m_JobMutex, std::try_to_lock };
+    if ( t_InParallelFor || !jobLock.owns_lock() || m_Workers.empty() )
+    {
+        invoke( func, begin, end );
+        return;
+    }
+
+    Job job {
+        .invoke          = invoke,
+        .func            = func,
+        .grainSize       = grainSize,
+        .numParticipants = getNumThreads(),
+    };
+
+    // Distribute the iterations evenly over the participants.
+    const int64_t count = end - begin;
+    for ( uint32_t i = 0; i < job.numParticipants; ++i )
+    {
+        const int b = begin + static_cast<int>( count * i / job.numParticipants );
+        const int e = begin + static_cast<int>( count * ( i + 1 ) / job.numParticipants );
+        m_Ranges[i].range.store( Range::pack( b, e ), std::memory_order_relaxed );
+    }
+
+    {
+        std::lock_guard lock { m_Mutex };
+        m_Job = &job;
+        ++m_Generation;
+    }
+    m_WorkCV.notify_all();
+
+    execute( job, 0 );
+
+    // When the calling thread runs out of work, all iterations have been taken.
+    // Wait for the workers that are still executing them.
+    std::unique_lock lock { m_Mutex };
+    m_Job = nullptr;
+    m_DoneCV.wait( lock, [&] { return job.refs == 0; } );
+}
+
+void ThreadPool::execute( Job& job, uint32_t participant )
+{
+    t_InParallelFor = true;
+
+    Range& own = m_Ranges[participant];
+    int    begin, end;
+
+    while ( true )
+    {
+        while ( own.take( job.grainSize, begin, end ) )
+            job.invoke( job.func, begin, end );
+
+        // Steal from the other participants.
+        bool stolen = false;
+        for ( uint32_t i = 1; i < job.numParticipants && !stolen; ++i )
+        {
+            Range& victim = m_Ranges[( participant + i ) % job.numParticipants];
+            if ( victim.steal( job.grainSize, begin, end ) )
+            {
+                // Make the stolen iterations our own, so they can be stolen again.
+                own.range.store( Range::pack( begin, end ), std::memory_order_relaxed );
+                stolen = true;
+            }
+        }
+
+        if ( !stolen )
+            break;
+    }
+
+    t_InParallelFor = false;
+}
+
+void ThreadPool::workerMain( uint32_t index )
+{
+    uint64_t generation = 0;
+
+    while ( true )
+    {
+        Job* job = nullptr;
+        {
+            std::unique_lock lock { m_Mutex };
+            m_WorkCV.wait( lock, [&] { return m_Stop || m_Generation != generation; } );
+
+            if ( m_Stop )
+                return;
+
+            generation = m_Generation;
+            job        = m_Job;
+
+            // The job may already be finished by the time this thread wakes up.
+            if ( !job )
+                continue;
+
+            ++job->refs;
+        }
+
+        execute( *job, index );
+
+        {
+            std::lock_guard lock { m_Mutex };
+            if ( --job->refs == 0 )
+                m_DoneCV.notify_all();
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#include "PixelStreamGL.hpp"
+
+using namespace Graphics;
+using namespace Math;
+
+// The time to wait for a fence before checking again (in nanoseconds).
+constexpr GLuint64 FenceTimeout = 1'000'000;
+
+PixelStreamGL::PixelStreamGL()
+: m_Persistent { GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage }
+{}
+
+PixelStreamGL::~PixelStreamGL()
+{
+    release();
+}
+
+void PixelStreamGL::release()
+{
+    for ( GLsync& fence: m_Fences )
+    {
+        if ( fence )
+        {
+            glDeleteSync( fence );
+            fence = nullptr;
+        }
+    }
+
+    if ( m_PixelBuffer )
+    {
+        glUnmapNamedBuffer( m_PixelBuffer );
+        glDeleteBuffers( 1, &m_PixelBuffer );
+        m_PixelBuffer = 0;
+    }
+
+    if ( m_Texture )
+    {
+        glDeleteTextures( 1, &m_Texture );
+        m_Texture = 0;
+    }
+
+    m_Staging.reset();
+    m_Mapped   = nullptr;
+    m_SlotSize = 0;
+}
+
+void PixelStreamGL::allocate( uint32_t width, uint32_t height )
+{
+    // Immutable texture storage can't be resized, so the texture is recreated.
+    // Waiting for the fences (in release) is not required, since the driver keeps deleted objects alive while they are in use.
+    release();
+
+    glCreateTextures( GL_TEXTURE_2D, 1, &m_Texture );
+    glTextureStorage2D( m_Texture, 1, GL_RGBA8, static_cast<GLsizei>( width ), static_cast<GLsizei>( height ) );
+    glTextureParameteri( m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTextureParameteri( m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTextureParameteri( m_Texture, GL_TEXTURE_MAX_LEVEL, 0 );
+
+    m_SlotSize = static_cast<size_t>( width ) * height;
+
+    if ( m_Persistent )
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr size  = static_cast<GLsizeiptr>( m_SlotSize * RingSize * sizeof( Color ) );
+
+        glCreateBuffers( 1, &m_PixelBuffer );
+        glNamedBufferStorage( m_PixelBuffer, size, nullptr, flags );
+        m_Mapped = static_cast<Color*>( glMapNamedBufferRange( m_PixelBuffer, 0, size, flags ) );
+    }
+    else
+    {
+        // glTextureSubImage2D copies client memory before it returns, so a single staging buffer is enough.
+        m_Staging = std::make_unique<Color[]>( m_SlotSize );
+        m_Mapped  = m_Staging.get();
+    }
+}
+
+Color* PixelStreamGL::acquire( uint32_t slot )
+{
+    if ( !m_Persistent )
+        return m_Mapped;
+
+    if ( GLsync fence = m_Fences[slot] )
+    {
+        GLenum result = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout );
+        while ( result == GL_TIMEOUT_EXPIRED )
+            result = glClientWaitSync( fence, 0, FenceTimeout );
+
+        glDeleteSync( fence );
+        m_Fences[slot] = nullptr;
+    }
+
+    return m_Mapped + slot * m_SlotSize;
+}
+
+void PixelStreamGL::transfer( uint32_t slot, std::span<const RectI> regions )
+{
+    // The staging buffers have the same layout as the texture.
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, static_cast<GLint>( getWidth() ) );
+
+    if ( m_Persistent )
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer );
+
+    for ( const RectI& r: regions )
+    {
+        const size_t offset = static_cast<size_t>( r.top ) * getWidth() + r.left;
+
+        // With a pixel unpack buffer bound, the pointer is an offset into the buffer.
+        const void* pixels = m_Persistent ? reinterpret_cast<const void*>( ( slot * m_SlotSize + offset ) * sizeof( Color ) ) : m_Mapped + offset;
+
+        glTextureSubImage2D( m_Texture, 0, r.left, r.top, r.width, r.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
+    }
+
+    if ( m_Persistent )
+    {
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+        m_Fences[slot] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    }
+
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../PixelStream.hpp"
+
+#include <GL/glew.h>
+
+#include <memory>
+
+namespace Graphics
+{
+/// <summary>
+/// Streams pixels to an OpenGL texture with immutable storage.
+/// The staging buffers are slices of a single pixel buffer object that is persistently mapped, so the pixels are
+/// written directly into driver memory. A fence is inserted after each transfer, and a slice is only reused
+/// once the GPU is done reading from it.
+/// If persistent mapping is not supported (OpenGL 4.4 or ARB_buffer_storage), the pixels are staged in
+/// system memory and uploaded with glTextureSubImage2D instead.
+/// </summary>
+/// <remarks>
+/// The OpenGL context of the window must be current when the stream is used.
+/// </remarks>
+class PixelStreamGL final : public PixelStream
+{
+public:
+    PixelStreamGL();
+    ~PixelStreamGL() override;
+
+    PixelStreamGL( const PixelStreamGL& )            = delete;
+    PixelStreamGL( PixelStreamGL&& )                 = delete;
+    PixelStreamGL& operator=( const PixelStreamGL& ) = delete;
+    PixelStreamGL& operator=( PixelStreamGL&& )      = delete;
+
+    /// <summary>
+    /// Get the texture that the pixels are streamed to.
+    /// </summary>
+    GLuint getTexture() const noexcept
+    {
+        return m_Texture;
+    }
+
+protected:
+    void   allocate( uint32_t width, uint32_t height ) override;
+    Color* acquire( uint32_t slot ) override;
+    void   transfer( uint32_t slot, std::span<const Math::RectI> regions ) override;
+
+private:
+    void release();
+
+    bool                     m_Persistent;              ///< Persistently mapped buffers are supported.
+    GLuint                   m_Texture     = 0;         ///< The texture with immutable storage.
+    GLuint                   m_PixelBuffer = 0;         ///< The pixel unpack buffer that holds all of the staging buffers.
+    Color*                   m_Mapped      = nullptr;   ///< The mapped pixel buffer (or the staging memory in system memory).
+    size_t                   m_SlotSize    = 0;         ///< The number of pixels in a staging buffer.
+    GLsync                   m_Fences[RingSize] {};     ///< Signaled when the GPU is done reading from a staging buffer.
+    std::unique_ptr<Color[]> m_Staging;                 ///< The staging memory if persistent mapping is not supported.
+};
+}  // namespace Graphics
@@ -113,11 +113,8 @@ WindowWin32::WindowWin32( std::wstring_view title, int width, int height )
     m_hGLRC = wglCreateContextAttribsARB( m_hDC, nullptr, attribs );
     makeCurrent();
 
-    // Create an OpenGL texture for pixel operations.
-    glGenTextures( 1, &m_Texture );
-    glTextureParameteri( m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-    glTextureParameteri( m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-    glTextureParameteri( m_Texture, GL_TEXTURE_MAX_LEVEL, 0 );
+    // Create the pixel stream that uploads the presented images to a texture.
+    m_PixelStream = std::make_unique<PixelStreamGL>();
 
     // Create a full-screen quad.
     struct Vertex
@@ -190,7 +187,8 @@ WindowWin32::WindowWin32( std::wstring_view title, int width, int height )
 
 WindowWin32::~WindowWin32()
 {
-    glDeleteTextures( 1, &m_Texture );
+    makeCurrent();
+    m_PixelStream.reset();
     wglMakeCurrent( m_hDC, nullptr );
     wglDeleteContext( m_hGLRC );
     ::ReleaseDC( m_hWnd, m_hDC );
@@ -315,12 +313,9 @@ void WindowWin32::present( const Image& image )
 {
     makeCurrent();
 
-    // Copy the image data to the texture
-    // glInvalidateTexImage( m_Texture, 0 );
-    glBindTexture( GL_TEXTURE_2D, m_Texture );
-    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, static_cast<GLsizei>( image.getWidth() ), static_cast<GLsizei>( image.getHeight() ), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data() );
-    glTextureParameteri( m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-    glTextureParameteri( m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    // Stream the image data to the texture (only the dirty rectangles if the same image is presented again).
+    m_PixelStream->upload( image );
+    glBindTexture( GL_TEXTURE_2D, m_PixelStream->getTexture() );
 
     // Center the image on screen and maintain the aspect ratio.
     const float aspectRatio = static_cast<float>( image.getWidth() ) / static_cast<float>( image.getHeight() );
@@ -351,9 +346,19 @@ void WindowWin32::present( const Image& image )
     ::SwapBuffers( m_hDC );
 }
 
-void WindowWin32::pushEvent( const Event& e )
+void WindowWin32::releaseContext()
+{
+    // An OpenGL context can only be current on one thread at a time.
+    if ( currentContext == m_hGLRC )
+    {
+        wglMakeCurrent( m_hDC, nullptr );
+        currentContext = nullptr;
+    }
+}
+
+bool WindowWin32::pushEvent( const Event& event )
 {
-    m_eventQueue.push( e );
+    return m_EventQueue.push( event );
 }
 
 void WindowWin32::onClose()
@@ -513,18 +518,12 @@ void WindowWin32::onMouseMoved( MouseMovedEventArgs& args )
 
 bool WindowWin32::popEvent( Event& event )
 {
-    if ( m_eventQueue.empty() )
-    {
-        processEvents();
-    }
-
-    if ( m_eventQueue.empty() )
-        return false;
+    if ( m_EventQueue.pop( event ) )
+        return true;
 
-    event = m_eventQueue.front();
-    m_eventQueue.pop();
+    processEvents();
 
-    return true;
+    return m_EventQueue.pop( event );
 }
 
 int WindowWin32::getWidth() const noexcept
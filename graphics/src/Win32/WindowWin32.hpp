@@ -1,6 +1,8 @@
 #pragma once
 
+#include "../EventQueue.hpp"
 #include "IncludeWin32.hpp"
+#include "PixelStreamGL.hpp"
 
 #include <Graphics/Config.hpp>
 #include <Graphics/Events.hpp>
@@ -8,7 +10,7 @@
 
 #include <GL/glew.h>
 
-#include <queue>
+#include <memory>
 
 // Forward declaration of Windows callback function.
 LRESULT CALLBACK WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam );
@@ -35,8 +37,12 @@ public:
 
     void present( const Image& image ) override;
 
+    void releaseContext() override;
+
     bool popEvent( Event& event ) override;
 
+    bool pushEvent( const Event& event ) override;
+
     int getWidth() const noexcept override;
 
     int getHeight() const noexcept override;
@@ -53,7 +59,6 @@ protected:
     void init();
 
     void processEvents();
-    void pushEvent( const Event& e );
 
     void onClose();
     void onKeyPressed( KeyEventArgs& args );
@@ -86,11 +91,12 @@ private:
     RECT              windowRect;       ///< Window rectangle (for restoring from fullscreen state).
     HDC               m_hDC;            ///< Window draw context.
     HGLRC             m_hGLRC;          ///< OpenGL render context.
-    GLuint            m_Texture;        ///< OpenGL texture for pixel transfers.
     GLuint            m_VBO;            ///< Vertex buffer object for the vertices of the quad.
     GLuint            m_IndexBuffer;    ///< Index buffer for draw a quad.
     GLuint            m_VAO;            ///< Vertex Array Object for drawing a fullscreen quad.
     GLuint            m_ShaderProgram;  ///< Shader program.
-    std::queue<Event> m_eventQueue;
+    EventQueue        m_EventQueue;     ///< Events from the message pump and other threads.
+
+    std::unique_ptr<PixelStreamGL> m_PixelStream;  ///< Streams the presented images to a texture.
 };
 }  // namespace Graphics
\ No newline at end of file
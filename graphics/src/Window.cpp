@@ -2,9 +2,10 @@
 
 using namespace Graphics;
 
+#include "Headless/WindowHeadless.hpp"
+
 #if defined(_WIN32)
 #include "Win32/WindowWin32.hpp"
-using WindowType = WindowWin32;
 #endif
 
 Window::Window(std::wstring_view title, int width, int height)
@@ -18,7 +19,15 @@ Window& Window::operator=(Window&&) noexcept = default;
 
 void Window::create(std::wstring_view title, int width, int height)
 {
-    pImpl = std::make_unique<WindowType>(title, width, height);
+#if defined(_WIN32)
+    if ( !WindowHeadless::isRequested() )
+    {
+        pImpl = std::make_unique<WindowWin32>(title, width, height);
+        return;
+    }
+#endif
+    // Without a native window implementation, the window renders offscreen.
+    pImpl = std::make_unique<WindowHeadless>(title, width, height);
 }
 
 WindowHandle Window::getWindowHandle() const noexcept
@@ -31,6 +40,11 @@ bool Window::popEvent(Event& event)
     return pImpl && pImpl->popEvent(event);
 }
 
+bool Window::pushEvent( const Event& event )
+{
+    return pImpl && pImpl->pushEvent( event );
+}
+
 void Window::show()
 {
     pImpl->show();
@@ -76,6 +90,11 @@ void Window::present(const Image& image)
     pImpl->present(image);
 }
 
+void Window::releaseContext()
+{
+    pImpl->releaseContext();
+}
+
 void Window::destroy()
 {
     pImpl.reset();
@@ -1,6 +1,7 @@
 #include <Graphics/Font.hpp>
 
 #include <Graphics/Image.hpp>
+#include <Graphics/SwapChain.hpp>
 #include <Graphics/Timer.hpp>
 #include <Graphics/Window.hpp>
 
@@ -15,22 +16,26 @@ int main( int argc, char* argv[] )
 
     Window window { L"01-ClearScreen", WINDOW_WIDTH, WINDOW_HEIGHT };
 
-    Image image { WINDOW_WIDTH, WINDOW_HEIGHT };
-
     window.show();
 
+    // Render the next frame while the previous frame is presented on the present thread.
+    SwapChain swapChain { window, WINDOW_WIDTH, WINDOW_HEIGHT };
+
     Timer       timer;
     double      totalTime  = 0.0;
     uint64_t    frameCount = 0ull;
     std::string fps        = "FPS: 0";
 
-    while ( window )
+    bool running = true;
+    while ( running )
     {
+        Image& image = swapChain.getBackBuffer();
+
         image.clear( Color::Black );
 
         image.drawText( Font::Default, fps, 10, 10, Color::White );
 
-        window.present( image );
+        swapChain.present();
 
         Event e;
         while ( window.popEvent( e ) )
@@ -38,22 +43,22 @@ int main( int argc, char* argv[] )
             switch ( e.type )
             {
             case Event::Close:
-                window.destroy();
+                running = false;
                 break;
             case Event::KeyPressed:
                 switch ( e.key.code )
                 {
                 case KeyCode::V:
-                    window.toggleVSync();
+                    swapChain.toggleVSync();
                     break;
                 case KeyCode::Escape:
-                    window.destroy();
+                    running = false;
                     break;
                 }
                 break;
             case Event::EndResize:
                 std::cout << std::format( "Resize: {},{}\n", e.resize.width, e.resize.height );
-                image.resize( e.resize.width, e.resize.height );
+                swapChain.resize( e.resize.width, e.resize.height );
                 break;
             }
         }
@@ -34,6 +34,9 @@ int main( int argc, char* argv[] )
     Sprite      sprite { monaLisa };
     Transform2D transform;
 
+    // The sprite is drawn at a fraction of its size, so sample the mipmaps to avoid aliasing.
+    sprite.setFilterMode( FilterMode::Trilinear );
+
     // Rotate around the center of the screen.
     transform.setAnchor( { monaLisa->getWidth() / 2.0f, monaLisa->getHeight() / 2.0f } );
     transform.setPosition( { WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f } );
@@ -2,6 +2,7 @@
 
 #include <Graphics/Image.hpp>
 #include <Graphics/Sprite.hpp>
+#include <Graphics/SpriteBatch.hpp>
 
 #include <filesystem>
 
@@ -39,4 +40,7 @@ private:
     float                          time     = 0.0f;
     const float                    maxScale = 3.2f;
     std::vector<Math::Transform2D> transforms;
+
+    // The sprites of the transition are drawn in a single batch.
+    mutable Graphics::SpriteBatch batch;
 };
\ No newline at end of file
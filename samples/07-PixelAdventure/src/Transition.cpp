@@ -60,8 +60,12 @@ void Transition::setRatio( float ratio )
 
 void Transition::draw( Graphics::Image& image ) const
 {
+    batch.clear();
+
     for ( auto& transform: transforms )
     {
-        image.drawSprite( sprite, transform );
+        batch.draw( sprite, transform );
     }
+
+    batch.render( image );
 }
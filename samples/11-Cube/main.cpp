@@ -0,0 +1,127 @@
+#include <Graphics/DepthBuffer.hpp>
+#include <Graphics/Font.hpp>
+#include <Graphics/Image.hpp>
+#include <Graphics/ResourceManager.hpp>
+#include <Graphics/Timer.hpp>
+#include <Graphics/Window.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <iostream>
+
+using namespace Graphics;
+
+// The corners of a unit cube.
+static const glm::vec3 CubeCorners[] = {
+    { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+    { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 },
+};
+
+// The corners of each face, in counter-clockwise order (seen from outside of the cube).
+static const int CubeFaces[6][4] = {
+    { 4, 5, 6, 7 },  // +z
+    { 1, 0, 3, 2 },  // -z
+    { 5, 1, 2, 6 },  // +x
+    { 0, 4, 7, 3 },  // -x
+    { 7, 6, 2, 3 },  // +y
+    { 0, 1, 5, 4 },  // -y
+};
+
+static const Color FaceColors[] = { Color::White, Color::Red, Color::Green, Color::Blue, Color::Yellow, Color::Magenta };
+
+int main( int argc, char* argv[] )
+{
+    // Parse command-line arguments.
+    if ( argc > 1 )
+    {
+        for ( int i = 0; i < argc; ++i )
+        {
+            if ( strcmp( argv[i], "-cwd" ) == 0 )
+            {
+                std::string workingDirectory = argv[++i];
+                std::filesystem::current_path( workingDirectory );
+            }
+        }
+    }
+
+    const int WINDOW_WIDTH  = 800;
+    const int WINDOW_HEIGHT = 600;
+
+    Window      window { L"11 - Cube", WINDOW_WIDTH, WINDOW_HEIGHT };
+    Image       image { WINDOW_WIDTH, WINDOW_HEIGHT };
+    DepthBuffer depthBuffer { WINDOW_WIDTH, WINDOW_HEIGHT };
+
+    auto texture = ResourceManager::loadImage( "assets/textures/Smiley.png" );
+
+    window.show();
+
+    const glm::mat4 projection = glm::perspective( glm::radians( 60.0f ), static_cast<float>( WINDOW_WIDTH ) / static_cast<float>( WINDOW_HEIGHT ), 0.1f, 100.0f );
+    const glm::mat4 view       = glm::lookAt( glm::vec3 { 0, 1.5f, 5.0f }, glm::vec3 { 0 }, glm::vec3 { 0, 1, 0 } );
+
+    Timer       timer;
+    double      totalTime  = 0.0;
+    uint64_t    frameCount = 0ull;
+    std::string fps        = "FPS: 0";
+
+    while ( window )
+    {
+        image.clear( Color::Black );
+        depthBuffer.clear();
+
+        const float     angle = static_cast<float>( timer.totalSeconds() );
+        const glm::mat4 model = glm::rotate( glm::rotate( glm::mat4 { 1.0f }, angle, glm::vec3 { 0, 1, 0 } ), angle * 0.5f, glm::vec3 { 1, 0, 0 } );
+        const glm::mat4 mvp   = projection * view * model;
+
+        // Draw each face of the cube as two triangles.
+        // The back faces are culled, and the depth buffer removes the faces that are hidden behind other faces.
+        for ( int f = 0; f < 6; ++f )
+        {
+            ClipVertex verts[4];
+            const glm::vec2 texCoords[] = { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 0, 0 } };
+
+            for ( int i = 0; i < 4; ++i )
+                verts[i] = ClipVertex { mvp * glm::vec4 { CubeCorners[CubeFaces[f][i]], 1.0f }, texCoords[i], FaceColors[f] };
+
+            image.drawTriangle( verts[0], verts[1], verts[2], depthBuffer, *texture, AddressMode::Clamp, CullMode::Back );
+            image.drawTriangle( verts[0], verts[2], verts[3], depthBuffer, *texture, AddressMode::Clamp, CullMode::Back );
+        }
+
+        image.drawText( Font::Default, fps, 10, 10, Color::White );
+
+        window.present( image );
+
+        Event e;
+        while ( window.popEvent( e ) )
+        {
+            switch ( e.type )
+            {
+            case Event::Close:
+                window.destroy();
+                break;
+            case Event::KeyPressed:
+                switch ( e.key.code )
+                {
+                case KeyCode::Escape:
+                    window.destroy();
+                    break;
+                }
+                break;
+            }
+        }
+
+        timer.tick();
+        ++frameCount;
+
+        totalTime += timer.elapsedSeconds();
+        if ( totalTime > 1.0 )
+        {
+            fps = std::format( "FPS: {:.3f}", static_cast<double>( frameCount ) / totalTime );
+
+            std::cout << fps << std::endl;
+
+            frameCount = 0;
+            totalTime  = 0.0;
+        }
+    }
+}
@@ -0,0 +1,154 @@
+// Tests for drawing indexed triangle lists with Image::drawIndexed: the culling convention (which must match the 3D
+// triangles), indices that are out of range, and binning the triangles into tiles in immediate and deferred mode.
+#include "Test.hpp"
+
+#include <Graphics/DepthBuffer.hpp>
+#include <Graphics/Image.hpp>
+#include <Graphics/ThreadPool.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Graphics;
+
+static bool equal( const Image& a, const Image& b )
+{
+    return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+           std::memcmp( a.data(), b.data(), static_cast<size_t>( a.getWidth() ) * a.getHeight() * sizeof( Color ) ) == 0;
+}
+
+static int countPixels( const Image& image )
+{
+    int count = 0;
+    for ( uint32_t i = 0; i < image.getWidth() * image.getHeight(); ++i )
+        count += image.data()[i] != Color::Black;
+
+    return count;
+}
+
+// Draw a triangle (in image space) as a 2D indexed triangle, and as a 3D triangle at the same position.
+static void drawBoth( const glm::vec2 ( &p )[3], CullMode cullMode, int& count2D, int& count3D )
+{
+    constexpr uint32_t Size = 64;
+
+    Image image { Size, Size };
+    image.clear( Color::Black );
+
+    const Vertex   vertices[] = { { p[0] }, { p[1] }, { p[2] } };
+    const uint32_t indices[]  = { 0, 1, 2 };
+    image.drawIndexed( vertices, indices, nullptr, {}, glm::mat3 { 1.0f }, AddressMode::Wrap, cullMode );
+    count2D = countPixels( image );
+
+    // Pixel (x, y) is at the integer coordinate (x, y), and +y points down.
+    auto toNDC = [&]( const glm::vec2& v ) {
+        return glm::vec4 { ( v.x + 0.5f ) / Size * 2.0f - 1.0f, 1.0f - ( v.y + 0.5f ) / Size * 2.0f, 0.5f, 1.0f };
+    };
+
+    DepthBuffer depthBuffer { Size, Size };
+    image.clear( Color::Black );
+    image.drawTriangle( ClipVertex { toNDC( p[0] ) }, ClipVertex { toNDC( p[1] ) }, ClipVertex { toNDC( p[2] ) }, depthBuffer, cullMode );
+    count3D = countPixels( image );
+}
+
+static void cullConvention()
+{
+    // Counter-clockwise as displayed (down the left side, then right along the bottom).
+    const glm::vec2 front[] = { { 10, 10 }, { 10, 50 }, { 50, 50 } };
+    const glm::vec2 back[]  = { { 10, 10 }, { 50, 50 }, { 10, 50 } };
+
+    int count2D, count3D;
+
+    drawBoth( front, CullMode::None, count2D, count3D );
+    CHECK( count2D > 0 );
+    CHECK( count3D > 0 );
+
+    drawBoth( front, CullMode::Back, count2D, count3D );
+    CHECK( count2D > 0 );
+    CHECK( count3D > 0 );
+
+    drawBoth( front, CullMode::Front, count2D, count3D );
+    CHECK( count2D == 0 );
+    CHECK( count3D == 0 );
+
+    drawBoth( back, CullMode::Back, count2D, count3D );
+    CHECK( count2D == 0 );
+    CHECK( count3D == 0 );
+
+    drawBoth( back, CullMode::Front, count2D, count3D );
+    CHECK( count2D > 0 );
+    CHECK( count3D > 0 );
+}
+
+static void badIndices()
+{
+    const Vertex vertices[] = { { { 4, 4 } }, { { 60, 8 } }, { { 30, 60 } } };
+
+    Image expected { 64, 64 };
+    expected.clear( Color::Black );
+    const uint32_t valid[] = { 0, 1, 2 };
+    expected.drawIndexed( vertices, valid );
+
+    // The triangles with an index that is out of range, and the incomplete triangle at the end, are skipped.
+    Image image { 64, 64 };
+    image.clear( Color::Black );
+    const uint32_t indices[] = { 0, 1, 3, 0, 1, 2, 0xffffffffu, 0, 1, 2, 0 };
+    image.drawIndexed( vertices, indices );
+
+    CHECK( countPixels( image ) > 0 );
+    CHECK( equal( image, expected ) );
+}
+
+static void binnedTriangles()
+{
+    // Overlapping triangles with blending, so the result depends on the order the triangles are drawn in.
+    std::mt19937                          rng { 7 };
+    std::uniform_real_distribution<float> position { -40.0f, 240.0f };
+    std::uniform_int_distribution<int>    channel { 0, 255 };
+
+    std::vector<Vertex>   vertices;
+    std::vector<uint32_t> indices;
+    for ( uint32_t i = 0; i < 600; ++i )
+    {
+        const Color color { static_cast<uint8_t>( channel( rng ) ), static_cast<uint8_t>( channel( rng ) ), static_cast<uint8_t>( channel( rng ) ), 128 };
+        vertices.push_back( { { position( rng ), position( rng ) }, { 0, 0 }, color } );
+        indices.push_back( i );
+        indices.push_back( ( i + 7 ) % 600 );
+        indices.push_back( ( i + 13 ) % 600 );
+    }
+
+    ThreadPool& pool = ThreadPool::get();
+    pool.setNumThreads( 4 );
+    pool.setInlineThreshold( 0 );
+
+    // Each triangle on its own.
+    Image expected { 200, 150 };
+    expected.clear( Color::Black );
+    for ( size_t i = 0; i < indices.size(); i += 3 )
+        expected.drawIndexed( vertices, std::span { indices }.subspan( i, 3 ), nullptr, BlendMode::AlphaBlend );
+
+    Image immediate { 200, 150 };
+    immediate.clear( Color::Black );
+    immediate.drawIndexed( vertices, indices, nullptr, BlendMode::AlphaBlend );
+
+    Image deferred { 200, 150 };
+    deferred.clear( Color::Black );
+    deferred.beginDeferred( 32 );
+    deferred.drawIndexed( vertices, indices, nullptr, BlendMode::AlphaBlend );
+    deferred.endDeferred();
+
+    CHECK( equal( immediate, expected ) );
+    CHECK( equal( deferred, expected ) );
+
+    pool.setInlineThreshold( ThreadPool::DefaultInlineThreshold );
+}
+
+int main()
+{
+    Test::run( "cullConvention", cullConvention );
+    Test::run( "badIndices", badIndices );
+    Test::run( "binnedTriangles", binnedTriangles );
+
+    return Test::result();
+}
@@ -0,0 +1,146 @@
+// Tests for the lock-free multi-producer single-consumer window event queue.
+#include "Test.hpp"
+
+#include "EventQueue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Graphics;
+
+// Producers tag their events with their index (x) and a sequence number (y).
+static Event makeEvent( int producer, int sequence )
+{
+    Event event {};
+    event.type        = Event::MouseMoved;
+    event.mouseMove.x = producer;
+    event.mouseMove.y = sequence;
+
+    return event;
+}
+
+static void capacity()
+{
+    CHECK( EventQueue { 0 }.capacity() == 2 );
+    CHECK( EventQueue { 3 }.capacity() == 4 );
+    CHECK( EventQueue { 1024 }.capacity() == 1024 );
+    CHECK( EventQueue {}.capacity() == EventQueue::DefaultCapacity );
+}
+
+static void fifo()
+{
+    EventQueue queue { 4 };
+    Event      event;
+
+    CHECK( queue.empty() );
+    CHECK( !queue.pop( event ) );
+
+    // Wrap around the ring a few times.
+    int pushed = 0;
+    int popped = 0;
+    for ( int round = 0; round < 10; ++round )
+    {
+        for ( int i = 0; i < 3; ++i )
+            CHECK( queue.push( makeEvent( 0, pushed++ ) ) );
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            CHECK( queue.pop( event ) );
+            CHECK( event.type == Event::MouseMoved );
+            CHECK( event.mouseMove.y == popped++ );
+        }
+
+        CHECK( queue.empty() );
+    }
+}
+
+static void full()
+{
+    EventQueue queue { 4 };
+
+    for ( int i = 0; i < 4; ++i )
+        CHECK( queue.push( makeEvent( 0, i ) ) );
+
+    CHECK( !queue.push( makeEvent( 0, 4 ) ) );
+    CHECK( !queue.push( makeEvent( 0, 5 ) ) );
+    CHECK( queue.getDroppedCount() == 2 );
+
+    // The events that were pushed are kept.
+    Event event;
+    for ( int i = 0; i < 4; ++i )
+    {
+        CHECK( queue.pop( event ) );
+        CHECK( event.mouseMove.y == i );
+    }
+
+    CHECK( !queue.pop( event ) );
+    CHECK( queue.push( makeEvent( 0, 6 ) ) );
+}
+
+static void concurrentProducers()
+{
+    constexpr int NumProducers = 4;
+    constexpr int NumEvents    = 100000;
+
+    // A small queue, so the producers often find it full and have to retry.
+    EventQueue       queue { 64 };
+    std::atomic<int> started = 0;
+
+    std::vector<std::thread> producers;
+    for ( int p = 0; p < NumProducers; ++p )
+    {
+        producers.emplace_back( [&queue, &started, p] {
+            ++started;
+            while ( started < NumProducers )
+                std::this_thread::yield();
+
+            for ( int i = 0; i < NumEvents; ++i )
+            {
+                while ( !queue.push( makeEvent( p, i ) ) )
+                    std::this_thread::yield();
+            }
+        } );
+    }
+
+    // Every event is received exactly once, and the events of each producer are received in order.
+    std::vector<int> next( NumProducers, 0 );
+    int              received  = 0;
+    bool             corrupted = false;
+    Event            event;
+
+    while ( received < NumProducers * NumEvents )
+    {
+        if ( !queue.pop( event ) )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Keep draining the queue after an error, so the producers can finish.
+        const int p = event.mouseMove.x;
+        if ( event.type == Event::MouseMoved && p >= 0 && p < NumProducers && event.mouseMove.y == next[p] )
+            ++next[p];
+        else
+            corrupted = true;
+
+        ++received;
+    }
+
+    for ( auto& producer: producers )
+        producer.join();
+
+    CHECK( !corrupted );
+    CHECK( received == NumProducers * NumEvents );
+    CHECK( queue.empty() );
+}
+
+int main()
+{
+    Test::run( "capacity", capacity );
+    Test::run( "fifo", fifo );
+    Test::run( "full", full );
+    Test::run( "concurrentProducers", concurrentProducers );
+
+    return Test::result();
+}
@@ -0,0 +1,225 @@
+// Tests for loading resources asynchronously with the ResourceManager: concurrent requests for the same resource
+// share a single load, loads that fail are reported and can be retried, and completion callbacks are invoked by
+// ResourceManager::update on the calling thread.
+#include "Test.hpp"
+
+#include <Graphics/ResourceManager.hpp>
+#include <Graphics/TextureFile.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace Graphics;
+
+namespace fs = std::filesystem;
+
+static const fs::path g_Dir  = fs::temp_directory_path() / "sr_ResourceManagerTests";
+static const fs::path g_Font = fs::path { SR_ASSETS_DIR } / "fonts/arial.ttf";
+
+static fs::path writeTexture( const char* name, uint32_t width, uint32_t height )
+{
+    Image image { width, height };
+    image.clear( Color { 0, 128, 255 } );
+
+    const fs::path file = g_Dir / name;
+    CHECK( TextureFile::write( file, image ) );
+
+    return file;
+}
+
+// Invoke func from several threads at the same time and return the results.
+template<typename Func>
+static auto fromThreads( int numThreads, Func&& func )
+{
+    std::vector<decltype( func() )> results( numThreads );
+    std::vector<std::thread>        threads;
+    std::atomic<int>                started = 0;
+
+    for ( int i = 0; i < numThreads; ++i )
+    {
+        threads.emplace_back( [&, i] {
+            ++started;
+            while ( started < numThreads )
+                std::this_thread::yield();
+
+            results[i] = func();
+        } );
+    }
+
+    for ( auto& thread: threads )
+        thread.join();
+
+    return results;
+}
+
+static void sharedImageLoads()
+{
+    ResourceManager::clear();
+
+    const fs::path file   = writeTexture( "shared.srtex", 16, 8 );
+    const auto     before = ResourceManager::getStatistics();
+
+    const auto futures = fromThreads( 8, [&] { return ResourceManager::loadImageAsync( file ); } );
+    ResourceManager::waitIdle();
+
+    const auto image = futures[0].get();
+    if ( !CHECK( image && *image ) )
+        return;
+
+    CHECK( image->getWidth() == 16 );
+
+    for ( const auto& future: futures )
+        CHECK( future.get() == image );
+
+    // Only the first request loads the image.
+    const auto after = ResourceManager::getStatistics();
+    CHECK( after.misses - before.misses == 1 );
+    CHECK( after.hits - before.hits == 7 );
+    CHECK( after.numImages == 1 );
+
+    // Synchronous requests find the same image.
+    CHECK( ResourceManager::loadImage( file ) == image );
+}
+
+static void sharedFontLoads()
+{
+    ResourceManager::clear();
+
+    const auto futures = fromThreads( 8, [] { return ResourceManager::loadFontAsync( g_Font, 20.0f ); } );
+    const auto other   = ResourceManager::loadFontAsync( g_Font, 30.0f );
+    ResourceManager::waitIdle();
+
+    const auto font = futures[0].get();
+    if ( !CHECK( font ) )
+        return;
+
+    for ( const auto& future: futures )
+        CHECK( future.get() == font );
+
+    // A different size is a different font, but it shares the font file.
+    CHECK( other.get() && other.get() != font );
+    CHECK( ResourceManager::getStatistics().numFonts == 2 );
+
+    int numFontFiles = 0;
+    for ( const auto& asset: ResourceManager::getAssetStatistics() )
+        numFontFiles += asset.filePath == g_Font;
+
+    CHECK( numFontFiles == 1 );
+}
+
+static void failedLoads()
+{
+    ResourceManager::clear();
+
+    const fs::path file = g_Dir / "later.srtex";
+    fs::remove( file );
+
+    // The failed load is reported as nullptr, to the future and the callback.
+    int  calls  = 0;
+    bool isNull = false;
+    auto future = ResourceManager::loadImageAsync( file, [&]( std::shared_ptr<Image> image ) {
+        ++calls;
+        isNull = image == nullptr;
+    } );
+    ResourceManager::waitIdle();
+    ResourceManager::update();
+
+    CHECK( future.get() == nullptr );
+    CHECK( calls == 1 && isNull );
+
+    // The failed image isn't cached, so the next request retries.
+    CHECK( ResourceManager::getStatistics().numImages == 0 );
+
+    writeTexture( "later.srtex", 4, 4 );
+
+    auto image = ResourceManager::loadImageAsync( file ).get();
+    CHECK( image && image->getWidth() == 4 );
+
+    // Synchronous loads return an empty image, which isn't cached either.
+    const fs::path missing = g_Dir / "missing.srtex";
+
+    const auto empty = ResourceManager::loadImage( missing );
+    CHECK( empty && !*empty );
+    CHECK( ResourceManager::loadImage( missing ) != empty );
+
+    // Fonts that can't be loaded are also reported as nullptr and retried.
+    CHECK( ResourceManager::loadFontAsync( g_Dir / "missing.ttf" ).get() == nullptr );
+    ResourceManager::waitIdle();
+    CHECK( ResourceManager::getStatistics().numFonts == 0 );
+}
+
+static void callbacksOnUpdate()
+{
+    ResourceManager::clear();
+
+    const fs::path file = writeTexture( "callback.srtex", 8, 8 );
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+
+    int             calls = 0;
+    std::thread::id callbackThread;
+
+    auto onLoaded = [&]( std::shared_ptr<Image> image ) {
+        ++calls;
+        callbackThread = std::this_thread::get_id();
+        CHECK( image && image->getWidth() == 8 );
+    };
+
+    ResourceManager::loadImageAsync( file, onLoaded );
+    ResourceManager::waitIdle();
+
+    // The image is loaded, but the callback waits for update.
+    CHECK( calls == 0 );
+
+    ResourceManager::update();
+    CHECK( calls == 1 );
+    CHECK( callbackThread == mainThread );
+
+    ResourceManager::update();
+    CHECK( calls == 1 );
+
+    // Callbacks of resources that are already loaded are also invoked by update.
+    ResourceManager::loadImageAsync( file, onLoaded );
+    CHECK( calls == 1 );
+
+    ResourceManager::update();
+    CHECK( calls == 2 );
+    CHECK( callbackThread == mainThread );
+}
+
+static void loadFromCallback()
+{
+    ResourceManager::clear();
+
+    const fs::path first  = writeTexture( "first.srtex", 2, 2 );
+    const fs::path second = writeTexture( "second.srtex", 3, 3 );
+
+    // Callbacks can load more resources (update doesn't hold a lock while invoking them).
+    std::shared_ptr<Image> loaded;
+    ResourceManager::loadImageAsync( first, [&]( std::shared_ptr<Image> ) { loaded = ResourceManager::loadImage( second ); } );
+    ResourceManager::waitIdle();
+    ResourceManager::update();
+
+    CHECK( loaded && loaded->getWidth() == 3 );
+}
+
+int main()
+{
+    fs::create_directories( g_Dir );
+
+    Test::run( "sharedImageLoads", sharedImageLoads );
+    Test::run( "sharedFontLoads", sharedFontLoads );
+    Test::run( "failedLoads", failedLoads );
+    Test::run( "callbacksOnUpdate", callbacksOnUpdate );
+    Test::run( "loadFromCallback", loadFromCallback );
+
+    // Release the (memory-mapped) images before removing the files.
+    ResourceManager::clear();
+
+    std::error_code ec;
+    fs::remove_all( g_Dir, ec );
+
+    return Test::result();
+}
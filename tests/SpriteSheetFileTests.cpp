@@ -0,0 +1,224 @@
+// Tests for the index files (.srsheet) of packed sprite sheets, and for loading packed sprite sheets with
+// corrupt indices or sprites that are outside of their page.
+#include "Test.hpp"
+
+#include <Graphics/ResourceManager.hpp>
+#include <Graphics/SpriteSheet.hpp>
+#include <Graphics/SpriteSheetFile.hpp>
+#include <Graphics/TextureFile.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Graphics;
+
+namespace fs = std::filesystem;
+
+// The offsets of the header fields and the size of a sprite record (see SpriteSheetFile.cpp).
+constexpr size_t MagicOffset      = 0;
+constexpr size_t NumSpritesOffset = 12;
+constexpr size_t HeaderSize       = 32;
+constexpr size_t SpriteSize       = 48;
+
+static const fs::path g_Dir = fs::temp_directory_path() / "sr_SpriteSheetFileTests";
+
+static std::vector<char> readBytes( const fs::path& file )
+{
+    std::ifstream in( file, std::ios::binary );
+    return { std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() };
+}
+
+static void writeBytes( const fs::path& file, const std::vector<char>& bytes )
+{
+    std::ofstream out( file, std::ios::binary | std::ios::trunc );
+    out.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+template<typename T>
+static void patch( std::vector<char>& bytes, size_t offset, T value )
+{
+    std::memcpy( bytes.data() + offset, &value, sizeof( value ) );
+}
+
+// An 8x8 page with two 4x4 sprites and an animation.
+static SpriteSheetFile::Index makeIndex()
+{
+    SpriteSheetFile::Index index;
+    index.pages = { "page.srtex" };
+
+    SpriteSheetFile::Sprite a;
+    a.name       = "a";
+    a.rect       = { 0, 0, 4, 4 };
+    a.offset     = { 1, 2 };
+    a.sourceSize = { 6, 6 };
+    a.pivot      = { 3.0f, 3.0f };
+
+    SpriteSheetFile::Sprite b;
+    b.name       = "b";
+    b.rect       = { 4, 4, 4, 4 };
+    b.sourceSize = { 4, 4 };
+
+    index.sprites    = { a, b };
+    index.animations = { { "anim", { 0, 1, 0 } } };
+
+    return index;
+}
+
+static fs::path writeIndex( const char* name, const SpriteSheetFile::Index& index )
+{
+    const fs::path file = g_Dir / name;
+    CHECK( SpriteSheetFile::write( file, index ) );
+
+    return file;
+}
+
+// Copy the valid index, let the function modify the bytes, and check that the modified file is rejected.
+template<typename Func>
+static void checkRejected( const char* name, Func&& modify )
+{
+    std::vector<char> bytes = readBytes( writeIndex( "valid.srsheet", makeIndex() ) );
+    modify( bytes );
+
+    const fs::path file = g_Dir / name;
+    writeBytes( file, bytes );
+
+    SpriteSheetFile::Index index;
+    CHECK( !SpriteSheetFile::read( file, index ) );
+    CHECK( !SpriteSheet::fromPacked( file ) );
+}
+
+static void roundTrip()
+{
+    const SpriteSheetFile::Index expected = makeIndex();
+    const fs::path               file     = writeIndex( "roundtrip.srsheet", expected );
+
+    SpriteSheetFile::Index index;
+    if ( !CHECK( SpriteSheetFile::read( file, index ) ) )
+        return;
+
+    CHECK( index.pages == expected.pages );
+
+    if ( CHECK( index.sprites.size() == expected.sprites.size() ) )
+    {
+        for ( size_t i = 0; i < index.sprites.size(); ++i )
+        {
+            const auto& s = index.sprites[i];
+            const auto& e = expected.sprites[i];
+
+            CHECK( s.name == e.name );
+            CHECK( s.page == e.page );
+            CHECK( s.rect.left == e.rect.left && s.rect.top == e.rect.top && s.rect.width == e.rect.width && s.rect.height == e.rect.height );
+            CHECK( s.offset == e.offset );
+            CHECK( s.sourceSize == e.sourceSize );
+            CHECK( s.pivot == e.pivot );
+        }
+    }
+
+    if ( CHECK( index.animations.size() == 1 ) )
+    {
+        CHECK( index.animations[0].name == "anim" );
+        CHECK( index.animations[0].frames == expected.animations[0].frames );
+    }
+}
+
+static void loadPacked()
+{
+    const auto spriteSheet = SpriteSheet::fromPacked( writeIndex( "packed.srsheet", makeIndex() ) );
+    if ( !CHECK( spriteSheet ) )
+        return;
+
+    CHECK( spriteSheet->getNumSprites() == 2 );
+    CHECK( spriteSheet->findSprite( "b" ) == 1 );
+    CHECK( spriteSheet->findSprite( "c" ) < 0 );
+    CHECK( spriteSheet->getAnimation( "anim" ).size() == 3 );
+}
+
+static void missingFile()
+{
+    SpriteSheetFile::Index index;
+    CHECK( !SpriteSheetFile::read( g_Dir / "missing.srsheet", index ) );
+    CHECK( !SpriteSheet::fromPacked( g_Dir / "missing.srsheet" ) );
+}
+
+static void truncated()
+{
+    checkRejected( "truncated_header.srsheet", []( std::vector<char>& bytes ) { bytes.resize( 16 ); } );
+    checkRejected( "truncated.srsheet", []( std::vector<char>& bytes ) { bytes.pop_back(); } );
+}
+
+static void badMagic()
+{
+    checkRejected( "bad_magic.srsheet", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, MagicOffset, 0x12345678u ); } );
+}
+
+static void oversizedCounts()
+{
+    // The number of sprites doesn't match the size of the file.
+    checkRejected( "sprite_count.srsheet", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, NumSpritesOffset, 3u ); } );
+    checkRejected( "sprite_count_huge.srsheet", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, NumSpritesOffset, 0xffffffffu ); } );
+}
+
+static void badSpriteRecord()
+{
+    // The first sprite record follows the header and the page (a single name offset).
+    constexpr size_t SpriteOffset = HeaderSize + sizeof( uint32_t );
+
+    checkRejected( "bad_page.srsheet", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, SpriteOffset + 4, 1u ); } );
+    checkRejected( "bad_name.srsheet", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, SpriteOffset + SpriteSize, 0xffffu ); } );
+}
+
+static void unterminatedStrings()
+{
+    checkRejected( "unterminated.srsheet", []( std::vector<char>& bytes ) { bytes.back() = 'x'; } );
+}
+
+static void spriteOutsideOfPage()
+{
+    auto index = makeIndex();
+    index.sprites[1].rect = { 6, 6, 4, 4 };
+    CHECK( !SpriteSheet::fromPacked( writeIndex( "outside.srsheet", index ) ) );
+
+    index                 = makeIndex();
+    index.sprites[0].rect = { -1, 0, 4, 4 };
+    CHECK( !SpriteSheet::fromPacked( writeIndex( "negative_position.srsheet", index ) ) );
+
+    index                 = makeIndex();
+    index.sprites[0].rect = { 4, 0, -4, 4 };
+    CHECK( !SpriteSheet::fromPacked( writeIndex( "negative_size.srsheet", index ) ) );
+
+    // left + width overflows 32 bits.
+    index                 = makeIndex();
+    index.sprites[0].rect = { 4, 0, 0x7fffffff, 4 };
+    CHECK( !SpriteSheet::fromPacked( writeIndex( "overflow.srsheet", index ) ) );
+}
+
+int main()
+{
+    fs::create_directories( g_Dir );
+
+    Image page { 8, 8 };
+    page.clear( Color { 255, 0, 0 } );
+    TextureFile::write( g_Dir / "page.srtex", page );
+
+    Test::run( "roundTrip", roundTrip );
+    Test::run( "loadPacked", loadPacked );
+    Test::run( "missingFile", missingFile );
+    Test::run( "truncated", truncated );
+    Test::run( "badMagic", badMagic );
+    Test::run( "oversizedCounts", oversizedCounts );
+    Test::run( "badSpriteRecord", badSpriteRecord );
+    Test::run( "unterminatedStrings", unterminatedStrings );
+    Test::run( "spriteOutsideOfPage", spriteOutsideOfPage );
+
+    // Release the (memory-mapped) page before removing the files.
+    ResourceManager::clear();
+
+    std::error_code ec;
+    fs::remove_all( g_Dir, ec );
+
+    return Test::result();
+}
@@ -0,0 +1,47 @@
+// A minimal test harness: each test executable runs its test functions from main()
+// and returns a non-zero exit code if any check failed (which is what CTest reports).
+#pragma once
+
+#include <atomic>
+#include <iostream>
+
+namespace Test
+{
+// Checks can fail on any thread.
+inline std::atomic<int> g_Failures = 0;
+
+/// <summary>
+/// Report the result of a check. Failed checks are counted and written to the standard error.
+/// </summary>
+inline bool check( bool passed, const char* expr, const char* file, int line )
+{
+    if ( !passed )
+    {
+        std::cerr << file << "(" << line << "): CHECK failed: " << expr << std::endl;
+        ++g_Failures;
+    }
+
+    return passed;
+}
+
+/// <summary>
+/// Run a test function and report its name.
+/// </summary>
+template<typename Func>
+void run( const char* name, Func&& func )
+{
+    const int failures = g_Failures;
+    func();
+    std::cout << ( g_Failures == failures ? "[PASS] " : "[FAIL] " ) << name << std::endl;
+}
+
+/// <summary>
+/// The exit code of the test executable.
+/// </summary>
+inline int result()
+{
+    return g_Failures == 0 ? 0 : 1;
+}
+}  // namespace Test
+
+#define CHECK( expr ) ::Test::check( static_cast<bool>( expr ), #expr, __FILE__, __LINE__ )
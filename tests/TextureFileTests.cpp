@@ -0,0 +1,189 @@
+// Tests for reading and writing texture files (.srtex), including files with corrupt or oversized headers.
+#include "Test.hpp"
+
+#include <Graphics/TextureFile.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Graphics;
+
+namespace fs = std::filesystem;
+
+// The offsets of the header fields (see TextureFile.cpp).
+constexpr size_t MagicOffset       = 0;
+constexpr size_t VersionOffset     = 4;
+constexpr size_t WidthOffset       = 8;
+constexpr size_t HeightOffset      = 12;
+constexpr size_t PixelOffsetOffset = 16;
+constexpr size_t RectOffsetOffset  = 24;
+constexpr size_t NumRectsOffset    = 32;
+
+static const fs::path g_Dir = fs::temp_directory_path() / "sr_TextureFileTests";
+
+static std::vector<char> readBytes( const fs::path& file )
+{
+    std::ifstream in( file, std::ios::binary );
+    return { std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() };
+}
+
+static void writeBytes( const fs::path& file, const std::vector<char>& bytes )
+{
+    std::ofstream out( file, std::ios::binary | std::ios::trunc );
+    out.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+template<typename T>
+static void patch( std::vector<char>& bytes, size_t offset, T value )
+{
+    std::memcpy( bytes.data() + offset, &value, sizeof( value ) );
+}
+
+// Write a valid 3x2 texture with a single rect.
+static fs::path writeTexture( const char* name )
+{
+    Image image { 3, 2 };
+    for ( uint32_t i = 0; i < 6; ++i )
+        image.data()[i] = Color { static_cast<uint8_t>( i ), static_cast<uint8_t>( i * 2 ), static_cast<uint8_t>( i * 3 ) };
+
+    const Math::RectI rects[] = { { 1, 2, 3, 4 } };
+
+    const fs::path file = g_Dir / name;
+    CHECK( TextureFile::write( file, image, rects ) );
+
+    return file;
+}
+
+// Copy the valid texture, let the function modify the bytes, and check that the modified file is rejected.
+template<typename Func>
+static void checkRejected( const char* name, Func&& modify )
+{
+    std::vector<char> bytes = readBytes( writeTexture( "valid.srtex" ) );
+    modify( bytes );
+
+    const fs::path file = g_Dir / name;
+    writeBytes( file, bytes );
+
+    std::vector<Math::RectI> rects;
+    const Image              image = TextureFile::load( file, &rects );
+
+    CHECK( !image );
+    CHECK( rects.empty() );
+}
+
+static void roundTrip()
+{
+    const fs::path file = writeTexture( "roundtrip.srtex" );
+
+    std::vector<Math::RectI> rects;
+    const Image              image = TextureFile::load( file, &rects );
+
+    if ( !CHECK( image ) )
+        return;
+
+    CHECK( image.getWidth() == 3 );
+    CHECK( image.getHeight() == 2 );
+    CHECK( !image.ownsData() );
+
+    for ( uint32_t i = 0; i < 6; ++i )
+        CHECK( image.data()[i] == ( Color { static_cast<uint8_t>( i ), static_cast<uint8_t>( i * 2 ), static_cast<uint8_t>( i * 3 ) } ) );
+
+    if ( CHECK( rects.size() == 1 ) )
+    {
+        CHECK( rects[0].left == 1 );
+        CHECK( rects[0].top == 2 );
+        CHECK( rects[0].width == 3 );
+        CHECK( rects[0].height == 4 );
+    }
+}
+
+static void missingFile()
+{
+    CHECK( !TextureFile::load( g_Dir / "missing.srtex" ) );
+}
+
+static void truncatedHeader()
+{
+    checkRejected( "truncated_header.srtex", []( std::vector<char>& bytes ) { bytes.resize( 10 ); } );
+}
+
+static void truncatedPixels()
+{
+    checkRejected( "truncated_pixels.srtex", []( std::vector<char>& bytes ) {
+        bytes.resize( 64 + 5 * sizeof( Color ) );
+        patch<uint64_t>( bytes, RectOffsetOffset, bytes.size() );
+        patch<uint32_t>( bytes, NumRectsOffset, 0u );
+    } );
+}
+
+static void badMagic()
+{
+    checkRejected( "bad_magic.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, MagicOffset, 0x12345678u ); } );
+}
+
+static void badVersion()
+{
+    checkRejected( "bad_version.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, VersionOffset, TextureFile::Version + 1 ); } );
+}
+
+static void zeroSize()
+{
+    checkRejected( "zero_width.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, WidthOffset, 0u ); } );
+    checkRejected( "zero_height.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, HeightOffset, 0u ); } );
+}
+
+static void oversizedDimensions()
+{
+    // width * height * sizeof( Color ) wraps around to 0 in 64 bits.
+    checkRejected( "overflow.srtex", []( std::vector<char>& bytes ) {
+        patch<uint32_t>( bytes, WidthOffset, 0x80000000u );
+        patch<uint32_t>( bytes, HeightOffset, 0x80000000u );
+    } );
+
+    // Doesn't overflow, but is larger than the file.
+    checkRejected( "oversized.srtex", []( std::vector<char>& bytes ) {
+        patch<uint32_t>( bytes, WidthOffset, 65536u );
+        patch<uint32_t>( bytes, HeightOffset, 65536u );
+    } );
+
+    checkRejected( "oversized_width.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, WidthOffset, 0xffffffffu ); } );
+}
+
+static void badPixelOffset()
+{
+    checkRejected( "pixels_past_end.srtex", []( std::vector<char>& bytes ) { patch<uint64_t>( bytes, PixelOffsetOffset, bytes.size() + 64 ); } );
+    checkRejected( "pixels_huge_offset.srtex", []( std::vector<char>& bytes ) { patch<uint64_t>( bytes, PixelOffsetOffset, ~uint64_t { 0 } - 3 ); } );
+    checkRejected( "pixels_unaligned.srtex", []( std::vector<char>& bytes ) { patch<uint64_t>( bytes, PixelOffsetOffset, 65u ); } );
+}
+
+static void badRects()
+{
+    checkRejected( "rects_past_end.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, NumRectsOffset, 2u ); } );
+    checkRejected( "rects_huge_count.srtex", []( std::vector<char>& bytes ) { patch<uint32_t>( bytes, NumRectsOffset, 0xffffffffu ); } );
+    checkRejected( "rects_huge_offset.srtex", []( std::vector<char>& bytes ) { patch<uint64_t>( bytes, RectOffsetOffset, ~uint64_t { 0 } - 8 ); } );
+}
+
+int main()
+{
+    fs::create_directories( g_Dir );
+
+    Test::run( "roundTrip", roundTrip );
+    Test::run( "missingFile", missingFile );
+    Test::run( "truncatedHeader", truncatedHeader );
+    Test::run( "truncatedPixels", truncatedPixels );
+    Test::run( "badMagic", badMagic );
+    Test::run( "badVersion", badVersion );
+    Test::run( "zeroSize", zeroSize );
+    Test::run( "oversizedDimensions", oversizedDimensions );
+    Test::run( "badPixelOffset", badPixelOffset );
+    Test::run( "badRects", badRects );
+
+    std::error_code ec;
+    fs::remove_all( g_Dir, ec );
+
+    return Test::result();
+}
@@ -0,0 +1,206 @@
+// Tests for the tiled texture layout (Image::setTextureLayout): converting the pixels, and drawing with a tiled texture,
+// which must give the same result as drawing with the same texture in the linear layout.
+#include "Test.hpp"
+
+#include <Graphics/DepthBuffer.hpp>
+#include <Graphics/Image.hpp>
+#include <Graphics/Sprite.hpp>
+#include <Graphics/SpriteBatch.hpp>
+#include <Graphics/TextureFile.hpp>
+
+#include <Math/Transform2D.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <random>
+
+using namespace Graphics;
+
+namespace fs = std::filesystem;
+
+static bool equal( const Image& a, const Image& b )
+{
+    return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+           std::memcmp( a.data(), b.data(), static_cast<size_t>( a.getWidth() ) * a.getHeight() * sizeof( Color ) ) == 0;
+}
+
+// Compare the texels of two images (in any layout).
+static bool equalTexels( const Image& a, const Image& b )
+{
+    if ( a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() )
+        return false;
+
+    for ( uint32_t y = 0; y < a.getHeight(); ++y )
+    {
+        for ( uint32_t x = 0; x < a.getWidth(); ++x )
+        {
+            if ( a.texel( x, y ) != b.texel( x, y ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// An image with random pixels (the size is not a multiple of the block size).
+static std::shared_ptr<Image> createTexture( uint32_t width, uint32_t height )
+{
+    std::mt19937                            rng { 7 };
+    std::uniform_int_distribution<uint32_t> dist;
+
+    auto texture = std::make_shared<Image>( width, height );
+    for ( uint32_t i = 0; i < width * height; ++i )
+        texture->data()[i] = Color { dist( rng ) };
+
+    return texture;
+}
+
+static void conversion()
+{
+    const auto linear = createTexture( 13, 7 );
+
+    Image tiled { *linear };
+    tiled.setTextureLayout( TextureLayout::Tiled );
+
+    CHECK( tiled.getTextureLayout() == TextureLayout::Tiled );
+    CHECK( equalTexels( tiled, *linear ) );
+    CHECK( tiled.sample( 14, -1, AddressMode::Wrap ) == ( *linear )( 1, 6 ) );
+
+    // Copies keep the layout.
+    const Image copy { tiled };
+    CHECK( copy.getTextureLayout() == TextureLayout::Tiled );
+    CHECK( equalTexels( copy, *linear ) );
+
+    // The mip levels are converted with the image.
+    CHECK( tiled.getMipLevel( 1 ).getTextureLayout() == TextureLayout::Tiled );
+    CHECK( equalTexels( tiled.getMipLevel( 1 ), linear->getMipLevel( 1 ) ) );
+
+    tiled.setTextureLayout( TextureLayout::Linear );
+    CHECK( tiled.getTextureLayout() == TextureLayout::Linear );
+    CHECK( tiled.getMipLevel( 2 ).getTextureLayout() == TextureLayout::Linear );
+    CHECK( equal( tiled, *linear ) );
+
+    // Resizing a tiled image gives a linear image.
+    Image resized { copy };
+    resized.resize( 13, 7 );
+    CHECK( resized.getTextureLayout() == TextureLayout::Linear );
+}
+
+static void textureFile()
+{
+    const fs::path dir = fs::temp_directory_path() / "sr_TextureLayoutTests";
+    fs::create_directories( dir );
+
+    const auto linear = createTexture( 9, 6 );
+
+    Image tiled { *linear };
+    tiled.setTextureLayout( TextureLayout::Tiled );
+
+    // Tiled images are written in rows.
+    const fs::path file = dir / "tiled.srtex";
+    CHECK( TextureFile::write( file, tiled ) );
+
+    const Image loaded = TextureFile::load( file );
+    CHECK( equal( loaded, *linear ) );
+
+    fs::remove_all( dir );
+}
+
+// Draw with the texture in both layouts, and check that the results are the same.
+static void checkDraw( const char* name, const std::function<void( Image& image, const std::shared_ptr<Image>& texture )>& draw )
+{
+    const auto linear = createTexture( 37, 29 );
+    const auto tiled  = std::make_shared<Image>( *linear );
+    tiled->setTextureLayout( TextureLayout::Tiled );
+
+    for ( const bool deferred: { false, true } )
+    {
+        Image expected { 160, 120 };
+        Image actual { 160, 120 };
+
+        for ( auto [image, texture]: { std::pair { &expected, linear }, std::pair { &actual, tiled } } )
+        {
+            image->clear( Color::Black );
+
+            if ( deferred )
+                image->beginDeferred( 32 );
+
+            draw( *image, texture );
+
+            if ( deferred )
+                image->endDeferred();
+        }
+
+        if ( !CHECK( equal( actual, expected ) ) )
+            std::cerr << "  " << name << ( deferred ? " (deferred)" : "" ) << std::endl;
+    }
+}
+
+static void draws()
+{
+    const Math::Transform2D rotated { { 80.0f, 60.0f }, { 2.5f, 1.5f }, 0.6f };
+    const Math::Transform2D scaled { { 10.5f, 7.25f }, { 3.3f, 2.7f }, 0.0f };
+
+    for ( const FilterMode filterMode: { FilterMode::Point, FilterMode::Bilinear, FilterMode::Trilinear } )
+    {
+        checkDraw( "drawQuad", [&]( Image& image, const std::shared_ptr<Image>& texture ) {
+            image.drawQuad( { { 20, 5 }, { -0.5f, -0.5f } }, { { 150, 30 }, { 2.0f, -0.2f } }, { { 130, 115 }, { 2.3f, 1.5f } }, { { 5, 90 }, { 0.1f, 1.9f } }, *texture, AddressMode::Mirror, BlendMode::AlphaBlend, filterMode );
+        } );
+
+        checkDraw( "drawSprite", [&]( Image& image, const std::shared_ptr<Image>& texture ) {
+            Sprite sprite { texture, Math::RectI { 3, 2, 30, 25 }, BlendMode::AlphaBlend };
+            sprite.setFilterMode( filterMode );
+
+            image.drawSprite( sprite, rotated );
+            image.drawSprite( sprite, scaled );
+        } );
+
+        checkDraw( "SpriteBatch", [&]( Image& image, const std::shared_ptr<Image>& texture ) {
+            Sprite sprite { texture, Math::RectI { 3, 2, 30, 25 }, BlendMode::AlphaBlend };
+            sprite.setFilterMode( filterMode );
+
+            SpriteBatch batch;
+            batch.draw( sprite, rotated );
+            batch.draw( sprite, scaled );
+            batch.render( image );
+        } );
+    }
+
+    checkDraw( "drawSprite (unscaled)", []( Image& image, const std::shared_ptr<Image>& texture ) {
+        const Sprite sprite { texture, Math::RectI { 1, 2, 33, 26 }, BlendMode::AlphaBlend };
+        image.drawSprite( sprite, -3, 50 );
+        image.drawSprite( sprite, 61, 17 );
+    } );
+
+    checkDraw( "copy", []( Image& image, const std::shared_ptr<Image>& texture ) {
+        image.copy( *texture, 5, -2 );
+        image.copy( *texture, Math::RectI { 1, 3, 30, 20 }, Math::RectI { 50, 10, 30, 20 }, BlendMode::AlphaBlend );
+        image.copy( *texture, Math::RectI { 1, 3, 30, 20 }, Math::RectI { 90, 40, 67, 51 }, BlendMode::AlphaBlend );
+    } );
+
+    checkDraw( "drawIndexed", []( Image& image, const std::shared_ptr<Image>& texture ) {
+        const Vertex   vertices[] = { { { 10, 10 }, { -0.3f, 0.1f } }, { { 150, 20 }, { 1.7f, -0.4f } }, { { 140, 110 }, { 2.1f, 1.8f } }, { { 15, 100 }, { 0.2f, 1.3f } } };
+        const uint32_t indices[]  = { 0, 1, 2, 0, 2, 3 };
+        image.drawIndexed( vertices, indices, texture.get(), BlendMode::AlphaBlend );
+    } );
+
+    // The depth buffer must outlive the deferred draws.
+    DepthBuffer depthBuffer { 160, 120 };
+
+    checkDraw( "drawTriangle (3D)", [&]( Image& image, const std::shared_ptr<Image>& texture ) {
+        depthBuffer.clear();
+        image.drawTriangle( { { -0.9f, -0.9f, 0.5f, 1.0f }, { 0.0f, 0.0f } }, { { 1.8f, -1.8f, 0.5f, 2.0f }, { 3.0f, 0.0f } }, { { 0.0f, 0.9f, 0.5f, 1.0f }, { 0.0f, 2.0f } }, depthBuffer, *texture, AddressMode::Wrap );
+    } );
+}
+
+int main()
+{
+    Test::run( "conversion", conversion );
+    Test::run( "textureFile", textureFile );
+    Test::run( "draws", draws );
+
+    return Test::result();
+}
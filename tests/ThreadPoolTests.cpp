@@ -0,0 +1,225 @@
+// Tests for the work-stealing thread pool that runs the parallel image kernels.
+#include "Test.hpp"
+
+#include <Graphics/ThreadPool.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Graphics;
+
+// Run a loop and check that every iteration is executed exactly once.
+static void checkCoverage( ThreadPool& pool, int begin, int end, int64_t costPerItem = 1 )
+{
+    const int                           count    = end - begin;
+    std::unique_ptr<std::atomic<int>[]> visits   = std::make_unique<std::atomic<int>[]>( count );
+    std::atomic<bool>                   badRange = false;
+
+    pool.parallelFor(
+        begin, end,
+        [&]( int first, int last ) {
+            if ( first < begin || last > end || first >= last )
+                badRange = true;
+
+            for ( int i = first; i < last; ++i )
+                visits[i - begin].fetch_add( 1, std::memory_order_relaxed );
+        },
+        costPerItem );
+
+    int missed = 0;
+    for ( int i = 0; i < count; ++i )
+        missed += visits[i] != 1;
+
+    CHECK( !badRange );
+    CHECK( missed == 0 );
+}
+
+static void coverage()
+{
+    for ( const uint32_t numThreads: { 1u, 2u, 3u, 4u, 8u } )
+    {
+        ThreadPool pool { numThreads };
+        CHECK( pool.getNumThreads() == numThreads );
+
+        // Distribute every loop over the threads.
+        pool.setInlineThreshold( 0 );
+
+        checkCoverage( pool, 0, 1 );
+        checkCoverage( pool, 0, 7 );
+        checkCoverage( pool, -50, 50 );
+        checkCoverage( pool, 0, 100000 );
+        checkCoverage( pool, 10, 1000, 4096 );
+    }
+}
+
+static void emptyRange()
+{
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 0 );
+
+    bool called = false;
+    pool.parallelFor( 5, 5, [&]( int, int ) { called = true; } );
+    pool.parallelFor( 5, 0, [&]( int, int ) { called = true; } );
+
+    CHECK( !called );
+}
+
+static void inlineThreshold()
+{
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 1000 );
+
+    // Cheap loops are executed as a single range on the calling thread.
+    int               calls  = 0;
+    std::thread::id   thread = {};
+    std::vector<bool> ranges;
+
+    pool.parallelFor(
+        0, 100,
+        [&]( int first, int last ) {
+            ++calls;
+            thread = std::this_thread::get_id();
+            ranges.push_back( first == 0 && last == 100 );
+        },
+        10 );
+
+    CHECK( calls == 1 );
+    CHECK( thread == std::this_thread::get_id() );
+    CHECK( ranges.size() == 1 && ranges[0] );
+
+    pool.setInlineThreshold( -1 );
+    CHECK( pool.getInlineThreshold() == 0 );
+}
+
+static void unevenWork()
+{
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 0 );
+
+    // Most of the work is at the start of the range, so the other threads have to steal it.
+    constexpr int         Count = 256;
+    std::atomic<int>      visits[Count] {};
+    std::atomic<uint64_t> sink = 0;
+
+    pool.parallelFor( 0, Count, [&]( int first, int last ) {
+        for ( int i = first; i < last; ++i )
+        {
+            uint64_t x = i;
+            for ( int j = 0; j < ( i < Count / 4 ? 200000 : 10 ); ++j )
+                x = x * 6364136223846793005ull + 1442695040888963407ull;
+
+            sink += x;
+            ++visits[i];
+        }
+    } );
+
+    int missed = 0;
+    for ( const auto& v: visits )
+        missed += v != 1;
+
+    CHECK( missed == 0 );
+}
+
+static void nestedLoops()
+{
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 0 );
+
+    // Loops that are started from inside a parallel loop are executed on the calling thread.
+    constexpr int    Size = 64;
+    std::atomic<int> visits[Size * Size] {};
+
+    pool.parallelFor( 0, Size, [&]( int firstRow, int lastRow ) {
+        for ( int y = firstRow; y < lastRow; ++y )
+        {
+            pool.parallelFor( 0, Size, [&]( int first, int last ) {
+                for ( int x = first; x < last; ++x )
+                    ++visits[y * Size + x];
+            } );
+        }
+    } );
+
+    int missed = 0;
+    for ( const auto& v: visits )
+        missed += v != 1;
+
+    CHECK( missed == 0 );
+}
+
+static void manyLoops()
+{
+    // Start and finish many small loops in a row (the hand-off of jobs to the workers).
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 0 );
+
+    int64_t sum = 0;
+    for ( int loop = 0; loop < 2000; ++loop )
+    {
+        std::atomic<int64_t> loopSum = 0;
+        pool.parallelFor( 0, loop % 17 + 1, [&]( int first, int last ) {
+            for ( int i = first; i < last; ++i )
+                loopSum += i + 1;
+        } );
+
+        sum += loopSum;
+    }
+
+    int64_t expected = 0;
+    for ( int loop = 0; loop < 2000; ++loop )
+    {
+        const int64_t n = loop % 17 + 1;
+        expected += n * ( n + 1 ) / 2;
+    }
+
+    CHECK( sum == expected );
+}
+
+static void concurrentCallers()
+{
+    // Loops that are started from different threads at the same time share the pool.
+    ThreadPool pool { 4 };
+    pool.setInlineThreshold( 0 );
+
+    std::vector<std::thread> callers;
+    for ( int t = 0; t < 4; ++t )
+    {
+        callers.emplace_back( [&pool] {
+            for ( int i = 0; i < 50; ++i )
+                checkCoverage( pool, 0, 1000 );
+        } );
+    }
+
+    for ( auto& caller: callers )
+        caller.join();
+}
+
+static void setNumThreads()
+{
+    ThreadPool pool { 2 };
+    pool.setInlineThreshold( 0 );
+
+    for ( const uint32_t numThreads: { 4u, 1u, 3u } )
+    {
+        pool.setNumThreads( numThreads );
+        CHECK( pool.getNumThreads() == numThreads );
+
+        checkCoverage( pool, 0, 10000 );
+    }
+}
+
+int main()
+{
+    Test::run( "coverage", coverage );
+    Test::run( "emptyRange", emptyRange );
+    Test::run( "inlineThreshold", inlineThreshold );
+    Test::run( "unevenWork", unevenWork );
+    Test::run( "nestedLoops", nestedLoops );
+    Test::run( "manyLoops", manyLoops );
+    Test::run( "concurrentCallers", concurrentCallers );
+    Test::run( "setNumThreads", setNumThreads );
+
+    return Test::result();
+}
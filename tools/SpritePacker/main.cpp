@@ -0,0 +1,297 @@
+// Packs a directory of sprites and animations into atlas pages (.srtex) and an index file (.srsheet).
+// Load the result with SpriteSheet::fromPacked.
+//
+// Usage: SpritePacker [-s <max page size>] [-p <padding>] [-o <output directory>] [-n <name>] <input directory>
+//
+//   -s    The maximum width and height (in pixels) of a page. Default: 2048.
+//   -p    The space (in pixels) between the sprites on a page. Default: 1.
+//   -o    The directory to write the files to. Default: the current directory.
+//   -n    The name of the sprite sheet. Default: the name of the input directory.
+//
+// Every image in the input directory (recursively) becomes a sprite named after its path relative to the input directory
+// (without extension, with forward slashes). Images whose file name contains the frame size, for example
+// "Run (32x32).png", are split into animation frames: the frames are named "Run (32x32)/0", "Run (32x32)/1", ...
+// and an animation with the name of the image is added to the index.
+//
+// The transparent borders of the sprites are trimmed, and the pivot of each sprite is the center of its untrimmed frame.
+#include <Graphics/Image.hpp>
+#include <Graphics/SpriteSheetFile.hpp>
+#include <Graphics/TextureFile.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Graphics;
+
+// A sprite that still has to be packed.
+struct InputSprite
+{
+    std::string            name;
+    std::shared_ptr<Image> image;
+    Math::RectI            rect;  ///< The trimmed rectangle in the source image.
+    glm::ivec2             offset { 0 };
+    glm::ivec2             sourceSize { 0 };
+
+    // The position on the page.
+    uint32_t page = 0u;
+    int      x    = 0;
+    int      y    = 0;
+};
+
+static bool isImageFile( const fs::path& file )
+{
+    std::string extension = file.extension().string();
+    std::ranges::transform( extension, extension.begin(), []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+}
+
+// Parse the frame size from a file name like "Run (32x32)".
+static bool parseFrameSize( const std::string& name, int& width, int& height )
+{
+    const size_t open = name.rfind( '(' );
+    if ( open == std::string::npos )
+        return false;
+
+    char close = 0;
+    return std::sscanf( name.c_str() + open, "(%dx%d%c", &width, &height, &close ) == 3 && close == ')' && width > 0 && height > 0;
+}
+
+// Find the smallest rectangle in the frame that contains all of the non-transparent pixels.
+static Math::RectI trim( const Image& image, const Math::RectI& frame )
+{
+    int left = frame.right(), top = frame.bottom(), right = frame.left - 1, bottom = frame.top - 1;
+
+    for ( int y = frame.top; y < frame.bottom(); ++y )
+    {
+        for ( int x = frame.left; x < frame.right(); ++x )
+        {
+            if ( image( x, y ).a > 0 )
+            {
+                left   = std::min( left, x );
+                right  = std::max( right, x );
+                top    = std::min( top, y );
+                bottom = std::max( bottom, y );
+            }
+        }
+    }
+
+    // Keep a single pixel of fully transparent sprites, so every frame has a sprite.
+    if ( right < left )
+        return { frame.left, frame.top, 1, 1 };
+
+    return { left, top, right - left + 1, bottom - top + 1 };
+}
+
+// Shelf-pack the sprites onto pages. The sprites must be sorted by descending height.
+static uint32_t pack( std::vector<InputSprite*>& sprites, int maxSize, int padding, std::vector<glm::ivec2>& pageSizes )
+{
+    struct Shelf
+    {
+        int y, height, x;
+    };
+
+    std::vector<Shelf> shelves;
+    int                shelvesHeight = 0;
+
+    pageSizes.emplace_back( 0 );
+
+    for ( InputSprite* sprite: sprites )
+    {
+        const int w = sprite->rect.width + padding;
+        const int h = sprite->rect.height + padding;
+
+        auto shelf = std::ranges::find_if( shelves, [&]( const Shelf& s ) { return s.height >= h && s.x + w <= maxSize; } );
+
+        if ( shelf == shelves.end() )
+        {
+            if ( shelvesHeight + h > maxSize )
+            {
+                // Start a new page.
+                shelves.clear();
+                shelvesHeight = 0;
+                pageSizes.emplace_back( 0 );
+            }
+
+            shelves.push_back( { shelvesHeight, h, 0 } );
+            shelvesHeight += h;
+            shelf = shelves.end() - 1;
+        }
+
+        sprite->page = static_cast<uint32_t>( pageSizes.size() - 1 );
+        sprite->x    = shelf->x;
+        sprite->y    = shelf->y;
+        shelf->x += w;
+
+        glm::ivec2& pageSize = pageSizes.back();
+        pageSize.x           = std::max( pageSize.x, sprite->x + sprite->rect.width );
+        pageSize.y           = std::max( pageSize.y, sprite->y + sprite->rect.height );
+    }
+
+    return static_cast<uint32_t>( pageSizes.size() );
+}
+
+int main( int argc, char* argv[] )
+{
+    fs::path    inputDirectory;
+    fs::path    outputDirectory = ".";
+    std::string name;
+    int         maxSize = 2048;
+    int         padding = 1;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+            maxSize = std::atoi( argv[++i] );
+        else if ( strcmp( argv[i], "-p" ) == 0 && i + 1 < argc )
+            padding = std::atoi( argv[++i] );
+        else if ( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+            outputDirectory = argv[++i];
+        else if ( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+            name = argv[++i];
+        else
+            inputDirectory = argv[i];
+    }
+
+    if ( inputDirectory.empty() || !fs::is_directory( inputDirectory ) || maxSize <= 0 || padding < 0 )
+    {
+        std::cerr << "Usage: " << argv[0] << " [-s <max page size>] [-p <padding>] [-o <output directory>] [-n <name>] <input directory>" << std::endl;
+        return 1;
+    }
+
+    if ( name.empty() )
+    {
+        fs::path directory = fs::absolute( inputDirectory ).lexically_normal();
+        if ( !directory.has_filename() )
+            directory = directory.parent_path();
+
+        name = directory.filename().string();
+    }
+
+    // Sort the files, so the output doesn't depend on the order of the directory iterator.
+    std::vector<fs::path> files;
+    for ( const auto& entry: fs::recursive_directory_iterator( inputDirectory ) )
+    {
+        if ( entry.is_regular_file() && isImageFile( entry.path() ) )
+            files.push_back( entry.path() );
+    }
+    std::ranges::sort( files );
+
+    std::vector<InputSprite>                inputSprites;
+    std::vector<SpriteSheetFile::Animation> animations;
+
+    for ( const fs::path& file: files )
+    {
+        auto image = std::make_shared<Image>( file );
+        if ( !*image )
+            return 1;
+
+        fs::path relativePath = fs::relative( file, inputDirectory );
+        relativePath.replace_extension();
+        const std::string spriteName = relativePath.generic_string();
+
+        const int imageWidth  = static_cast<int>( image->getWidth() );
+        const int imageHeight = static_cast<int>( image->getHeight() );
+
+        int frameWidth, frameHeight;
+        if ( parseFrameSize( spriteName, frameWidth, frameHeight ) && frameWidth <= imageWidth && frameHeight <= imageHeight )
+        {
+            SpriteSheetFile::Animation& animation = animations.emplace_back();
+            animation.name                        = spriteName;
+
+            for ( int y = 0; y + frameHeight <= imageHeight; y += frameHeight )
+            {
+                for ( int x = 0; x + frameWidth <= imageWidth; x += frameWidth )
+                {
+                    const Math::RectI frame { x, y, frameWidth, frameHeight };
+                    const Math::RectI rect = trim( *image, frame );
+
+                    animation.frames.push_back( static_cast<int>( inputSprites.size() ) );
+                    inputSprites.push_back( { spriteName + "/" + std::to_string( animation.frames.size() - 1 ), image, rect, { rect.left - x, rect.top - y }, { frameWidth, frameHeight } } );
+                }
+            }
+        }
+        else
+        {
+            const Math::RectI rect = trim( *image, { 0, 0, imageWidth, imageHeight } );
+            inputSprites.push_back( { spriteName, image, rect, { rect.left, rect.top }, { imageWidth, imageHeight } } );
+        }
+    }
+
+    std::vector<InputSprite*> sorted;
+    for ( InputSprite& sprite: inputSprites )
+    {
+        if ( sprite.rect.width > maxSize || sprite.rect.height > maxSize )
+        {
+            std::cerr << "ERROR: Sprite is larger than the maximum page size: " << sprite.name << std::endl;
+            return 1;
+        }
+
+        sorted.push_back( &sprite );
+    }
+
+    // Tall sprites first, so the shelves are filled with sprites of similar heights.
+    std::ranges::stable_sort( sorted, []( const InputSprite* a, const InputSprite* b ) { return a->rect.height > b->rect.height; } );
+
+    std::vector<glm::ivec2> pageSizes;
+    const uint32_t          numPages = inputSprites.empty() ? 0u : pack( sorted, maxSize, padding, pageSizes );
+
+    fs::create_directories( outputDirectory );
+
+    SpriteSheetFile::Index index;
+
+    for ( uint32_t p = 0; p < numPages; ++p )
+    {
+        Image page { static_cast<uint32_t>( pageSizes[p].x ), static_cast<uint32_t>( pageSizes[p].y ) };
+        page.clear( Color { 0, 0, 0, 0 } );
+
+        for ( const InputSprite& sprite: inputSprites )
+        {
+            if ( sprite.page != p )
+                continue;
+
+            for ( int y = 0; y < sprite.rect.height; ++y )
+            {
+                for ( int x = 0; x < sprite.rect.width; ++x )
+                    page( sprite.x + x, sprite.y + y ) = ( *sprite.image )( sprite.rect.left + x, sprite.rect.top + y );
+            }
+        }
+
+        fs::path pageFile = name + "_" + std::to_string( p ) + TextureFile::Extension;
+        if ( !TextureFile::write( outputDirectory / pageFile, page ) )
+            return 1;
+
+        index.pages.push_back( pageFile );
+    }
+
+    for ( const InputSprite& sprite: inputSprites )
+    {
+        index.sprites.push_back( {
+            sprite.name,
+            sprite.page,
+            { sprite.x, sprite.y, sprite.rect.width, sprite.rect.height },
+            sprite.offset,
+            sprite.sourceSize,
+            glm::vec2 { sprite.sourceSize } * 0.5f,
+        } );
+    }
+
+    index.animations = std::move( animations );
+
+    const fs::path indexFile = outputDirectory / ( name + SpriteSheetFile::Extension );
+    if ( !SpriteSheetFile::write( indexFile, index ) )
+        return 1;
+
+    std::cout << inputDirectory.string() << " -> " << indexFile.string() << " (" << index.sprites.size() << " sprites, " << index.animations.size() << " animations, " << numPages << " pages)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Converts images (PNG, JPEG, BMP, TGA) to texture files (.srtex) that are memory-mapped at load time.
+//
+// Usage: TextureConverter [-f] [-o <output directory>] <file or directory>...
+//
+//   -f    Convert all images, even if the texture file is newer than the image.
+//   -o    Write the texture files to the output directory (mirroring the layout of the input directories).
+//         By default, the texture files are written next to the images.
+#include <Graphics/Image.hpp>
+#include <Graphics/TextureFile.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Graphics;
+
+static bool isImageFile( const fs::path& file )
+{
+    std::string extension = file.extension().string();
+    std::ranges::transform( extension, extension.begin(), []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+}
+
+// Convert a single image. Returns false if the image could not be converted.
+static bool convert( const fs::path& input, const fs::path& output, bool force )
+{
+    if ( !force && fs::exists( output ) && fs::last_write_time( output ) >= fs::last_write_time( input ) )
+        return true;
+
+    const Image image { input };
+    if ( !image )
+        return false;
+
+    fs::create_directories( output.parent_path() );
+
+    if ( !TextureFile::write( output, image ) )
+        return false;
+
+    std::cout << input.string() << " -> " << output.string() << " (" << fs::file_size( input ) << " -> " << fs::file_size( output ) << " bytes)" << std::endl;
+
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+    std::vector<fs::path> inputs;
+    fs::path              outputDirectory;
+    bool                  force = false;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[i], "-f" ) == 0 )
+        {
+            force = true;
+        }
+        else if ( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+        {
+            outputDirectory = argv[++i];
+        }
+        else
+        {
+            inputs.emplace_back( argv[i] );
+        }
+    }
+
+    if ( inputs.empty() )
+    {
+        std::cerr << "Usage: " << argv[0] << " [-f] [-o <output directory>] <file or directory>..." << std::endl;
+        return 1;
+    }
+
+    int numFailed = 0;
+
+    for ( const fs::path& input: inputs )
+    {
+        // The texture file replaces the extension of the image.
+        auto outputPath = [&]( const fs::path& file, const fs::path& relativePath ) {
+            fs::path output = outputDirectory.empty() ? file : outputDirectory / relativePath;
+            return output.replace_extension( TextureFile::Extension );
+        };
+
+        if ( fs::is_directory( input ) )
+        {
+            for ( const auto& entry: fs::recursive_directory_iterator( input ) )
+            {
+                if ( entry.is_regular_file() && isImageFile( entry.path() ) && !convert( entry.path(), outputPath( entry.path(), fs::relative( entry.path(), input ) ), force ) )
+                    ++numFailed;
+            }
+        }
+        else if ( !convert( input, outputPath( input, input.filename() ), force ) )
+        {
+            ++numFailed;
+        }
+    }
+
+    return numFailed == 0 ? 0 : 1;
+}